@@ -99,12 +99,12 @@ public:
   /**
    * @return detector for given alert level
    */
-  Detection3D* detectorRef(int alert_level) const;
+  const Detection3D* detectorRef(int alert_level) const;
 
   /**
    * @return detector for conflict alert level
    */
-  Detection3D* conflictDetectorRef() const;
+  const Detection3D* conflictDetectorRef() const;
 
   /**
    * Set conflict alert level
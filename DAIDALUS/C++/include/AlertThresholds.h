@@ -17,13 +17,18 @@
 #include "ParameterData.h"
 #include "ParameterTable.h"
 #include <map>
+#include <atomic>
 
 namespace larcfm {
 
 class AlertThresholds : public ParameterTable {
 
 private:
-  Detection3D* detector_; // State-based detector
+  // Keys of units_
+  enum { ALERTING_TIME, EARLY_ALERTING_TIME, SPREAD_TRK, SPREAD_GS, SPREAD_VS, SPREAD_ALT, UNITS };
+
+  const Detection3D* detector_; // State-based detector. It's shared by copies of this object and never modified.
+  std::atomic<int>* detector_refs_; // Number of objects sharing detector_
   double  alerting_time_; // Alerting_time
   // If alerting_time > 0, alert is based on detection
   // If alerting_time = 0, alert is based on violation
@@ -33,7 +38,11 @@ private:
   double spread_gs_;  // Alert when ground speed band within spread (non-negative value)
   double spread_vs_;  // Alert when vertical speed band within speed (non-negative value)
   double spread_alt_; // Alert when altitude  band within spread (non-negative value)
-  std::map<std::string,std::string> units_;
+  std::string units_[UNITS];
+
+  void set_detector(const AlertThresholds& athr);
+  void set_detector(const Detection3D* det);
+  void release_detector();
 
 public:
 
@@ -61,12 +70,13 @@ public:
   AlertThresholds& operator=(const AlertThresholds& athr);
 
   /**
-   * Return detector.
+   * Return detector. The detector is shared by the copies of this object, so it can't be
+   * modified. Use setDetector instead.
    */
-  Detection3D* getDetectorRef() const;
+  const Detection3D* getDetectorRef() const;
 
   /**
-   * Set detector.
+   * Set detector to a copy of det.
    */
   void setDetector(const Detection3D* det);
 
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef BANDSDEADLINE_H_
+#define BANDSDEADLINE_H_
+
+namespace larcfm {
+
+/**
+ * Point in time, measured with a monotonic clock, before which a bands computation
+ * should be completed. A deadline built with the default constructor never expires.
+ */
+class BandsDeadline {
+
+public:
+
+  /** Deadline that never expires */
+  BandsDeadline();
+
+  /** Deadline that expires budget seconds from now. A non-positive budget is already expired. */
+  explicit BandsDeadline(double budget);
+
+  /** Return true if the deadline has passed */
+  bool expired() const;
+
+  /** Return time, in seconds, until the deadline, 0 if it has passed, or positive infinity if it never expires */
+  double remaining() const;
+
+private:
+
+  bool never_;
+  long long end_; // Deadline in nanoseconds of the monotonic clock
+
+  static long long now_ns();
+
+};
+
+}
+
+#endif
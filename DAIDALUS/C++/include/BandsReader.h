@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef BANDSREADER_H_
+#define BANDSREADER_H_
+
+#include "BandsRecords.h"
+#include "TrafficState.h"
+#include "Interval.h"
+#include "BandsRegion.h"
+#include "ErrorReporter.h"
+#include "ErrorLog.h"
+#include <string>
+#include <vector>
+#include <cstdio>
+
+namespace larcfm {
+
+/**
+ * Reader of files written by BandsWriter. Records are read one at a time with next. Accessors refer
+ * to the last record that has been read.
+ */
+class BandsReader : public ErrorReporter {
+
+public:
+
+  BandsReader();
+
+  ~BandsReader();
+
+  /** Open file filename, or standard input if filename is "-". Return false on error. */
+  bool open(const std::string& filename);
+
+  void close();
+
+  /** Header of the file */
+  const BandsFileHeader& header() const;
+
+  /** Units of the bands of dimension dim in the configuration of the writer */
+  std::string units(BandsDimension dim) const;
+
+  /**
+   * Read the next record. Return its kind, i.e., BandsRecordHeader::TEXT, INPUT_FILE, or STEP, or 0
+   * at the end of the file or on error.
+   */
+  int next();
+
+  /** Text of a TEXT record or name of an INPUT_FILE record */
+  const std::string& text() const;
+
+  /** Step of a STEP record */
+  const BandsStepRecord& step() const;
+
+  /** Number of traffic aircraft of a STEP record */
+  int trafficSize() const;
+
+  /** Aircraft record of a STEP record. Index 0 is the ownship. */
+  const BandsAircraftRecord& aircraft(int ac) const;
+
+  /** State of aircraft ac of a STEP record. Index 0 is the ownship. */
+  TrafficState aircraftState(int ac) const;
+
+  /** Identifier of aircraft ac of a STEP record. Index 0 is the ownship. */
+  std::string aircraftId(int ac) const;
+
+  /** Number of bands of dimension dim of a STEP record */
+  int length(BandsDimension dim) const;
+
+  /** Interval i, in internal units, of the bands of dimension dim of a STEP record */
+  Interval interval(BandsDimension dim, int i) const;
+
+  /** Region of interval i of the bands of dimension dim of a STEP record */
+  BandsRegion::Region region(BandsDimension dim, int i) const;
+
+  bool hasError() const {
+    return error.hasError();
+  }
+
+  bool hasMessage() const {
+    return error.hasMessage();
+  }
+
+  std::string getMessage() {
+    return error.getMessage();
+  }
+
+  std::string getMessageNoClear() const {
+    return error.getMessageNoClear();
+  }
+
+private:
+
+  FILE* file_;
+  BandsFileHeader header_;
+  std::vector<char> payload_;
+  std::string text_;
+  int offset_[BANDS_DIMENSIONS]; // Index of the first BandsRangeRecord of each dimension
+  mutable ErrorLog error;
+
+  const BandsRangeRecord& range(BandsDimension dim, int i) const;
+
+  BandsReader(const BandsReader&);
+  BandsReader& operator=(const BandsReader&);
+
+};
+
+}
+
+#endif
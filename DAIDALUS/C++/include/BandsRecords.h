@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef BANDSRECORDS_H_
+#define BANDSRECORDS_H_
+
+#include <stdint.h>
+
+namespace larcfm {
+
+/*
+ * Fixed-layout records of a binary bands file, see BandsWriter and BandsReader. All values are in
+ * internal units and numbers are in the byte order of the host that wrote the file.
+ *
+ * A file is a BandsFileHeader followed by a sequence of records. Every record starts with a
+ * BandsRecordHeader. The payload of a TEXT or INPUT_FILE record is a string. The payload of a STEP record,
+ * i.e., the results of one time step, is a BandsStepRecord, the BandsAircraftRecord of the ownship,
+ * the BandsAircraftRecord of each traffic aircraft, and the BandsRangeRecord of each dimension, in the
+ * order track, ground speed, vertical speed, and altitude.
+ */
+
+static const int BANDS_ID_SIZE = 32;     // Identifiers are NUL terminated and truncated to BANDS_ID_SIZE-1 characters
+static const int BANDS_UNITS_SIZE = 16;
+static const int BANDS_MAX_LEVELS = 32;  // Alert levels are stored in bit masks
+static const uint32_t BANDS_FILE_MAGIC = 0x42414144; // "DAAB"
+static const uint32_t BANDS_FILE_VERSION = 1;
+
+enum BandsDimension { BANDS_TRK, BANDS_GS, BANDS_VS, BANDS_ALT, BANDS_DIMENSIONS };
+
+struct BandsFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  char units[BANDS_DIMENSIONS][BANDS_UNITS_SIZE]; // Units of the bands of each dimension in the configuration
+  int32_t most_severe_alert_level;
+  uint32_t reserved;
+  double min[BANDS_DIMENSIONS];                    // Minimum of each dimension. Unused for track
+  double max[BANDS_DIMENSIONS];                    // Maximum of each dimension. Unused for track
+};
+
+struct BandsRecordHeader {
+  enum Kind { TEXT = 1, INPUT_FILE = 2, STEP = 3 };
+  uint32_t kind;
+  uint32_t size;  // Size of the payload in bytes
+};
+
+struct BandsDimensionRecord {
+  double ownship;           // Current value of the ownship
+  double resolution_up;     // Resolution up or right
+  double resolution_down;   // Resolution down or left
+  double recovery_time;     // Time to recovery [s]
+  int32_t region;           // BandsRegion::Region of the current value
+  uint32_t preferred_up;    // 1 if the preferred direction is up or right
+  uint32_t ranges;          // Number of BandsRangeRecord
+  uint32_t reserved;
+};
+
+struct BandsStepRecord {
+  static const uint32_t CONFLICT_CRITERIA = 1;
+  static const uint32_t RECOVERY_CRITERIA = 2;
+
+  double time;              // [s]
+  uint32_t flags;
+  uint32_t traffic;         // Number of traffic aircraft
+  int32_t epsilon_h;
+  int32_t epsilon_v;
+  char most_urgent[BANDS_ID_SIZE];
+  BandsDimensionRecord dims[BANDS_DIMENSIONS];
+};
+
+struct BandsAircraftRecord {
+  static const uint32_t LATLON = 1;    // Position is latitude [rad], longitude [rad], altitude [m]
+  static const uint32_t CONFLICT = 2;  // Detection of the conflict alert level reports a conflict
+
+  char id[BANDS_ID_SIZE];
+  uint32_t flags;
+  int32_t alert;                      // Alert level. Unused for the ownship
+  double time;                        // [s]
+  double x;                           // Latitude [rad] or sx [m]
+  double y;                           // Longitude [rad] or sy [m]
+  double z;                           // Altitude [m]
+  double vx;                          // Ground velocity [m/s]
+  double vy;
+  double vz;
+  double time_in;                     // Time interval of violation of the conflict alert level [s]
+  double time_out;
+  double last_time[BANDS_DIMENSIONS]; // Last time to maneuver in each dimension [s]
+  uint32_t conflict_levels;           // Bit l-1 is set if the aircraft is a conflict aircraft of level l
+  uint32_t peripheral_levels[BANDS_DIMENSIONS]; // Same, for peripheral aircraft of each dimension
+  uint32_t reserved;
+};
+
+struct BandsRangeRecord {
+  double low;
+  double up;
+  int32_t region;           // BandsRegion::Region
+  uint32_t reserved;
+};
+
+}
+
+#endif
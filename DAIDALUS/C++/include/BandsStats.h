@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef BANDSSTATS_H_
+#define BANDSSTATS_H_
+
+#include <string>
+
+namespace larcfm {
+
+/**
+ * Counters and phase times of the bands computation. Counters are only updated when
+ * the library is compiled with DAIDALUS_STATS_ defined, e.g., make CXXFLAGS="-Iinclude -O -DDAIDALUS_STATS_".
+ * Otherwise, they remain 0 and the instrumentation has no cost.
+ * Times are measured with a monotonic clock, in seconds. Phase times are inclusive, e.g.,
+ * compute_level_time includes recovery_time.
+ */
+struct BandsStats {
+
+  /* Number of calls to detector functions in the bands algorithms */
+  unsigned long detector_calls;
+  /* Number of ownship trajectory samples */
+  unsigned long trajectory_samples;
+  /* Number of calls to none_bands */
+  unsigned long none_bands_calls;
+
+  /* Time spent computing conflict aircraft (KinematicBandsCore::update) */
+  double core_update_time;
+  /* Time spent computing peripheral aircraft */
+  double peripheral_time;
+  /* Time spent computing bands per alert level */
+  double compute_level_time;
+  /* Time spent computing recovery bands */
+  double recovery_time;
+  /* Time spent computing resolutions */
+  double resolution_time;
+
+  BandsStats();
+
+  /** Return true if the library was compiled with instrumentation */
+  static bool isEnabled();
+
+  /** Set all counters and times to 0 */
+  void clear();
+
+  /** Add counters and times of stats to this object */
+  void add(const BandsStats& stats);
+
+  std::string toString() const;
+
+};
+
+/**
+ * Adds the time elapsed between its construction and destruction to a phase time.
+ * If time is NULL, it doesn't do anything.
+ */
+class BandsStopwatch {
+
+public:
+
+  explicit BandsStopwatch(double* time);
+
+  ~BandsStopwatch();
+
+private:
+
+  double* time_;
+  long long start_;
+
+  BandsStopwatch(const BandsStopwatch&);
+  BandsStopwatch& operator=(const BandsStopwatch&);
+
+};
+
+}
+
+#ifdef DAIDALUS_STATS_
+#define BANDS_STATS_COUNT(stats,field,n) do { if ((stats) != NULL) (stats)->field += (n); } while (0)
+#define BANDS_STATS_TIMER(stats,field) larcfm::BandsStopwatch bands_stopwatch_((stats) != NULL ? &(stats)->field : NULL)
+#else
+#define BANDS_STATS_COUNT(stats,field,n) do { } while (0)
+#define BANDS_STATS_TIMER(stats,field) do { } while (0)
+#endif
+
+#endif
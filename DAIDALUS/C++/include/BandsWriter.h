@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef BANDSWRITER_H_
+#define BANDSWRITER_H_
+
+#include "BandsRecords.h"
+#include "Daidalus.h"
+#include "KinematicMultiBands.h"
+#include "ErrorReporter.h"
+#include "ErrorLog.h"
+#include <string>
+#include <vector>
+#include <cstdio>
+
+namespace larcfm {
+
+/**
+ * Writer of alerting and bands results in the binary format of BandsRecords.h. The results of a time
+ * step are laid out in place, with a single append, in a buffer that is written to the file when it is
+ * full. Nothing is formatted as text: BandsReader, e.g., in DaidalusBandsConverter, turns the file back
+ * into the text formats of DaidalusBatch and drawmultibands.py.
+ */
+class BandsWriter : public ErrorReporter {
+
+public:
+
+  /** Size, in bytes, of the buffer of the writer */
+  static const int BUFFER_SIZE = 1 << 20;
+
+  BandsWriter();
+
+  ~BandsWriter();
+
+  /**
+   * Create file filename, or write to standard output if filename is "-", with the units and limits of
+   * parameters. Return false on error.
+   */
+  bool open(const std::string& filename, const KinematicBandsParameters& parameters);
+
+  bool isOpen() const;
+
+  /** Write a text record, e.g., the header of DaidalusBatch */
+  void writeText(const std::string& text);
+
+  /** Write a record marking the beginning of the results of input file filename */
+  void writeFile(const std::string& filename);
+
+  /** Write the alerting and bands of daa at its current time. kb are the bands of daa. */
+  void write(Daidalus& daa, KinematicMultiBands& kb);
+
+  /** Write buffered records to the file. Return false on error. */
+  bool flush();
+
+  /** Flush and close the file */
+  void close();
+
+  bool hasError() const {
+    return error.hasError();
+  }
+
+  bool hasMessage() const {
+    return error.hasMessage();
+  }
+
+  std::string getMessage() {
+    return error.getMessage();
+  }
+
+  std::string getMessageNoClear() const {
+    return error.getMessageNoClear();
+  }
+
+private:
+
+  FILE* file_;
+  std::vector<char> buffer_;
+  int size_; // Bytes of buffer_ in use
+  int most_severe_alert_level_;
+  std::vector<int> alerts_;
+  std::vector<ConflictData> detections_;
+  std::vector<double> times_to_violation_;
+  mutable ErrorLog error;
+
+  char* append(BandsRecordHeader::Kind kind, int size);
+  void writeString(BandsRecordHeader::Kind kind, const std::string& s);
+  static void setAircraft(BandsAircraftRecord& rec, const TrafficState& ac);
+
+  BandsWriter(const BandsWriter&);
+  BandsWriter& operator=(const BandsWriter&);
+
+};
+
+}
+
+#endif
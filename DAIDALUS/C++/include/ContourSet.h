@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef CONTOURSET_H_
+#define CONTOURSET_H_
+
+#include "Position.h"
+#include <vector>
+#include <string>
+
+namespace larcfm {
+
+/**
+ * List of horizontal contours, i.e., polygons, stored in a flat buffer of points. Each
+ * polygon records the aircraft index and alert level it was computed for. Clearing the set
+ * keeps the allocated memory, so that a set reused from one cycle to the next doesn't allocate
+ * once it has grown to its working size.
+ */
+class ContourSet {
+
+public:
+
+  ContourSet();
+
+  /** Remove all polygons, keeping allocated memory */
+  void clear();
+
+  /** Number of polygons */
+  int size() const;
+
+  /** Total number of points of all polygons */
+  int numberOfPoints() const;
+
+  /** Aircraft index of k-th polygon */
+  int aircraftIndex(int k) const;
+
+  /** Alert level of k-th polygon */
+  int alertLevel(int k) const;
+
+  /** Number of points of k-th polygon */
+  int polygonSize(int k) const;
+
+  /** j-th point of k-th polygon */
+  Position const & point(int k, int j) const;
+
+  /** Set poly to the points of k-th polygon */
+  void polygon(int k, std::vector<Position>& poly) const;
+
+  /** Set blobs to the list of polygons in the set */
+  void toBlobs(std::vector< std::vector<Position> >& blobs) const;
+
+  /**
+   * Start a new polygon for aircraft index ac_idx and alert level.
+   * Requires: previous polygon, if any, is finished
+   */
+  void beginPolygon(int ac_idx, int alert_level);
+
+  /** Add point to current polygon */
+  void addPoint(const Position& p);
+
+  /** Finish current polygon. Empty polygons are discarded */
+  void endPolygon();
+
+  /** Append all polygons of contours to this set */
+  void append(const ContourSet& contours);
+
+  std::string toString() const;
+
+private:
+
+  std::vector<Position> points_;
+  std::vector<int> start_; // Index in points_ of the first point of each polygon, plus a last entry for the end
+  std::vector<int> ac_idx_; // Aircraft index of each polygon
+  std::vector<int> alert_level_; // Alert level of each polygon
+
+};
+
+}
+
+#endif
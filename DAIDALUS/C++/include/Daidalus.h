@@ -17,7 +17,8 @@
 #include "WCVTable.h"
 #include "WCV_TAUMOD.h"
 #include "KinematicBandsParameters.h"
-#include <deque>
+#include "ContourSet.h"
+#include <unordered_map>
 
 namespace larcfm {
 
@@ -25,16 +26,36 @@ class Daidalus : public ErrorReporter {
 
 private:
 
+  friend class DaidalusCheckpoint;
+
   TrafficState ownship_; // Ownship aircraft. Velocity vector is wind-based.
   std::vector<TrafficState> traffic_; // Traffic aircraft states. Positions are synchronized in time with ownship. Velocity vector is wind-based.
+  typedef std::unordered_map<std::string,int> TrafficIndex;
+  TrafficIndex traffic_index_; // Position in traffic_ of first aircraft with a given identifier
   double current_time_; // Current time
   Velocity wind_vector_; // Wind information
   UrgencyStrategy* urgency_strat_; // Strategy for most urgent aircraft
 
-  static void add_blob(std::vector< std::vector<Position> >& blobs,
-      std::deque<Position>& vin, std::deque<Position>& vout);
+  std::vector<ContourSet> contour_parts_; // Contours of each (alert level, aircraft) pair
+
+  /**
+   * Put in contours the horizontal contours contributed by all traffic aircraft for the given
+   * alert levels.
+   */
+  void horizontal_contours(ContourSet& contours, const std::vector<int>& levels);
+
+  /**
+   * Rebuild traffic_index_ from traffic_
+   */
+  void index_traffic();
+
+  /**
+   * Return intruder state, at current time, of traffic aircraft with given ground velocity at given time.
+   */
+  TrafficState make_intruder(const std::string& id, const Position& pos, const Velocity& vel, double time) const;
 
   KinematicMultiBands kb_; // For internal computations of alerts
+  std::vector<KinematicMultiBands> chunk_kbs_; // For alerts of chunks of traffic aircraft other than the first one, see alertingAll
 
   /**
    * @return alerting time. If set to 0, returns lookahead time instead.
@@ -154,6 +175,29 @@ public:
    */
   int addTrafficState(const TrafficState& ac);
 
+  /**
+   * Set ownship state and current time, keeping traffic aircraft. Velocity vector is ground velocity.
+   * Traffic aircraft are linearly projected to the new current time. A traffic aircraft with the same
+   * identifier as the ownship is removed, see removeTrafficState. If the ownship hasn't been set,
+   * this method is the same as setOwnshipState.
+   */
+  void updateOwnshipState(const std::string& id, const Position& pos, const Velocity& vel, double time);
+
+  /**
+   * Update state of traffic aircraft with given identifier, or add it if there is no such aircraft.
+   * Velocity vector is ground velocity. If time is different from current time, traffic state is
+   * projected into current time. Only the updated aircraft is projected. If the ownship hasn't been set,
+   * this aircraft is set as the ownship. Return aircraft index, or -1 if the state is invalid or id is
+   * the identifier of the ownship.
+   */
+  int updateTrafficState(const std::string& id, const Position& pos, const Velocity& vel, double time);
+
+  /**
+   * Remove traffic aircraft with given identifier. The last traffic aircraft takes the index of the
+   * removed one. Return false if there is no such traffic aircraft.
+   */
+  bool removeTrafficState(const std::string& id);
+
   /**
    * Exchange ownship aircraft with aircraft at index ac_idx.
    */
@@ -165,7 +209,8 @@ public:
   void resetOwnship(const std::string& id);
 
   /** 
-   * Get index of aircraft with given name. Return -1 if no such index exists
+   * Get index of aircraft with given name. Return -1 if no such index exists.
+   * If several traffic aircraft have the same name, the first index is returned.
    */
   int aircraftIndex(const std::string& name) const;
 
@@ -202,6 +247,27 @@ public:
    */
   int alerting(int ac_idx);
 
+  /**
+   * Computes alerting type of ownship and all traffic aircraft for current aircraft states,
+   * i.e., alerts[ac_idx-1] is alerting(ac_idx,turning,accelerating,climbing). The bands
+   * objects of the alerting logic are set up once for all aircraft, and aircraft are split
+   * across threads when there are many of them, see ParallelLoop.
+   */
+  void alertingAll(std::vector<int>& alerts, int turning, int accelerating, int climbing);
+
+  /**
+   * Computes alerting type of ownship and all traffic aircraft for current aircraft states,
+   * i.e., alerts[ac_idx-1] is alerting(ac_idx).
+   */
+  void alertingAll(std::vector<int>& alerts);
+
+  /**
+   * Same as alertingAll(alerts,turning,accelerating,climbing). In addition, detections[ac_idx-1]
+   * is detection(ac_idx) and times_to_violation[ac_idx-1] is timeToViolation(ac_idx).
+   */
+  void alertingAll(std::vector<int>& alerts, std::vector<ConflictData>& detections,
+      std::vector<double>& times_to_violation, int turning, int accelerating, int climbing);
+
   /**
    * Detects conflict with aircraft at index ac_idx for given alert level.
    * Conflict data provides time to violation and time to end of violation
@@ -239,6 +305,18 @@ public:
    */
   void kinematicMultiBands(KinematicMultiBands& bands) const;
 
+  /**
+   * Return instrumentation counters and phase times of the alerting logic. Counters of
+   * bands computations are returned by KinematicMultiBands::getStats. Counters are only
+   * updated when the library is compiled with DAIDALUS_STATS_, see BandsStats.
+   */
+  BandsStats const & getAlertingStats() const;
+
+  /**
+   * Set instrumentation counters and phase times of the alerting logic to 0.
+   */
+  void clearAlertingStats();
+
   /**
    * @return reference to strategy for computing most urgent aircraft.
    */
@@ -277,6 +355,22 @@ public:
    */
   void horizontalContours(std::vector< std::vector<Position> >& blobs, int ac_idx);
 
+  /**
+   * Computes horizontal contours contributed by all traffic aircraft, for given alert level.
+   * If alert_level is 0, conflict alert level is used. Contours are ordered by aircraft index and
+   * each one records its aircraft index and alert level. Aircraft are processed concurrently
+   * when the library is compiled with DAIDALUS_THREADS_, see ParallelLoop.
+   * @param contours set of contours returned by reference.
+   */
+  void horizontalContours(ContourSet& contours, int alert_level);
+
+  /**
+   * Computes horizontal contours contributed by all traffic aircraft, for all alert levels.
+   * Contours are ordered by alert level and then by aircraft index.
+   * @param contours set of contours returned by reference.
+   */
+  void horizontalContours(ContourSet& contours);
+
   std::string aircraftListToPVS(int prec) const;
 
   std::string outputStringAircraftStates() const;
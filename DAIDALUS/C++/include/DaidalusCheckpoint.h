@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef DAIDALUSCHECKPOINT_H_
+#define DAIDALUSCHECKPOINT_H_
+
+#include "Daidalus.h"
+#include "KinematicMultiBands.h"
+#include "KinematicBandsParameters.h"
+#include "ErrorReporter.h"
+#include "ErrorLog.h"
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace larcfm {
+
+/**
+ * Binary snapshot of the state of a Daidalus object: parameters, ownship, traffic, wind, current time,
+ * and urgency strategy. A snapshot may also hold the state of a KinematicMultiBands object, including
+ * the bands, resolutions, peripheral aircraft, and recovery times it has cached. Restoring a snapshot
+ * doesn't recompute anything, e.g., a standby node that takes over from another one answers with the
+ * bands that were already computed. Snapshots are also useful to replay a computation when debugging.
+ *
+ * A snapshot starts with a CheckpointHeader, followed by the parameters of the Daidalus object, its
+ * state and, if the HAS_BANDS flag is set, the parameters and state of the bands. All values are in
+ * internal units and numbers are in the byte order of the host that took the snapshot. Parameters are
+ * stored as the entries of their ParameterData, so that they are restored exactly. Snapshots of other
+ * versions are rejected.
+ *
+ * Parsing parameters is the only costly part of a restore. The parameters of the last restored snapshot
+ * are kept, and they are reused by the next restore if its parameters are the same bytes, which is the
+ * case of the snapshots of a stream that is replayed or taken over.
+ */
+class DaidalusCheckpoint : public ErrorReporter {
+
+public:
+
+  struct CheckpointHeader {
+    static const uint32_t HAS_BANDS = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t size;    // Size of the snapshot in bytes, including this header
+  };
+
+  static const uint32_t MAGIC = 0x43414144; // "DAAC"
+  static const uint32_t VERSION = 1;
+
+  DaidalusCheckpoint();
+
+  /** Replace the snapshot by the state of daa */
+  void save(const Daidalus& daa);
+
+  /** Replace the snapshot by the state of daa and the state, including cached values, of kb */
+  void save(const Daidalus& daa, const KinematicMultiBands& kb);
+
+  /** Set daa to the state of the snapshot. Return false on error, in which case daa isn't modified. */
+  bool restore(Daidalus& daa);
+
+  /**
+   * Set daa and kb to the state of the snapshot. Return false if the snapshot doesn't hold bands or
+   * on error, in which case daa isn't modified and kb is cleared.
+   */
+  bool restore(Daidalus& daa, KinematicMultiBands& kb);
+
+  /** Return true if the snapshot holds the state of a KinematicMultiBands object */
+  bool hasBands() const;
+
+  /** Bytes of the snapshot */
+  const std::vector<char>& data() const;
+
+  /** Replace the snapshot by size bytes at data, e.g., received from another node */
+  void setData(const char* data, unsigned long size);
+
+  /** Write the snapshot to file filename. Return false on error. */
+  bool writeToFile(const std::string& filename) const;
+
+  /** Replace the snapshot by the contents of file filename. Return false on error. */
+  bool readFromFile(const std::string& filename);
+
+  bool hasError() const {
+    return error.hasError();
+  }
+
+  bool hasMessage() const {
+    return error.hasMessage();
+  }
+
+  std::string getMessage() {
+    return error.getMessage();
+  }
+
+  std::string getMessageNoClear() const {
+    return error.getMessageNoClear();
+  }
+
+private:
+
+  class Reader;
+  class Writer;
+  class State;
+
+  std::vector<char> data_;
+  std::vector<char> daa_parameters_data_; // Daidalus parameters section of the last restored snapshot
+  KinematicBandsParameters daa_parameters_; // Daidalus parameters of the last restored snapshot
+  std::vector<char> kb_parameters_data_;  // Bands parameters section of the last restored snapshot
+  KinematicBandsParameters kb_parameters_;  // Bands parameters of the last restored snapshot
+  mutable ErrorLog error;
+
+  void save_daidalus(Writer& out, const Daidalus& daa) const;
+  void save_bands(Writer& out, const KinematicMultiBands& kb) const;
+  void save_real_bands(Writer& out, const KinematicRealBands& band,
+      const std::vector<TrafficState>& traffic) const;
+
+  bool check_header();
+  bool restore_parameters(Reader& in, std::vector<char>& parameters_data,
+      KinematicBandsParameters& parameters);
+  bool read_daidalus(Reader& in, State& state);
+  void restore_daidalus(State& state, Daidalus& daa);
+  bool restore_bands(Reader& in, KinematicMultiBands& kb);
+  void restore_real_bands(Reader& in, KinematicRealBands& band,
+      const std::vector<TrafficState>& traffic) const;
+
+  DaidalusCheckpoint(const DaidalusCheckpoint&);
+  DaidalusCheckpoint& operator=(const DaidalusCheckpoint&);
+
+};
+
+}
+
+#endif
@@ -18,6 +18,7 @@ private:
 	double relative_;
 	std::string options_;
 	std::string ownship_;
+	double read_time_;
 
 public:
 	DaidalusProcessor(const std::string& own);
@@ -26,6 +27,7 @@ public:
 	double getFrom() const;
 	double getTo() const;
 	std::string getOwnship() const;
+	double getReadTime() const;
 	virtual ~DaidalusProcessor() { }
 	static void getFileNames(std::vector<std::string>& txtFiles, const std::vector<std::string>& names, const std::string& ext, int i);
 	static std::string getHelpString();
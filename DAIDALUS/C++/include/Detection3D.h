@@ -25,7 +25,27 @@
 namespace larcfm {
 
 class Detection3D : public ParameterAcceptor {
+
+  friend class DetectionKernel;
+
+  /**
+   * Concrete detector kind, set by DetectionKernel::bind when the detector is built. A
+   * negative value means not bound. The kind is never copied, since copies may have a
+   * different dynamic type.
+   */
+  int kernel_kind_;
+
 public:
+
+  Detection3D() : kernel_kind_(-1) {}
+
+  Detection3D(const Detection3D& det) : ParameterAcceptor(det), kernel_kind_(-1) {}
+
+  Detection3D& operator=(const Detection3D& det) {
+    (void)det;
+    return *this;
+  }
+
   virtual ~Detection3D() = 0;
 
   virtual bool violation(const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi) const = 0;
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef DETECTIONKERNEL_H_
+#define DETECTIONKERNEL_H_
+
+#include "Detection3D.h"
+#include "Vect3.h"
+#include "Velocity.h"
+
+namespace larcfm {
+
+/**
+ * DetectionKernel resolves the concrete type of a Detection3D object so that the
+ * inner loops of the bands algorithms can call the detector through a direct
+ * (non-virtual) call. The kind of a detector is computed once, when the detector is
+ * bound, and stored in the detector. Detectors that are not one of the predefined
+ * classes, including user-defined subclasses of the predefined classes, are
+ * resolved as GENERIC and go through the virtual interface.
+ */
+class DetectionKernel {
+
+public:
+
+  enum Kind { GENERIC, WCV_TAUMOD_KIND, WCV_TCPA_KIND, WCV_TEP_KIND,
+    CDCYLINDER_KIND, TCAS3D_KIND };
+
+  /**
+   * Return the kind of detector det. The kind of a bound detector is read from the
+   * detector, otherwise its dynamic type is inspected. The detector is never modified.
+   */
+  static Kind kind(const Detection3D* det) {
+    if (det->kernel_kind_ >= 0) {
+      return static_cast<Kind>(det->kernel_kind_);
+    }
+    return resolve(det);
+  }
+
+  /**
+   * Store the kind of det in det. It has to be called when det is built, before it is
+   * shared.
+   */
+  static void bind(Detection3D* det) {
+    det->kernel_kind_ = resolve(det);
+  }
+
+private:
+
+  static Kind resolve(const Detection3D* det);
+
+};
+
+/**
+ * Calls to the detection interface of a detector of concrete class D. The calls
+ * are qualified so that they are resolved at compile time.
+ */
+template <class D>
+struct DetectorCall {
+
+  static bool violation(const Detection3D* det,
+      const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi) {
+    return static_cast<const D*>(det)->D::violation(so,vo,si,vi);
+  }
+
+  static bool conflict(const Detection3D* det,
+      const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi, double B, double T) {
+    return static_cast<const D*>(det)->D::conflict(so,vo,si,vi,B,T);
+  }
+
+};
+
+/**
+ * Generic fallback: calls go through the virtual interface.
+ */
+template <>
+struct DetectorCall<Detection3D> {
+
+  static bool violation(const Detection3D* det,
+      const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi) {
+    return det->violation(so,vo,si,vi);
+  }
+
+  static bool conflict(const Detection3D* det,
+      const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi, double B, double T) {
+    return det->conflict(so,vo,si,vi,B,T);
+  }
+
+};
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef DETECTIONPREFILTER_H_
+#define DETECTIONPREFILTER_H_
+
+#include "Detection3D.h"
+
+namespace larcfm {
+
+/**
+ * Conservative single-precision screening of relative states before conflict detection.
+ *
+ * For the WCV_tvar detectors (WCV_TAUMOD, WCV_TCPA, WCV_TEP) every relative state
+ * s+t*v in a violation satisfies |s_xy+t*v_xy| <= DTHR+TTHR*|v_xy| and
+ * |s_z+t*v_z| <= ZTHR+TCOA*|v_z|. For CDCylinder the bounds are D and H.
+ * A relative state whose minimum distance over [b,e] exceeds these bounds cannot be in
+ * conflict in [b,e]. The bounds are inflated by a relative margin of 2^-12 of the
+ * magnitudes involved plus 1 [m], which dominates both the single-precision rounding
+ * error of the screen (a few units of 2^-24) and the numerical tolerances of the exact
+ * detectors. Screened out states are therefore guaranteed to be conflict free and
+ * remaining states must be checked with the exact (double precision) detector.
+ */
+class DetectionPrefilter {
+
+public:
+
+  /** Number of relative states screened per block */
+  static const int LANES = 16;
+
+  /**
+   * Build a prefilter for detector det. The prefilter is inactive, i.e., it doesn't
+   * screen out any state, when det is not one of the detectors listed above.
+   */
+  explicit DetectionPrefilter(const Detection3D* det);
+
+  bool isActive() const {
+    return active_;
+  }
+
+  /**
+   * Screen n <= LANES relative states (s,v) for the time interval [b,e].
+   * Sets clear[i] to 1 when the i-th state is guaranteed to be conflict free, 0 otherwise.
+   */
+  void screen(int n, const float* sx, const float* sy, const float* sz,
+      const float* vx, const float* vy, const float* vz,
+      float b, float e, unsigned char* clear) const;
+
+private:
+
+  bool  active_;
+  float D_;  // Horizontal distance threshold
+  float TD_; // Horizontal time threshold
+  float H_;  // Vertical distance threshold
+  float TH_; // Vertical time threshold
+
+};
+
+}
+
+#endif
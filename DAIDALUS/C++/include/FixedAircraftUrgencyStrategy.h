@@ -28,7 +28,7 @@ public:
   FixedAircraftUrgencyStrategy(const std::string& id);
   std::string getFixedAircraftId() const;
   void setFixedAircraftId(const std::string& id);
-  TrafficState mostUrgentAircraft(Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T);
+  TrafficState mostUrgentAircraft(const Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T);
   UrgencyStrategy* copy() const;
 };
 
@@ -43,36 +43,36 @@ public:
 
   double time_step(const TrafficState& ownship) const;
 
-  std::pair<Vect3, Velocity> trajectory(const TrafficState& ownship, double time, bool dir) const;
+  std::pair<Vect3, Velocity> trajectory(const TrafficState& ownship, double time, bool dir, int j) const;
 
-  void none_bands(IntervalSet& noneset, Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+  void none_bands(IntervalSet& noneset, const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
       int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic);
 
-  bool any_red(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+  bool any_red(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
       int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic);
 
-  bool all_red(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+  bool all_red(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
       int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic);
 
   // dir=false is down, dir=true is up. Return NaN if there is not a resolution
-  double resolution(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+  double resolution(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
       int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic, bool dir);
 
 private:
-  bool conflict_free_traj_step(Detection3D* conflict_det, Detection3D* recovery_det,
+  bool conflict_free_traj_step(const Detection3D* conflict_det, const Detection3D* recovery_det,
       double B, double T, double B2, double T2,
       const TrafficState& ownship, const std::vector<TrafficState>& traffic) const;
 
   void alt_bands_generic(std::vector<Integerval>& l,
-      Detection3D* conflict_det, Detection3D* recovery_det,
+      const Detection3D* conflict_det, const Detection3D* recovery_det,
       double B, double T, double B2, double T2,
       const TrafficState& ownship, const std::vector<TrafficState>& traffic);
 
-  int first_nat(int mini, int maxi, bool dir, Detection3D* conflict_det, Detection3D* recovery_det,
+  int first_nat(int mini, int maxi, bool dir, const Detection3D* conflict_det, const Detection3D* recovery_det,
       double B, double T, double B2, double T2, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
       bool green);
 
-  int first_band_alt_generic(Detection3D* conflict_det, Detection3D* recovery_det,
+  int first_band_alt_generic(const Detection3D* conflict_det, const Detection3D* recovery_det,
       double B, double T, double B2, double T2,
       const TrafficState& ownship, const std::vector<TrafficState>& traffic, bool dir, bool green);
 };
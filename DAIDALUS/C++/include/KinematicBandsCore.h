@@ -16,6 +16,8 @@
 #include "TCASTable.h"
 #include "KinematicBandsParameters.h"
 #include "Interval.h"
+#include "WCV_TAUMOD.h"
+#include "BandsStats.h"
 #include <vector>
 #include <string>
 
@@ -35,9 +37,13 @@ public:
   KinematicBandsParameters parameters;
   /* Most urgent aircraft */
   TrafficState most_urgent_ac;
+  /* Instrumentation counters of the bands computed with this core, see BandsStats */
+  BandsStats stats;
 
 private:
 
+  friend class DaidalusCheckpoint;
+
   /* Boolean to control re-computation of cached values */
   bool outdated_;
   /* Cached horizontal epsilon for implicit coordination */
@@ -63,6 +69,12 @@ private:
    */
   void conflict_aircraft(int alert_level);
 
+  /**
+   * Same as conflict_aircraft for all alert levels, using fused detection.
+   * Requires: dets are the detectors returned by fusedLevelDetectors
+   */
+  void conflict_aircraft_fused(const std::vector<const WCV_TAUMOD*>& dets);
+
 public:
 
   KinematicBandsCore(const KinematicBandsParameters& params);
@@ -137,6 +149,13 @@ public:
    */
   Interval const & timeIntervalOfViolation(int alert_level);
 
+  /**
+   * Put in dets the detectors of alert levels 1 to alertor.mostSevereAlertLevel() and return true,
+   * when all the levels are valid and their detectors are exactly of class WCV_TAUMOD, i.e., when
+   * the levels can be evaluated with WCV_TAUMOD::conflictDetectionLevels. Otherwise, return false.
+   */
+  bool fusedLevelDetectors(std::vector<const WCV_TAUMOD*>& dets) const;
+
   static int epsilonH(const TrafficState& ownship, const TrafficState& ac);
 
   static int epsilonV(const TrafficState& ownship, const TrafficState& ac);
@@ -11,12 +11,27 @@
 #include "ParameterAcceptor.h"
 #include "ErrorReporter.h"
 #include "AlertLevels.h"
-#include <map>
+#include <string>
 
 namespace larcfm {
 
 class KinematicBandsParameters : public ErrorReporter, public ParameterAcceptor {
 
+public:
+
+  /**
+   * Keys of the parameters, in the order they are written to configuration files. The name of
+   * a key in configuration files is given by keyName, e.g., "lookahead_time" for LOOKAHEAD_TIME.
+   */
+  enum Key {
+    LOOKAHEAD_TIME, LEFT_TRK, RIGHT_TRK, MIN_GS, MAX_GS, MIN_VS, MAX_VS, MIN_ALT, MAX_ALT,
+    TRK_STEP, GS_STEP, VS_STEP, ALT_STEP, HORIZONTAL_ACCEL, VERTICAL_ACCEL, TURN_RATE, BANK_ANGLE,
+    VERTICAL_RATE, RECOVERY_STABILITY_TIME, MIN_HORIZONTAL_RECOVERY, MIN_VERTICAL_RECOVERY,
+    RECOVERY_TRK, RECOVERY_GS, RECOVERY_VS, RECOVERY_ALT, CA_BANDS, CA_FACTOR, HORIZONTAL_NMAC,
+    VERTICAL_NMAC, CONFLICT_CRIT, RECOVERY_CRIT, CONTOUR_THR,
+    KEYS // Number of keys
+  };
+
 private:
 
   ErrorLog error;
@@ -64,8 +79,7 @@ private:
   double contour_thr_; // Horizontal threshold, specified as an angle to the left/right of current aircraft direction,
   // for computing horizontal contours. A value of 0 means only conflict contours. A value of pi means all contours.
 
-  std::map<std::string,std::string> units_;
-  std::vector<std::string> keys_; // List of key values
+  std::string units_[KEYS]; // Units of each key, "unspecified" for keys without units
   bool set_turn_rate(double val);
   bool set_bank_angle(double val);
   void addKeyDouble(const std::string& key, double val, const std::string& units, const std::string& msg="");
@@ -764,6 +778,24 @@ public:
 
   std::string getUnits(const std::string& key) const;
 
+  /** Units of key, "unspecified" for keys without units */
+  const std::string& getUnits(Key key) const;
+
+  /** Name of key in configuration files */
+  static const std::string& keyName(Key key);
+
+  /** Key whose name in configuration files is name, or KEYS if there is no such key */
+  static Key key(const std::string& name);
+
+  /** Value of key in internal units. The value of boolean keys is 1 (true) or 0 (false). */
+  double getValue(Key key) const;
+
+  /**
+   * Set key to val in internal units with the corresponding setter, including its side effects, e.g.,
+   * setting TURN_RATE resets the bank angle. Boolean keys are true when val is not 0. Return false on error.
+   */
+  bool setValue(Key key, double val);
+
   bool hasError() const;
 
   bool hasMessage() const;
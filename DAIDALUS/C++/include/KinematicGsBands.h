@@ -35,7 +35,7 @@ public:
 
   double time_step(const TrafficState& ownship) const;
 
-  std::pair<Vect3, Velocity> trajectory(const TrafficState& ownship, double time, bool dir) const;
+  std::pair<Vect3, Velocity> trajectory(const TrafficState& ownship, double time, bool dir, int j) const;
 
 };
 
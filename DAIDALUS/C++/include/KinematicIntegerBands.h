@@ -13,54 +13,85 @@
 #include "TrafficState.h"
 #include "Integerval.h"
 #include "IntervalSet.h"
+#include "BandsStats.h"
 
 #include <vector>
 #include <string>
 
 namespace larcfm {
 
+class TurnSampler;
+
 
 class KinematicIntegerBands {
 
   // This class computes NONE bands
 
 public:
-  virtual std::pair<Vect3,Velocity> trajectory(const TrafficState& ownship, double time, bool dir) const = 0;
+  /*
+   * Ownship trajectory at time in direction dir. In instantaneous bands, j is the index of the candidate
+   * value, i.e., the candidate is the current value plus (or minus) j steps. Implementations don't modify
+   * the object. During a kinematic sweep they may advance the samplers in turns_, which belong to that
+   * sweep, so a bands object runs one sweep at a time. Instantaneous candidates don't use turns_ and are
+   * evaluated concurrently, see instantaneous_bands_combine.
+   */
+  virtual std::pair<Vect3,Velocity> trajectory(const TrafficState& ownship, double time, bool dir, int j) const = 0;
+  KinematicIntegerBands() : j_step_(0), stats_(NULL), turns_(NULL) {}
   virtual ~KinematicIntegerBands() {}
 
 protected:
-  /* Used in definition of kinematic trajectory */
+  /* Candidate index of the functions that don't take it as a parameter, e.g., altitude bands */
   int j_step_;
+  /* Instrumentation counters, see BandsStats (not owned, may be NULL) */
+  BandsStats* stats_;
+  /*
+   * Left and right turn samplers of the kinematic sweep in progress, see KinematicTrkBands. They are
+   * local to the sweep (not owned, NULL outside of a sweep).
+   */
+  TurnSampler* turns_;
 
 private:
 
-  static bool conflict(Detection3D* det, const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi,
+  /*
+   * Detection kernels. They are instantiated for each predefined detector class,
+   * see DetectionKernel, and for Detection3D, which uses virtual dispatch.
+   */
+  template <class D>
+  static bool conflict(const Detection3D* det, const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi,
       double B, double T);
 
-  int first_los_step(Detection3D* det, double tstep,bool trajdir,
+  template <class D>
+  static bool any_los_kernel(const Detection3D* det, const Vect3& sot, const Velocity& vot, double tsk,
+      const std::vector<TrafficState>& traffic, BandsStats* stats);
+
+  template <class D>
+  static bool any_conflict_kernel(const Detection3D* det, double B, double T, const Vect3& sot, const Velocity& vot,
+      double t, const std::vector<TrafficState>& traffic, BandsStats* stats);
+
+  int first_los_step(const Detection3D* det, double tstep,bool trajdir,
       int min, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic) const;
 
-  int first_los_search_index(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+  int first_los_search_index(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
       double B, double T, double B2, double T2, bool trajdir, int max,
       const TrafficState& ownship, const std::vector<TrafficState>& traffic) const;
 
-  int bands_search_index(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+  int bands_search_index(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
       double B, double T, double B2, double T2, 
       bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
       int epsh, int epsv) const;
 
   void traj_conflict_only_bands(std::vector<Integerval>& l,
-      Detection3D* conflict_det, Detection3D* recovery_det, double tstep, double B, double T, double B2, double T2,
+      const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep, double B, double T, double B2, double T2,
       bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic) const;
 
-  void kinematic_bands(std::vector<Integerval>& l, Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+  void kinematic_bands(std::vector<Integerval>& l, const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
       double B, double T, double B2, double T2, 
       bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
       int epsh, int epsv) const;
 
 public:
 
-  bool no_conflict(Detection3D* conflict_det, Detection3D* recovery_det, double B, double T, double B2, double T2,
+  bool no_conflict(const Detection3D* conflict_det, const Detection3D* recovery_det, double B, double T, double B2, double T2,
       bool trajdir, double tsk, const TrafficState& ownship, const std::vector<TrafficState>& traffic) const;
 
   static void append_intband(std::vector<Integerval>& l, std::vector<Integerval>& r);
@@ -68,58 +99,74 @@ public:
   static void neg(std::vector<Integerval>& l);
 
   // INTERFACE FUNCTION
-  void kinematic_bands_combine(std::vector<Integerval>& l, Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+  void kinematic_bands_combine(std::vector<Integerval>& l, const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
       double B, double T, double B2, double T2,
       int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
       int epsh, int epsv) const;
 
-  bool any_los_aircraft(Detection3D* det, bool trajdir, double tsk,
+  bool any_los_aircraft(const Detection3D* det, bool trajdir, double tsk,
       const TrafficState& ownship, const std::vector<TrafficState>& traffic) const;
 
   // trajdir: false is left
-  int first_green(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+  int first_green(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
       double B, double T, double B2, double T2,
       bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
       int epsh, int epsv) const;
 
-  bool all_int_red(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+  bool all_int_red(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
       double B, double T, double B2, double T2,
       int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
       int epsh, int epsv, int dir) const;
 
-  bool any_conflict_aircraft(Detection3D* det, double B, double T, bool trajdir, double tsk,
+  bool any_conflict_aircraft(const Detection3D* det, double B, double T, bool trajdir, double tsk,
       const TrafficState& ownship, const std::vector<TrafficState>& traffic) const;
 
-  void instantaneous_bands_combine(std::vector<Integerval>& l, Detection3D* conflict_det, Detection3D* recovery_det,
+  void instantaneous_bands_combine(std::vector<Integerval>& l, const Detection3D* conflict_det, const Detection3D* recovery_det,
       double B, double T, double B2, double T2,
       int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
       const TrafficState& repac,
       int epsh, int epsv);
 
-  bool red_band_exist(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+  bool red_band_exist(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
       double B, double T, double B2, double T2,
       bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
       int epsh, int epsv) const;
 
   // INTERFACE FUNCTION
-  bool any_int_red(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+  bool any_int_red(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
       double B, double T, double B2, double T2,
       int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
       int epsh, int epsv, int dir) const;
 
-  bool all_instantaneous_red(Detection3D* conflict_det, Detection3D* recovery_det,
+  bool all_instantaneous_red(const Detection3D* conflict_det, const Detection3D* recovery_det,
       double B, double T, double B2, double T2,
       int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
       const TrafficState& repac,
       int epsh, int epsv, int dir);
 
-  bool any_instantaneous_red(Detection3D* conflict_det, Detection3D* recovery_det,
+  bool any_instantaneous_red(const Detection3D* conflict_det, const Detection3D* recovery_det,
       double B, double T, double B2, double T2,
       int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
       const TrafficState& repac,
       int epsh, int epsv, int dir);
 
 private:
+  friend class InstantaneousBandsBody;
+
+  /* Same as trajectory of candidate j_step_, counting samples when instrumentation is enabled */
+  std::pair<Vect3,Velocity> sample_trajectory(const TrafficState& ownship, double time, bool dir) const;
+
+  /* Same as trajectory, counting samples in stats when it's not NULL */
+  std::pair<Vect3,Velocity> sample_trajectory(const TrafficState& ownship, double time, bool dir, int j,
+      BandsStats* stats) const;
+
+  bool any_conflict_aircraft(const Detection3D* det, double B, double T, bool trajdir, double tsk,
+      const TrafficState& ownship, const std::vector<TrafficState>& traffic, int j, BandsStats* stats) const;
+
+  bool no_conflict(const Detection3D* conflict_det, const Detection3D* recovery_det, double B, double T, double B2, double T2,
+      bool trajdir, double tsk, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
+      int j, BandsStats* stats) const;
+
   Vect3 linvel(const TrafficState& ownship, double tstep, bool trajdir, int k) const;
 
   bool repulsive_at(double tstep, bool trajdir, int k, const TrafficState& ownship, const TrafficState& repac, int epsh) const;
@@ -130,31 +177,30 @@ private:
 
   int first_nonvert_repul_step(double tstep, bool trajdir, int max, const TrafficState& ownship, const TrafficState& repac, int epsv) const;
 
-  bool cd_future_traj(Detection3D* det, double B, double T, bool trajdir, double t,
-      const TrafficState& ownship, const TrafficState& ac) const;
+  /* First step k <= max whose horizontal (or vertical) repulsive criteria don't hold, computed in a single sweep */
+  int first_nonrepulsive_sweep(double tstep, bool trajdir, int max, const TrafficState& ownship, const TrafficState& repac,
+      int eps, bool horizontal) const;
 
-  bool any_conflict_step(Detection3D* det, double tstep, double B, double T, bool trajdir, int max,
+  bool any_conflict_step(const Detection3D* det, double tstep, double B, double T, bool trajdir, int max,
       const TrafficState& ownship, const std::vector<TrafficState>& traffic) const;
 
-  bool no_instantaneous_conflict(Detection3D* conflict_det, Detection3D* recovery_det,
+  /* True if candidate j in direction trajdir is conflict free. It doesn't modify the object. */
+  bool no_instantaneous_conflict(const Detection3D* conflict_det, const Detection3D* recovery_det,
       double B, double T, double B2, double T2,
       bool trajdir, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
       const TrafficState& repac,
-      int epsh, int epsv);
+      int epsh, int epsv, int j, BandsStats* stats) const;
 
-  void instantaneous_bands(std::vector<Integerval>& l, Detection3D* conflict_det, Detection3D* recovery_det,
-      double B, double T, double B2, double T2,
-      bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
-      const TrafficState& repac,
-      int epsh, int epsv);
+  /* Append to l the intervals of candidates 0..max that are conflict free, i.e., green[first+k] != 0 */
+  static void instantaneous_bands(std::vector<Integerval>& l, const std::vector<char>& green, int first, int max);
 
-  int first_instantaneous_green(Detection3D* conflict_det, Detection3D* recovery_det,
+  int first_instantaneous_green(const Detection3D* conflict_det, const Detection3D* recovery_det,
       double B, double T, double B2, double T2,
       bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
       const TrafficState& repac,
       int epsh, int epsv);
 
-  bool instantaneous_red_band_exist(Detection3D* conflict_det, Detection3D* recovery_det,
+  bool instantaneous_red_band_exist(const Detection3D* conflict_det, const Detection3D* recovery_det,
       double B, double T, double B2, double T2,
       bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
       const TrafficState& repac,
@@ -19,6 +19,7 @@
 #include "KinematicAltBands.h"
 #include "ErrorLog.h"
 #include "KinematicBandsCore.h"
+#include "BandsStats.h"
 #include "KinematicBandsParameters.h"
 
 namespace larcfm {
@@ -867,16 +868,63 @@ public:
    */
   void clear();
 
+  /**
+   * Return instrumentation counters and phase times accumulated by this object.
+   * Counters are only updated when the library is compiled with DAIDALUS_STATS_, see BandsStats.
+   */
+  BandsStats const & getStats() const;
+
+  /**
+   * Set instrumentation counters and phase times to 0.
+   */
+  void clearStats();
+
 protected:
   void reset();
 
 private:
 
+  friend class DaidalusCheckpoint;
+
+  /*
+   * Bands of the spread checks of the alerting logic. They are kept between calls to alerting and
+   * shared by all alert levels, so that ownship trajectory samples are reused.
+   */
+  KinematicTrkBands  spread_trk_band_;
+  KinematicGsBands   spread_gs_band_;
+  KinematicVsBands   spread_vs_band_;
+  KinematicAltBands  spread_alt_band_;
+
+  /**
+   * Set the parameters of the spread bands to the current ones. Only bands whose parameters
+   * change are reset.
+   */
+  void update_spread_bands();
+
   /**
    * Return true if and only if threshold values, defining an alerting level, are violated.
    */
   bool check_thresholds(const AlertThresholds& athr, const TrafficState& ac, int turning, int accelerating, int climbing);
 
+  /**
+   * Return true if and only if a conflict with aircraft ac is predicted for an ownship maneuver
+   * within the spread values of an alerting level.
+   */
+  bool check_spreads(const AlertThresholds& athr, const TrafficState& ac, double alerting_time,
+      int turning, int accelerating, int climbing);
+
+  /**
+   * Return true if and only if recovery bands of a dimension, enabled when recovery is true,
+   * may be computed, i.e., there are conflict aircraft at the conflict alert level.
+   */
+  bool recovery_may_apply(bool recovery);
+
+  /**
+   * Return the region of the most severe conflict band alert level for which there are conflict
+   * aircraft, or NONE if there are no conflict aircraft.
+   */
+  BandsRegion::Region region_of_conflict_aircraft();
+
 public:
 
   /* Main interface methods */
@@ -893,6 +941,90 @@ public:
    */
   Interval const & timeIntervalOfViolation(int alert_level);
 
+  /**
+   * Return region of the current track of the ownship, i.e., the region of the most severe
+   * conflict band alert level for which there are conflict aircraft, or NONE if there are no conflict
+   * aircraft. This region is computed without computing bands and is the same as regionOfTrack(current track).
+   * When track recovery bands are enabled and there are conflict aircraft at the conflict alert level,
+   * recovery bands may change the regions, so track bands are computed and the region is
+   * regionOfTrack(current track). Return UNKNOWN if the ownship hasn't been set.
+   * Other dimensions have their own recovery bands, see regionOfCurrentGroundSpeed,
+   * regionOfCurrentVerticalSpeed, and regionOfCurrentAltitude.
+   */
+  BandsRegion::Region regionOfCurrentTrajectory();
+
+  /**
+   * Return region of the current ground speed of the ownship, i.e., regionOfGroundSpeed(current ground speed),
+   * computed as in regionOfCurrentTrajectory. Ground speed bands are only computed when ground speed
+   * recovery bands may change the regions.
+   */
+  BandsRegion::Region regionOfCurrentGroundSpeed();
+
+  /**
+   * Return region of the current vertical speed of the ownship, i.e., regionOfVerticalSpeed(current vertical speed),
+   * computed as in regionOfCurrentTrajectory. Vertical speed bands are only computed when vertical speed
+   * recovery bands may change the regions.
+   */
+  BandsRegion::Region regionOfCurrentVerticalSpeed();
+
+  /**
+   * Return region of the current altitude of the ownship, i.e., regionOfAltitude(current altitude),
+   * computed as in regionOfCurrentTrajectory. Altitude bands are only computed when altitude
+   * recovery bands may change the regions.
+   */
+  BandsRegion::Region regionOfCurrentAltitude();
+
+  /**
+   * Set regions[i] to the region of the ownship velocity candidate vels[i], for every velocity
+   * in vels, i.e., the region of the most severe conflict band alert level for which an ownship
+   * instantaneously maneuvering to velocity vels[i] would be in conflict with some traffic aircraft,
+   * or NONE if there is no such level. Velocities are in the same frame as the ownship velocity.
+   * Candidates are checked against the detectors of each level, without computing bands. When the library
+   * is compiled with threads, candidates are checked in parallel, see ParallelLoop.
+   * Regions are UNKNOWN if the ownship hasn't been set.
+   */
+  void regionsOfVelocity(const std::vector<Velocity>& vels, std::vector<BandsRegion::Region>& regions);
+
+  /**
+   * Compute track, ground speed, vertical speed, and altitude bands within a time budget, in seconds.
+   * Bands are computed in stages (see KinematicRealBands::compute_stage): first, bands of the conflict alert
+   * level at a coarse step are computed for all dimensions; then, bands of the conflict alert level at the
+   * configured step; and finally, bands of all alert levels, including recovery bands. Later stages are only
+   * computed while the budget remains. The first stage is always computed, even if the budget is 0.
+   * Bands are available after this method returns, and queries, e.g., trackLength, don't trigger further
+   * computations. Bands of a dimension are approximate until they are final, e.g., isFinalTrackBands. Calling
+   * this method again continues the computation where it stopped, but an alert level interrupted by the
+   * deadline is computed again from its start. The deadline is only checked between steps of the computation,
+   * so the budget may be exceeded by the time of one step, e.g., the conflict bands of one dimension.
+   * Return true if the bands of all dimensions are final.
+   */
+  bool computeBandsWithin(double budget);
+
+  /**
+   * Compute bands within a time budget specified in given units. See computeBandsWithin(double).
+   */
+  bool computeBandsWithin(double budget, const std::string& u);
+
+  /**
+   * Return true if track bands are computed and final, i.e., not approximated by computeBandsWithin.
+   */
+  bool isFinalTrackBands() const;
+
+  /**
+   * Return true if ground speed bands are computed and final, i.e., not approximated by computeBandsWithin.
+   */
+  bool isFinalGroundSpeedBands() const;
+
+  /**
+   * Return true if vertical speed bands are computed and final, i.e., not approximated by computeBandsWithin.
+   */
+  bool isFinalVerticalSpeedBands() const;
+
+  /**
+   * Return true if altitude bands are computed and final, i.e., not approximated by computeBandsWithin.
+   */
+  bool isFinalAltitudeBands() const;
+
   /**
    * @return the number of track band intervals, negative if the ownship has not been set
    */
@@ -949,6 +1081,13 @@ public:
    */
   BandsRegion::Region regionOfTrack(double trk, const std::string& u);
 
+  /**
+   * Set regions[i] to the region of track trks[i], specified in internal units [rad], for every
+   * value in trks. Ranges are found by binary search, so this is cheaper than calling
+   * regionOfTrack for each value.
+   */
+  void regionsOfTrack(const std::vector<double>& trks, std::vector<BandsRegion::Region>& regions);
+
   /**
    * Return last time to track maneuver, in seconds, for ownship with respect to traffic
    * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -1080,6 +1219,13 @@ public:
    */
   BandsRegion::Region regionOfGroundSpeed(double gs, const std::string& u);
 
+  /**
+   * Set regions[i] to the region of ground speed gss[i], specified in internal units [m/s], for every
+   * value in gss. Ranges are found by binary search, so this is cheaper than calling
+   * regionOfGroundSpeed for each value.
+   */
+  void regionsOfGroundSpeed(const std::vector<double>& gss, std::vector<BandsRegion::Region>& regions);
+
   /**
    * Return last time to ground speed maneuver, in seconds, for ownship with respect to traffic
    * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -1211,6 +1357,13 @@ public:
    */
   BandsRegion::Region regionOfVerticalSpeed(double vs, const std::string& u);
 
+  /**
+   * Set regions[i] to the region of vertical speed vss[i], specified in internal units [m/s], for every
+   * value in vss. Ranges are found by binary search, so this is cheaper than calling
+   * regionOfVerticalSpeed for each value.
+   */
+  void regionsOfVerticalSpeed(const std::vector<double>& vss, std::vector<BandsRegion::Region>& regions);
+
   /**
    * Return last time to vertical speed maneuver, in seconds, for ownship with respect to traffic
    * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -1342,6 +1495,13 @@ public:
    */
   BandsRegion::Region regionOfAltitude(double alt, const std::string& u);
 
+  /**
+   * Set regions[i] to the region of altitude alts[i], specified in internal units [m], for every
+   * value in alts. Ranges are found by binary search, so this is cheaper than calling
+   * regionOfAltitude for each value.
+   */
+  void regionsOfAltitude(const std::vector<double>& alts, std::vector<BandsRegion::Region>& regions);
+
   /**
    * Return last time to altitude maneuver, in seconds, for ownship with respect to traffic
    * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -15,6 +15,7 @@
 #include "IntervalSet.h"
 #include "BandsRange.h"
 #include "KinematicIntegerBands.h"
+#include "BandsDeadline.h"
 
 #include <vector>
 #include <string>
@@ -25,11 +26,14 @@ namespace larcfm {
 class KinematicRealBands : public KinematicIntegerBands {
 
 private:
+  friend class DaidalusCheckpoint;
+
   static const INT64FM ALMOST_;
 
   bool outdated_; // Boolean to control re-computation of cached values
   int checked_;  // Cached status of input values. Negative unchecked, 0 unvalid, 1 valid
   std::vector< std::vector<TrafficState> > peripheral_acs_; //  Cached list of peripheral aircraft per alert level
+  std::vector<bool> peripheral_outdated_; // Per alert level, true if peripheral aircraft have to be re-computed
   std::vector<BandsRange> ranges_;     // Cached list of bands ranges
   /*
    * recovery_time_ is the time to recovery from violation.
@@ -45,6 +49,16 @@ private:
    * because of invalid inputs)
    */
   std::vector<Interval> resolutions_; // Chached resolutions per alert level
+  /*
+   * Alert levels are computed on demand, in increasing order. The number of computed levels is
+   * the size of resolutions_. none_sets_ and regions_ have an entry per computed conflict band level.
+   */
+  std::vector<IntervalSet> none_sets_; // Cached none sets per computed conflict band level
+  std::vector<BandsRegion::Region> regions_; // Cached regions per computed conflict band level
+  int stage_; // Last completed stage of the anytime computation, see compute_stage
+  IntervalSet conflict_none_set_; // Cached none set of conflict alert level, when stage_ >= CONFLICT_STAGE
+  const BandsDeadline* deadline_; // Deadline of the on-going anytime computation, NULL otherwise
+  bool interrupted_; // True if the last computation of levels was interrupted by deadline_
 
   /* Parameters for conflict bands */
   double  min_;  // Minimum/donw value
@@ -62,6 +76,14 @@ private:
 
 public:
 
+  /* Stages of the anytime computation of bands, see compute_stage */
+  static const int COARSE_STAGE = 1;
+  static const int CONFLICT_STAGE = 2;
+  static const int FINAL_STAGE = 3;
+
+  /* Ratio between the step of coarse bands and the step of bands */
+  static const int COARSE_FACTOR = 4;
+
   KinematicRealBands();
 
   KinematicRealBands(double min, double max, bool rel, double mod, double step, bool recovery);
@@ -135,7 +157,7 @@ public:
   bool check_input(const KinematicBandsCore& core);
 
   bool kinematic_conflict(KinematicBandsCore& core, const TrafficState& ac,
-      Detection3D* detector, double alerting_time);
+      const Detection3D* detector, double alerting_time);
 
   int length(KinematicBandsCore& core);
 
@@ -148,6 +170,17 @@ public:
    */
   int rangeOf(KinematicBandsCore& core, double val);
 
+  /**
+   * Set indices[i] to rangeOf(core,vals[i]) for every value in vals.
+   */
+  void rangesOf(KinematicBandsCore& core, const std::vector<double>& vals, std::vector<int>& indices);
+
+  /**
+   * Set regions[i] to the region of the range of vals[i], or UNKNOWN if there is no such range,
+   * for every value in vals.
+   */
+  void regionsOf(KinematicBandsCore& core, const std::vector<double>& vals, std::vector<BandsRegion::Region>& regions);
+
   /**
    *  Reset cached values
    */
@@ -158,6 +191,27 @@ public:
    */
   void force_compute(KinematicBandsCore& core);
 
+  /**
+   * Compute bands up to the given stage of the anytime computation, unless that stage is already completed.
+   * Stages are
+   * - COARSE_STAGE: bands of conflict alert level at COARSE_FACTOR times the step, without recovery bands.
+   * - CONFLICT_STAGE: bands of conflict alert level at the step, without recovery bands.
+   * - FINAL_STAGE: bands of all levels, including recovery bands. These bands are the same as the ones
+   *   computed without deadline.
+   * After the first stage, bands are available and they are not recomputed when queried. They are
+   * approximate until FINAL_STAGE is completed. The deadline is checked before each alert level and
+   * during the computation of recovery bands. When it expires, FINAL_STAGE is interrupted and the
+   * bands of the previous stage are kept. Earlier stages always run to completion.
+   * Return true if the stage is completed.
+   */
+  bool compute_stage(KinematicBandsCore& core, int stage, const BandsDeadline& deadline);
+
+  /**
+   * Return true if bands have been computed and they are final, i.e., they are not the approximate
+   * bands of an interrupted anytime computation.
+   */
+  bool is_final() const;
+
   /**
    * Return list of peripheral aircraft for a given alert level.
    * Requires: 0 <= alert_level <= alertor.size(). If alert_level is 0,
@@ -208,19 +262,19 @@ public:
   void toIntervalSet(IntervalSet& noneset, const std::vector<Integerval>& l,
       double scal, double add, double min, double max);
 
-  virtual void none_bands(IntervalSet& noneset, Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+  virtual void none_bands(IntervalSet& noneset, const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
       int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic);
 
-  virtual bool any_red(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+  virtual bool any_red(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
       int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic);
 
-  virtual bool all_red(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+  virtual bool all_red(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
       int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic);
 
-  bool all_green(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+  bool all_green(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
       int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic);
 
-  bool any_green(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+  bool any_green(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
       int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic);
 
   /**
@@ -229,7 +283,7 @@ public:
    * are no resolutions.
    * The value dir=false is down and dir=true is up.
    */
-  virtual double resolution(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+  virtual double resolution(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
       int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic, bool dir);
 
   std::string toString() const;
@@ -249,16 +303,23 @@ private:
    */
   double mod_val(double val) const;
 
+  /**
+   * Return index of the first range that contains val, or -1 if there is no such range.
+   * Requires: check_input(core), ranges_ are up to date, val = mod_val(val), and rov = rollover()
+   */
+  int range_index(KinematicBandsCore& core, double val, bool rov) const;
+
   /**
    *  Update cached values
    */
   void update(KinematicBandsCore& core);
 
   /**
-   * Put in peripheral_acs_ the list of aircraft predicted to be in conflict for the given alert level
+   * Put in peripheral_acs_ the list of aircraft predicted to be in conflict for the given alert level,
+   * unless it is already cached, and return that list.
    * Requires: 1 <= alert_level <= alertor.mostSevereAlertLevel()
    */
-  void peripheral_aircraft(KinematicBandsCore& core, int alert_level);
+  std::vector<TrafficState> const & peripheral_aircraft(KinematicBandsCore& core, int alert_level);
 
 	/** 
 	 * Ensure that the intervals are "complete", filling in missing intervals and ensuring the 
@@ -273,15 +334,33 @@ private:
    */
   double compute_recovery_bands(IntervalSet& noneset, KinematicBandsCore& core, const std::vector<TrafficState>& alerting_set);
 
+  /**
+   * Return true if deadline_ has expired. In that case, set interrupted_.
+   */
+  bool interrupt();
+
+  /**
+   * Put in ranges_ the bands of conflict alert level given by noneset. Other levels are ignored.
+   */
+  void color_conflict_level(const IntervalSet& noneset, KinematicBandsCore& core);
+
+  /**
+   * Put in noneset the none bands of given level, without recovery bands. Return false if no
+   * aircraft is considered for that level, i.e., noneset is the whole range.
+   */
+  bool level_none_set(IntervalSet& noneset, KinematicBandsCore& core, int alert_level);
+
   /**
    * Compute bands for one level. Return recovery time (NaN if recover bands are not computed)
    */
   double compute_level(IntervalSet& noneset, KinematicBandsCore& core, int alert_level);
 
   /**
-   * Compute all bands.
+   * Compute none sets and resolutions of alert levels up to max_level that haven't been computed yet.
+   * If deadline_ expires, the computation stops and the level being computed is discarded.
+   * Requires: check_input(core)
    */
-  void compute(KinematicBandsCore& core);
+  void compute_levels(KinematicBandsCore& core, int max_level);
 
   Interval find_resolution(KinematicBandsCore& core, const IntervalSet& noneset);
 
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef LATENCYHISTOGRAM_H_
+#define LATENCYHISTOGRAM_H_
+
+#include <string>
+
+namespace larcfm {
+
+/**
+ * Histogram of latencies, in seconds, with logarithmic buckets split into linear sub-buckets, as in
+ * HDR histograms. Latencies under 1 microsecond are split into SUB_BUCKETS buckets. Then each range
+ * [2^(k-1),2^k) microseconds, for k from 1 to OCTAVES-1, is split into SUB_BUCKETS buckets. The last
+ * bucket holds all larger latencies. Percentiles are reported as the upper bound of their bucket,
+ * i.e., within a relative error of 1/SUB_BUCKETS.
+ */
+class LatencyHistogram {
+
+public:
+
+  static const int OCTAVES = 32;
+  static const int SUB_BUCKETS = 16;
+  static const int BUCKETS = OCTAVES*SUB_BUCKETS;
+
+  LatencyHistogram();
+
+  /** Remove all samples */
+  void clear();
+
+  /** Add a latency sample, in seconds */
+  void add(double latency);
+
+  /** Add all samples of h */
+  void add(const LatencyHistogram& h);
+
+  /** Number of samples */
+  unsigned long count() const;
+
+  /** Mean latency in seconds, 0 if there are no samples */
+  double mean() const;
+
+  /** Maximum latency in seconds, 0 if there are no samples */
+  double max() const;
+
+  /**
+   * Upper bound, in seconds, of the bucket of the p-th quantile, with 0 <= p <= 1.
+   * The bound is limited by the maximum latency. Return 0 if there are no samples.
+   */
+  double percentile(double p) const;
+
+  /** Number of samples in bucket i */
+  unsigned long bucketCount(int i) const;
+
+  /** Upper bound, in seconds, of bucket i */
+  static double bucketBound(int i);
+
+  /** Index of the bucket of a latency, in seconds */
+  static int bucketIndex(double latency);
+
+  /** One line summary: count, mean, 50th, 90th, and 99th percentile, and maximum, in milliseconds */
+  std::string toString() const;
+
+private:
+
+  unsigned long counts_[BUCKETS];
+  unsigned long count_;
+  double sum_;
+  double max_;
+
+};
+
+}
+
+#endif
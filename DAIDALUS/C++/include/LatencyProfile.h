@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef LATENCYPROFILE_H_
+#define LATENCYPROFILE_H_
+
+#include "LatencyHistogram.h"
+#include <string>
+#include <vector>
+
+namespace larcfm {
+
+/**
+ * Latencies of the phases of a computation that is repeated for each time step of a scenario, e.g.,
+ * reading the states, computing bands, and writing the results. Each phase has a LatencyHistogram
+ * and keeps its WORST slowest samples, with the file and time of their time step, so that slow
+ * geometries can be found and reproduced.
+ */
+class LatencyProfile {
+
+public:
+
+  static const int WORST = 5;
+
+  /* Sample of a phase, with the time step where it happened */
+  struct Sample {
+    double latency; // [s]
+    std::string file;
+    double time;    // [s]
+  };
+
+  LatencyProfile();
+
+  /** Add a phase with the given name and return its index */
+  int addPhase(const std::string& name);
+
+  /** Number of phases */
+  int numberOfPhases() const;
+
+  /** Name of phase i */
+  const std::string& getName(int i) const;
+
+  /** Add the latency, in seconds, of phase i for the time step at the given time of file */
+  void add(int i, double latency, const std::string& file, double time);
+
+  /** Histogram of phase i */
+  const LatencyHistogram& getHistogram(int i) const;
+
+  /** Slowest samples of phase i, from the slowest one */
+  const std::vector<Sample>& getWorst(int i) const;
+
+  /** Remove all samples */
+  void clear();
+
+  /**
+   * Multi-line report: for each phase, count, mean, 50th, 99th, and 99.9th percentile, and maximum,
+   * in milliseconds, with the file and time of the maximum, followed by the slowest samples of the
+   * last phase, which is usually the total of the other ones.
+   */
+  std::string toString() const;
+
+private:
+
+  std::vector<std::string> names_;
+  std::vector<LatencyHistogram> histograms_;
+  std::vector< std::vector<Sample> > worst_;
+
+};
+
+}
+
+#endif
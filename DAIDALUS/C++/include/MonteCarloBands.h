@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef MONTECARLOBANDS_H_
+#define MONTECARLOBANDS_H_
+
+#include "Daidalus.h"
+#include "KinematicMultiBands.h"
+#include "TrafficState.h"
+#include "BandsRegion.h"
+#include <string>
+#include <vector>
+
+namespace larcfm {
+
+/**
+ * Gaussian uncertainty of the state of an aircraft. Errors in the horizontal plane are
+ * correlated with the given coefficient. Errors of positions and velocities are independent.
+ * The default uncertainty is 0.
+ */
+struct StateUncertainty {
+  double s_EW_std; // Standard deviation of east-west position [m]
+  double s_NS_std; // Standard deviation of north-south position [m]
+  double s_EN_rho; // Correlation coefficient of east-west and north-south position errors, in [-1,1]
+  double sz_std;   // Standard deviation of altitude [m]
+  double v_EW_std; // Standard deviation of east-west velocity [m/s]
+  double v_NS_std; // Standard deviation of north-south velocity [m/s]
+  double v_EN_rho; // Correlation coefficient of east-west and north-south velocity errors, in [-1,1]
+  double vz_std;   // Standard deviation of vertical speed [m/s]
+
+  StateUncertainty();
+
+  StateUncertainty(double s_h_std, double sz, double v_h_std, double vz);
+};
+
+/**
+ * Monte Carlo evaluation of alerting and bands under state uncertainty. Samples of the ownship and
+ * traffic states are drawn around their nominal values, and the alerting and bands of each sample are
+ * computed with the configuration of prototype. The results are the distribution of the alert level of
+ * each traffic aircraft and, for a grid of values of each dimension, the probability of each bands region.
+ * Grids go from the minimum to the maximum of each dimension, in steps of the configured step, e.g.,
+ * trk_step for track.
+ *
+ * Samples are evaluated in parallel, see ParallelLoop, and every thread reuses its own Daidalus and
+ * KinematicMultiBands objects across samples and calls to evaluate. Sample k only depends on the seed
+ * and k, so results don't depend on the number of threads. Normal values are drawn from the raw output
+ * of std::mt19937, so results don't depend on the standard library either.
+ */
+class MonteCarloBands {
+
+public:
+
+  /** Configuration, e.g., parameters and wind, of the Daidalus objects of the samples */
+  Daidalus prototype;
+
+  MonteCarloBands();
+
+  ~MonteCarloBands();
+
+  /** Clear ownship and traffic aircraft */
+  void clear();
+
+  /**
+   * Clear traffic aircraft, and set nominal ownship state, whose time is the current time, and its
+   * uncertainty. Nominal velocities are ground velocities, as the ones given to Daidalus.
+   */
+  void setOwnship(const TrafficState& ownship, const StateUncertainty& u);
+
+  /** Add nominal traffic state and its uncertainty. Return index of the aircraft. */
+  int addTraffic(const TrafficState& ac, const StateUncertainty& u);
+
+  /**
+   * Set nominal states to the ones in daa, all of them with uncertainty u. The wind of daa is added
+   * back to its air velocities, so that nominal velocities are ground velocities.
+   */
+  void setNominal(const Daidalus& daa, const StateUncertainty& u);
+
+  /** Set uncertainty of aircraft ac. Index 0 is the ownship. */
+  void setUncertainty(int ac, const StateUncertainty& u);
+
+  /** Return last traffic index. Index 0 is the ownship */
+  int lastTrafficIndex() const;
+
+  /**
+   * Evaluate the given number of samples, drawn from the random generator seeded with seed, and
+   * replace the results of previous evaluations.
+   */
+  void evaluate(int samples, unsigned long seed = 0);
+
+  /** Number of samples of the last evaluation */
+  int samples() const;
+
+  /** Fraction of the samples where the alert level of traffic aircraft ac is alert_level */
+  double alertProbability(int ac, int alert_level) const;
+
+  /** Fraction of the samples where the alert level of traffic aircraft ac is at least alert_level */
+  double alertAtLeastProbability(int ac, int alert_level) const;
+
+  /** Grid of track values [rad] */
+  const std::vector<double>& trackValues() const;
+
+  /** Fraction of the samples where track value i is in the given region */
+  double trackProbability(int i, BandsRegion::Region region) const;
+
+  /** Grid of ground speed values [m/s] */
+  const std::vector<double>& groundSpeedValues() const;
+
+  /** Fraction of the samples where ground speed value i is in the given region */
+  double groundSpeedProbability(int i, BandsRegion::Region region) const;
+
+  /** Grid of vertical speed values [m/s] */
+  const std::vector<double>& verticalSpeedValues() const;
+
+  /** Fraction of the samples where vertical speed value i is in the given region */
+  double verticalSpeedProbability(int i, BandsRegion::Region region) const;
+
+  /** Grid of altitude values [m] */
+  const std::vector<double>& altitudeValues() const;
+
+  /** Fraction of the samples where altitude value i is in the given region */
+  double altitudeProbability(int i, BandsRegion::Region region) const;
+
+  std::string toString() const;
+
+private:
+
+  static const int TRK = 0;
+  static const int GS = 1;
+  static const int VS = 2;
+  static const int ALT = 3;
+  static const int DIMENSIONS = 4;
+  static const int REGIONS = 6; // Number of values of BandsRegion::Region
+
+  class Scratch;
+  friend class MonteCarloBody;
+
+  std::vector<TrafficState> nominal_;  // Index 0 is the ownship
+  std::vector<StateUncertainty> uncertainty_;
+  std::vector<double> values_[DIMENSIONS];
+  int levels_;                         // Most severe alert level of the last evaluation
+  int samples_;
+  std::vector<long> region_counts_[DIMENSIONS]; // Value i, region r is at i*REGIONS+r
+  std::vector<long> alert_counts_;              // Aircraft ac, level l is at (ac-1)*(levels_+1)+l
+  std::vector<Scratch*> scratch_;
+
+  void grid();
+  double probability(int dim, int i, BandsRegion::Region region) const;
+  void sample(Scratch& scratch, unsigned long seed, int k) const;
+
+  MonteCarloBands(const MonteCarloBands&);
+  MonteCarloBands& operator=(const MonteCarloBands&);
+
+};
+
+}
+
+#endif
@@ -24,7 +24,7 @@ public:
   /**
    * @return INVALID aircraft
    */
-  TrafficState mostUrgentAircraft(Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T);
+  TrafficState mostUrgentAircraft(const Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T);
   UrgencyStrategy* copy() const;
 };
 
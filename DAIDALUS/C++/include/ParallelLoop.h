@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef PARALLELLOOP_H_
+#define PARALLELLOOP_H_
+
+namespace larcfm {
+
+/**
+ * Runs the iterations of a loop in several threads. Threads are only used when the library
+ * is compiled with DAIDALUS_THREADS_ defined, e.g.,
+ * make CXXFLAGS="-Iinclude -O -pthread -DDAIDALUS_THREADS_".
+ * Otherwise, loops run sequentially in the calling thread. Worker threads are started by the
+ * first loops that need them and are reused by later loops, so that a loop doesn't pay for
+ * thread creation.
+ */
+class ParallelLoop {
+
+public:
+
+  /**
+   * Body of a loop over [0,n). Chunks of iterations may run concurrently, so
+   * run shouldn't modify state shared with other chunks.
+   */
+  class Body {
+  public:
+    virtual ~Body() {}
+    /** Run iterations begin, ..., end-1 */
+    virtual void run(int begin, int end) = 0;
+  };
+
+  /** Maximum number of threads */
+  static const int MAX_THREADS = 64;
+
+  /** Return true if the library was compiled with threads */
+  static bool isEnabled();
+
+  /**
+   * Return number of threads used by loops: the number of threads set by setConcurrency or, if
+   * it's 0, the number of online processors. Return 1 when threads aren't enabled.
+   */
+  static int concurrency();
+
+  /**
+   * Set number of threads used by loops, 0 means the number of online processors.
+   * Values are bounded by MAX_THREADS.
+   */
+  static void setConcurrency(int n);
+
+  /**
+   * Run body over [0,n), split in at most concurrency() contiguous chunks of at least
+   * min_chunk iterations each, and wait for all chunks to finish. The calling thread runs
+   * chunks along with the worker threads. Loops run from the body of another loop, or while
+   * another thread is running a loop, run sequentially.
+   */
+  static void run(int n, Body& body, int min_chunk = 1);
+
+};
+
+}
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef SPSCQUEUE_H_
+#define SPSCQUEUE_H_
+
+#include <vector>
+#include <atomic>
+
+namespace larcfm {
+
+/**
+ * Bounded lock-free queue for one producer thread and one consumer thread. The capacity
+ * is rounded up to a power of 2. Operations never block: tryPush returns false when the
+ * queue is full and tryPop returns false when it is empty, so that each side decides how to
+ * wait, e.g., to apply backpressure on its own input.
+ */
+template <typename T>
+class SPSCQueue {
+
+public:
+
+  /** Empty queue that holds at least capacity elements */
+  explicit SPSCQueue(int capacity) : head_(0), tail_(0) {
+    unsigned long n = 1;
+    while (n < (unsigned long)capacity) {
+      n <<= 1;
+    }
+    buffer_.resize(n);
+    mask_ = n-1;
+  }
+
+  /** Maximum number of elements in the queue */
+  int capacity() const {
+    return (int)buffer_.size();
+  }
+
+  /** Number of elements in the queue. It is only a snapshot when the other side is active. */
+  int size() const {
+    return (int)(tail_.load(std::memory_order_acquire)-head_.load(std::memory_order_acquire));
+  }
+
+  /** Add x at the end of the queue. Return false if the queue is full. Only called by the producer. */
+  bool tryPush(const T& x) {
+    unsigned long tail = tail_.load(std::memory_order_relaxed);
+    if (tail-head_.load(std::memory_order_acquire) == buffer_.size()) {
+      return false;
+    }
+    buffer_[tail & mask_] = x;
+    tail_.store(tail+1,std::memory_order_release);
+    return true;
+  }
+
+  /** Remove the first element of the queue and put it in x. Return false if the queue is empty. Only called by the consumer. */
+  bool tryPop(T& x) {
+    unsigned long head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    x = buffer_[head & mask_];
+    head_.store(head+1,std::memory_order_release);
+    return true;
+  }
+
+private:
+
+  std::vector<T> buffer_;
+  unsigned long mask_;
+  std::atomic<unsigned long> head_; // Index of next element to pop. Only written by the consumer
+  char pad_[64]; // Keep head_ and tail_ in different cache lines
+  std::atomic<unsigned long> tail_; // Index of next element to push. Only written by the producer
+
+  SPSCQueue(const SPSCQueue&);
+  SPSCQueue& operator=(const SPSCQueue&);
+
+};
+
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef SCENARIOGENERATOR_H_
+#define SCENARIOGENERATOR_H_
+
+#include "Position.h"
+#include "Velocity.h"
+#include "LatLonAlt.h"
+#include "Vect3.h"
+#include "Projection.h"
+#include <string>
+#include <vector>
+#include <random>
+
+namespace larcfm {
+
+/**
+ * Generator of synthetic airspaces for scaling studies. The ownship, AC0, flies straight and level at
+ * the center of a disk, on the middle layer if there are any. Traffic aircraft, AC1 to ACn, are
+ * uniformly distributed in the disk, either in altitude layers or at any altitude, in which case they
+ * may climb or descend until they reach the bounds of the altitude range. A fraction of them are
+ * placed on a straight and level collision course with the ownship, on its layer if there are any,
+ * and a fraction of the other ones turn at a constant rate.
+ *
+ * Scenarios are reproducible: the states only depend on the settings and the seed, which are public
+ * members, and not on the standard library, since only the raw output of std::mt19937 is used.
+ * Method generate draws the initial states, after which frames are computed on demand and can be
+ * written in DAIDALUS format or as a sequence of TrafficRecord. All values are in internal units.
+ */
+class ScenarioGenerator {
+
+public:
+
+  int aircraft;        // Number of aircraft, including the ownship
+  double radius;       // Radius of the airspace around the ownship [m]
+  double density;      // Aircraft per square meter. If positive, generate sets radius from it
+  double min_alt;      // Altitude range [m]
+  double max_alt;
+  int layers;          // Number of evenly spaced altitude layers in the altitude range, 0 for none
+  double min_gs;       // Ground speed range [m/s]
+  double max_gs;
+  double max_vs;       // Maximum vertical speed of traffic aircraft not in layers [m/s]
+  double encounters;   // Fraction of traffic aircraft on a collision course with the ownship
+  double maneuvering;  // Fraction of traffic aircraft not on a collision course that turn
+  double turn_rate;    // Turn rate of maneuvering aircraft [rad/s]
+  double duration;     // Duration of the scenario [s]
+  double step;         // Time between frames [s]
+  bool latlon;         // Geodetic coordinates if true, Euclidean otherwise
+  LatLonAlt center;    // Projection origin of geodetic coordinates
+  unsigned long seed;  // Seed of the random generator
+
+  ScenarioGenerator();
+
+  /** Draw the initial states of all aircraft. It has to be called after the settings are changed. */
+  void generate();
+
+  /** Number of frames of the scenario */
+  int numberOfFrames() const;
+
+  /** Time of frame f [s] */
+  double frameTime(int f) const;
+
+  /** Identifier of aircraft ac, with 0 <= ac < aircraft */
+  std::string getId(int ac) const;
+
+  /** Position and velocity of aircraft ac at time t */
+  void state(int ac, double t, Position& pos, Velocity& vel) const;
+
+  /** Write all frames to filename in DAIDALUS format. Return false if the file cannot be written. */
+  bool writeDaa(const std::string& filename) const;
+
+  /**
+   * Write all frames to filename as a sequence of TrafficRecord, ended by an END_OF_STREAM record.
+   * Return false if the file cannot be written.
+   */
+  bool writeBinary(const std::string& filename) const;
+
+  /**
+   * Process the option of the command line at args[i], with its value at args[i+1]. Return the
+   * number of arguments used, 0 if args[i] isn't an option of the generator.
+   */
+  int processOptions(const char* args[], int n, int i);
+
+  /** Help message of the options of the generator */
+  static std::string getHelpString();
+
+  /** One line description of the settings */
+  std::string toString() const;
+
+private:
+
+  /* Initial state of an aircraft, in Euclidean coordinates centered on the ownship */
+  struct InitialState {
+    Vect3 s;
+    double trk;
+    double gs;
+    double vs;
+    double omega;  // Turn rate, 0 for straight flight
+  };
+
+  std::vector<InitialState> states_;
+  EuclideanProjection prj_; // Projection of geodetic coordinates, centered on center
+  std::mt19937 gen_;
+
+  double uniform();
+  double uniform(double lo, double hi);
+  double layer(int k) const;
+  double altitude();
+
+};
+
+}
+
+#endif
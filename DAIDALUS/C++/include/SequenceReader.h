@@ -15,7 +15,6 @@
 #include "AircraftState.h"
 #include <string>
 #include <vector>
-#include <set>
 #include <map>
 
 namespace larcfm {
@@ -56,17 +55,41 @@ namespace larcfm {
  */
 class SequenceReader : public StateReader {
 private:
-	typedef std::pair<Position, Velocity> DataPoint;
-	typedef std::map<std::string, DataPoint> SequenceEntry;
-	typedef std::map<double, SequenceEntry> SequenceEntryMap;
+	/** Entry of an aircraft at a sequence key. The aircraft is identified by its index in nameIndex. */
+	struct SequenceRecord {
+		int id;
+		Position p;
+		Velocity v;
+		SequenceRecord(int i, const Position& pp, const Velocity& vv) : id(i), p(pp), v(vv) {}
+	};
+
+	/** Entry read from a file, before it is sorted into the sequence table */
+	struct LoadedRecord {
+		double time;
+		int order;
+		SequenceRecord rec;
+		LoadedRecord(double tm, int o, const SequenceRecord& r) : time(tm), order(o), rec(r) {}
+		bool operator<(const LoadedRecord& r) const;
+	};
 
 	int windowSize;
-	SequenceEntryMap sequenceTable;
-	std::vector<std::string> nameIndex;
-	std::set<std::string> names;
+	/*
+	 * The sequence table is stored flat. sequenceTimes holds the sorted sequence keys. The entries of
+	 * sequenceTimes[i] are sequenceRecords[sequenceStart[i]] to sequenceRecords[sequenceStart[i+1]-1],
+	 * sorted by aircraft index. sequenceStart has one more element than sequenceTimes.
+	 */
+	std::vector<double> sequenceTimes;
+	std::vector<int> sequenceStart;
+	std::vector<SequenceRecord> sequenceRecords;
+	std::vector<std::string> nameIndex; // Aircraft names, in the order of the file
+	std::map<std::string,int> names; // Index of each aircraft name in nameIndex
 	
 	void loadfile();
-	void buildActive(double tm);
+	void buildTable(std::vector<LoadedRecord>& loaded);
+	void clearTable();
+	void buildActive(int i);
+	int timeIndex(double tm) const;
+	int recordIndex(const std::string& name, double time) const;
 	
 public:
     /** A new, empty StateReader.  This may be used to store parameters, but nothing else. */
@@ -98,6 +121,24 @@ public:
 	 */
 	void setActive(double tm);
 	
+	/**
+	 * Set the i-th sequence key, in increasing order, to be the active one. If there is no such key,
+	 * the active set is left empty.
+	 * @param i Index of the sequence key, 0 <= i < sequenceSize()
+	 */
+	void setActiveIndex(int i);
+
+	/**
+	 * Return the index of the last sequence key that is less than or equal to tm, or -1 if there is
+	 * no such key. The search takes logarithmic time in the number of sequence entries.
+	 */
+	int sequenceIndex(double tm) const;
+
+	/**
+	 * Return the i-th sequence key, in increasing order, or NaN if there is no such key.
+	 */
+	double sequenceKey(int i) const;
+
 	/**
 	 * Set the first entry to be the active one.
 	 */
@@ -109,7 +150,7 @@ public:
 	void setLastActive();
 
 	/** Returns true if an entry exists for the given name and time */
-	bool hasEntry(const std::string& name, double time);
+	bool hasEntry(const std::string& name, double time) const;
 	
 	/** Returns the Position entry for a given name and time.  If no entry for this name and time, returns a zero position and sets a warning. */
 	Position getSequencePosition(const std::string& name, double time);
@@ -134,10 +175,10 @@ public:
 	/**
 	 *  Returns a sorted list of all sequence keys
 	 */
-	std::vector<double> sequenceKeys();
+	std::vector<double> sequenceKeys() const;
 
 	/** a list of n > 0 sequence keys, stopping at the given time (inclusive) */ 
-	std::vector<double> sequenceKeysUpTo(int n, double tm);
+	std::vector<double> sequenceKeysUpTo(int n, double tm) const;
 
 //    std::string toString() const;
 };
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef SHAREDRECORDS_H_
+#define SHAREDRECORDS_H_
+
+#include "Position.h"
+#include "Velocity.h"
+#include <string>
+#include <stdint.h>
+
+namespace larcfm {
+
+/**
+ * Fixed-layout traffic state exchanged through a SharedRing. All values are in internal units.
+ * A frame is a sequence of records of the same time: the first one has the OWNSHIP flag and the
+ * last one has the END_OF_FRAME flag. A record with the END_OF_STREAM flag and no state ends the stream.
+ */
+struct TrafficRecord {
+
+  static const uint32_t OWNSHIP = 1;       // Record is the ownship. It starts a frame
+  static const uint32_t END_OF_FRAME = 2;  // Record is the last one of its frame
+  static const uint32_t END_OF_STREAM = 4; // No more frames. Other fields are ignored
+  static const uint32_t LATLON = 8;        // Position is latitude [rad], longitude [rad], altitude [m]
+
+  static const int ID_SIZE = 32;
+
+  char id[ID_SIZE];  // Aircraft identifier, NUL terminated
+  uint32_t flags;
+  uint32_t reserved;
+  double time;       // [s]
+  double x;          // Latitude [rad] or sx [m]
+  double y;          // Longitude [rad] or sy [m]
+  double z;          // Altitude [m]
+  double vx;         // Ground velocity [m/s]
+  double vy;
+  double vz;
+
+  /** True if id fits in a record, i.e., it has at most ID_SIZE-1 characters */
+  static bool validId(const std::string& id);
+
+  /**
+   * Set all fields of the record. Return false if ida doesn't fit in the record, in which case the
+   * identifier is truncated and the record shouldn't be sent, since it may collide with another one.
+   */
+  bool set(const std::string& ida, const Position& pos, const Velocity& vel, double t, uint32_t f);
+
+  std::string getId() const;
+
+  Position getPosition() const;
+
+  Velocity getVelocity() const;
+
+};
+
+/**
+ * Fixed-layout result exchanged through a SharedRing. The results of a frame are the ALERT records of
+ * each traffic aircraft, the bands of each dimension, and a final END record. Values are in internal units.
+ */
+struct ResultRecord {
+
+  enum Kind { ALERT, TRK, GS, VS, ALT, END, END_OF_STREAM };
+
+  static const int ID_SIZE = 32;
+
+  char ownship[ID_SIZE]; // Ownship identifier, NUL terminated
+  char traffic[ID_SIZE]; // Traffic identifier of ALERT records, empty otherwise
+  uint32_t kind;
+  int32_t value;         // Alert level of ALERT, BandsRegion::Region of bands, 1 if bands are final in END
+  double time;           // [s]
+  double low;            // Bands interval [rad], [m/s], or [m]
+  double up;
+
+  void set(Kind k, const std::string& own, const std::string& ac, int val, double t, double lo, double hi);
+
+  /**
+   * Text representation of the record in the format of DaidalusService, with bands in the given units
+   * for track, ground speed, vertical speed, and altitude.
+   */
+  std::string toString(const std::string& utrk, const std::string& ugs, const std::string& uvs, const std::string& ualt) const;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef SHAREDRING_H_
+#define SHAREDRING_H_
+
+#include "ErrorReporter.h"
+#include "ErrorLog.h"
+#include <string>
+#include <cstddef>
+
+namespace larcfm {
+
+struct SharedRingHeader;
+
+/**
+ * Ring of fixed-size records in POSIX shared memory, for one producer process and one consumer
+ * process on the same host. One side creates the ring and the other side opens it by name.
+ * Records are written and read in place: the producer fills the slot returned by reserve and
+ * publishes it with commit; the consumer reads the slot returned by peek and frees it with release.
+ * Operations never block. The ring is removed from the system when the side that created it closes it.
+ */
+class SharedRing : public ErrorReporter {
+
+public:
+
+  /** Ring that is not attached to any shared memory */
+  SharedRing();
+
+  ~SharedRing();
+
+  /**
+   * Create shared memory object name, e.g., "/daidalus_in", holding a ring of at least capacity records
+   * of record_size bytes. Return false on error, e.g., if an object with the same name already exists,
+   * since it may be a ring in use by another process. See remove.
+   */
+  bool create(const std::string& name, int record_size, int capacity);
+
+  /**
+   * Remove shared memory object name, e.g., the ring left by a process that didn't close it. Processes
+   * attached to it keep their mapping. Return false if it doesn't exist.
+   */
+  static bool remove(const std::string& name);
+
+  /**
+   * Attach to the ring in shared memory object name, created by another process. If record_size is positive,
+   * it has to be the record size of the ring. Return false on error, e.g., if the object doesn't exist yet.
+   */
+  bool open(const std::string& name, int record_size);
+
+  /** Detach from the ring. The shared memory object is removed if this ring created it. */
+  void close();
+
+  bool isOpen() const;
+
+  /** Size of records in bytes */
+  int recordSize() const;
+
+  /** Maximum number of records in the ring */
+  int capacity() const;
+
+  /** Number of records in the ring. It is only a snapshot when the other side is active. */
+  int size() const;
+
+  /** Producer: return slot of next record, or NULL if the ring is full. */
+  void* reserve();
+
+  /** Producer: publish the record in the slot returned by reserve. */
+  void commit();
+
+  /** Consumer: return slot of first record, or NULL if the ring is empty. */
+  const void* peek() const;
+
+  /** Consumer: free the slot returned by peek. */
+  void release();
+
+  bool hasError() const {
+    return error.hasError();
+  }
+
+  bool hasMessage() const {
+    return error.hasMessage();
+  }
+
+  std::string getMessage() {
+    return error.getMessage();
+  }
+
+  std::string getMessageNoClear() const {
+    return error.getMessageNoClear();
+  }
+
+private:
+
+  std::string name_;
+  bool owner_;
+  void* base_;
+  size_t length_;
+  SharedRingHeader* header_;
+  char* slots_;
+  mutable ErrorLog error;
+
+  bool map(int fd, size_t length);
+
+  SharedRing(const SharedRing&);
+  SharedRing& operator=(const SharedRing&);
+
+};
+
+}
+
+#endif
@@ -18,6 +18,7 @@
 #include "Velocity.h"
 #include "Position.h"
 #include "Util.h"
+#include <vector>
 #include "Point.h"
 
 namespace larcfm {
@@ -119,6 +120,8 @@ namespace larcfm {
     /** Given a velocity from a point in Euclidean 3-space, return a projection of this velocity.  If toLatLon is true, the velocity is projected into the geodetic coordinate space */ 
     Velocity inverseVelocity(const Vect3& s, const Velocity& v, bool toLatLon) const;
     
+    /** Project a list of lat/lon(/alt) points and their velocities in Euclidean 3-space, i.e., s[i] is project(lla[i]) and v[i] is projectVelocity(lla[i],vel[i]) */
+    void projectList(const std::vector<LatLonAlt>& lla, const std::vector<Velocity>& vel, std::vector<Vect3>& s, std::vector<Velocity>& v) const;
     /** Given a velocity from a point, return a projection of this velocity and the point in Euclidean 3-space.  If the position is already in Euclidean coordinates, this acts as the idenitty function. */ 
     std::pair<Vect3,Velocity> project(const Position& p, const Velocity& v) const;
     
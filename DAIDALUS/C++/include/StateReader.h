@@ -76,6 +76,9 @@ namespace larcfm {
 class StateReader: public ErrorReporter, public ParameterReader, public ParameterProvider {
 private:
 	void loadfile();
+	void setInput(std::istream* ins);
+	void findHeadings();
+	void readColumns(Position& ss, Velocity& vv) const;
 
 protected:
 	// we store the heading indices in the following order:
@@ -121,6 +124,19 @@ public:
 	/** Read a new stream into an existing StateReader.  Parameters are preserved if they are not specified in the file. */
 	virtual void open(std::istream* ins);
 
+	/**
+	 * Prepare to read the states of stream ins one at a time with readState, e.g., when the stream
+	 * is fed as lines arrive. States are not stored.  Parameters are preserved if they are not specified in the stream.
+	 */
+	void openStream(std::istream* ins);
+
+	/**
+	 * Read the next state of the stream opened with openStream into name, pos, vel, and time. Header, units,
+	 * and parameter lines are processed on the way. Return false if no state is read, i.e., at the end of the
+	 * stream or if the state cannot be read, in which case there is an error message.
+	 */
+	bool readState(std::string& name, Position& pos, Velocity& vel, double& time);
+
 	ParameterData& getParametersRef();
 	ParameterData getParameters() const;
 	void updateParameterData(ParameterData& p) const;
@@ -18,6 +18,8 @@ class TrafficState {
 
 private:
 
+  friend class DaidalusCheckpoint;
+
   EuclideanProjection eprj_;
   std::string id_;
   Position pos_;
@@ -29,6 +31,9 @@ private:
   TrafficState(const std::string& id, const Position& pos, const Velocity& vel, double time,
       const EuclideanProjection& eprj);
 
+  TrafficState(const std::string& id, const Position& pos, const Velocity& vel,
+      const Vect3& s, const Velocity& v, double time, const EuclideanProjection& eprj);
+
 public:
 
   TrafficState();
@@ -51,6 +56,14 @@ public:
 
   TrafficState makeIntruder(const std::string& id, const Position& pos, const Velocity& vel) const;
 
+  /**
+   * Set traffic to the intruders with given identifiers, positions, and velocities, i.e., traffic[i] is
+   * makeIntruder(ids[i],pos[i],vel[i]). Lat/lon states are projected in one pass, see
+   * EuclideanProjection::projectList.
+   */
+  void makeIntruders(const std::vector<std::string>& ids, const std::vector<Position>& pos,
+      const std::vector<Velocity>& vel, std::vector<TrafficState>& traffic) const;
+
   Vect3 const & get_s() const;
 
   Velocity const & get_v() const;
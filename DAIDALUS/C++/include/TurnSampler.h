@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+#ifndef TURNSAMPLER_H_
+#define TURNSAMPLER_H_
+
+#include "Vect3.h"
+#include "Velocity.h"
+#include <vector>
+#include <utility>
+
+namespace larcfm {
+
+/**
+ * Table of equally spaced samples of a constant turn rate trajectory in Euclidean space, i.e.,
+ * the same values as Kinematics::turnOmega(s0,v0,k*tstep,omega), for k >= 0.
+ * Samples are generated incrementally by rotating the velocity of sample k-1 by omega*tstep,
+ * which avoids evaluating sine and cosine for each sample. To bound the accumulated drift,
+ * every ANCHOR-th sample is computed with the closed form solution.
+ */
+class TurnSampler {
+
+public:
+
+  /** Distance, in number of samples, between samples computed in closed form */
+  static const int ANCHOR = 16;
+
+  /** Maximum number of samples kept in the table */
+  static const int MAX_SAMPLES = 4096;
+
+  /** Empty sampler */
+  TurnSampler();
+
+  /**
+   * Discard current samples and start a new trajectory at (s0,v0), with turn rate omega
+   * and time between samples tstep.
+   * Requires: omega != 0, tstep > 0
+   */
+  void start(const Vect3& s0, const Velocity& v0, double omega, double tstep);
+
+  /** Discard current trajectory */
+  void clear();
+
+  /** Return true if the sampler holds a trajectory */
+  bool isValid() const;
+
+  /** Return true if the sampler holds the trajectory starting at (s0,v0) with time between samples tstep */
+  bool startsAt(const Vect3& s0, const Velocity& v0, double tstep) const;
+
+  /**
+   * If time is exactly k*tstep, for some 0 <= k < MAX_SAMPLES, set sv to sample k and return true.
+   * Otherwise, return false.
+   */
+  bool sample(double time, std::pair<Vect3,Velocity>& sv);
+
+private:
+
+  Vect3 s0_;
+  Velocity v0_;
+  double omega_;
+  double tstep_;
+  double cos_;
+  double sin_;
+  /* Horizontal velocities of samples 0,1,... */
+  std::vector< std::pair<double,double> > vxy_;
+
+  /* Extend table up to sample k (inclusive) */
+  void extend(int k);
+
+};
+
+}
+
+#endif
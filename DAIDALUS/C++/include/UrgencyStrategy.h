@@ -24,7 +24,7 @@ class UrgencyStrategy {
 public:
   UrgencyStrategy() {}
   virtual ~UrgencyStrategy() {}
-  virtual TrafficState mostUrgentAircraft(Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T) = 0;
+  virtual TrafficState mostUrgentAircraft(const Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T) = 0;
   virtual UrgencyStrategy* copy() const = 0;
 };
 
@@ -13,7 +13,9 @@
 #include "WCVTable.h"
 #include "WCV_tvar.h"
 #include "LossData.h"
+#include "ConflictData.h"
 #include <string>
+#include <vector>
 
 namespace larcfm {
 class WCV_TAUMOD : public WCV_tvar {
@@ -33,6 +35,19 @@ public:
 
   LossData horizontal_WCV_interval(double T, const Vect2& s, const Vect2& v) const ;
 
+  /**
+   * Fused detection of one pair of aircraft against several WCV_TAUMOD detectors, e.g., the
+   * alert levels of an alertor, in a single pass. Quantities that don't depend on the
+   * thresholds, i.e., relative state, dot products, and discriminant terms, are computed once.
+   * On return, conflicts[k] and violations[k] are the same as
+   * dets[k]->conflictDetection(so,vo,si,vi,B,T[k]) and dets[k]->violation(so,vo,si,vi).
+   * Requires: dets.size() == T.size()
+   */
+  static void conflictDetectionLevels(const std::vector<const WCV_TAUMOD*>& dets,
+      const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi,
+      double B, const std::vector<double>& T,
+      std::vector<ConflictData>& conflicts, std::vector<bool>& violations);
+
   Detection3D* make() const;
 
   /**
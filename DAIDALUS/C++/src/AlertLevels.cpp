@@ -24,7 +24,7 @@ AlertLevels::AlertLevels() {
 }
 
 AlertLevels::AlertLevels(const AlertLevels& alertor) {
-  alertor_ = std::vector<AlertThresholds>();
+  conflict_level_ = 0;
   copy(alertor);
 }
 
@@ -222,7 +222,7 @@ int AlertLevels::conflictAlertLevel() const {
 /**
  * @return detector for given alert level
  */
-Detection3D* AlertLevels::detectorRef(int alert_level) const {
+const Detection3D* AlertLevels::detectorRef(int alert_level) const {
   if (alert_level == 0) {
     alert_level = conflictAlertLevel();
   }
@@ -236,7 +236,7 @@ Detection3D* AlertLevels::detectorRef(int alert_level) const {
 /**
  * @return detector for conflict alert level
  */
-Detection3D* AlertLevels::conflictDetectorRef() const {
+const Detection3D* AlertLevels::conflictDetectorRef() const {
   return detectorRef(0);
 }
 
@@ -281,11 +281,12 @@ AlertThresholds const & AlertLevels::getLevel(int level) const {
  * Set alertor to the same values as the given parameter
  */
 void AlertLevels::copy(const AlertLevels& alertor) {
-  alertor_.clear();
-  conflict_level_ = alertor.conflict_level_;
-  for (int i=1; i <= alertor.mostSevereAlertLevel(); ++i) {
-    alertor_.push_back(AlertThresholds(alertor.getLevel(i)));
+  if (this == &alertor) {
+    return;
   }
+  conflict_level_ = alertor.conflict_level_;
+  // Detectors are shared by the copies of the alert thresholds
+  alertor_ = alertor.alertor_;
 }
 
 ParameterData AlertLevels::getParameters() const {
@@ -298,11 +299,12 @@ ParameterData AlertLevels::getParameters() const {
 void AlertLevels::updateParameterData(ParameterData& p) const {
   Detection3DParameterReader::registerDefaults();
   p.setInt("conflict_level",conflict_level_);
-  // get list of detectors that are in the alerts
+  // get list of detectors that are in the alerts. Detectors are shared by the copies of the
+  // alert thresholds, so identifiers are set on copies of them.
   std::vector<Detection3D*> dlist;
   std::vector<std::string> idlist;
   for (nat i = 0; i < alertor_.size(); i++) {
-    Detection3D* det = alertor_[i].getDetectorRef();
+    Detection3D* det = alertor_[i].getDetectorRef()->copy();
     det->setIdentifier("det_"+Fmi(i+1));
     dlist.push_back(det);
     idlist.push_back(det->getIdentifier()+"_id");
@@ -319,11 +321,18 @@ void AlertLevels::updateParameterData(ParameterData& p) const {
   for (int i = 1; i <= mostSevereAlertLevel(); i++) {
     ParameterData pd;
     getLevel(i).updateParameterData(pd);
+    // the shared detector keeps its identifier, refer to the identifier of its copy instead
+    pd.remove("detector");
+    pd.set("detector",dlist[i-1]->getIdentifier());
     //make sure each instance has a unique, ordered name
     std::string prefix = "alert_"+Fmi(i)+"_";
     pdmain.copy(pd.copyWithPrefix(prefix), true);
   }
-  p.copy(pdmain, true);}
+  for (nat i = 0; i < dlist.size(); i++) {
+    delete dlist[i];
+  }
+  p.copy(pdmain, true);
+}
 
 void AlertLevels::setParameters(const ParameterData& p) {
   Detection3DParameterReader::registerDefaults();
@@ -13,9 +13,13 @@
 #include "KinematicMultiBands.h"
 #include "format.h"
 #include "KinematicBandsParameters.h" // REMOVE ME!  Circular reference!
+#include "DetectionKernel.h"
 
 namespace larcfm {
 
+static const char* const units_keys[] = {"alerting_time","early_alerting_time",
+    "spread_trk","spread_gs","spread_vs","spread_alt"};
+
 /**
  * Creates an alert threholds object. Parameter det is a detector,
  * alerting_time is a non-negative alerting time (possibly positive infinity),
@@ -25,7 +29,7 @@ namespace larcfm {
 AlertThresholds::AlertThresholds(const Detection3D* detector,
     double alerting_time, double early_alerting_time,
     BandsRegion::Region region) {
-  detector_ = detector == NULL ? NULL :detector->copy();
+  set_detector(detector);
   alerting_time_ = std::abs(alerting_time);
   early_alerting_time_ = Util::max(alerting_time_,early_alerting_time);
   region_ = region;
@@ -33,16 +37,16 @@ AlertThresholds::AlertThresholds(const Detection3D* detector,
   spread_gs_ = 0;
   spread_vs_ = 0;
   spread_alt_ = 0;
-  units_["alerting_time"] = "s";
-  units_["early_alerting_time"] = "s";
-  units_["spread_trk"] = "deg";
-  units_["spread_gs"] = "knot";
-  units_["spread_vs"] = "fpm";
-  units_["spread_alt"] = "ft";
+  units_[ALERTING_TIME] = "s";
+  units_[EARLY_ALERTING_TIME] = "s";
+  units_[SPREAD_TRK] = "deg";
+  units_[SPREAD_GS] = "knot";
+  units_[SPREAD_VS] = "fpm";
+  units_[SPREAD_ALT] = "ft";
 }
 
 AlertThresholds::AlertThresholds(const AlertThresholds& athr) {
-  detector_ = athr.isValid() ? athr.detector_->copy() : NULL;
+  set_detector(athr);
   alerting_time_ = athr.alerting_time_;
   early_alerting_time_ = athr.early_alerting_time_;
   region_ = athr.region_;
@@ -50,11 +54,14 @@ AlertThresholds::AlertThresholds(const AlertThresholds& athr) {
   spread_gs_ = athr.spread_gs_;
   spread_vs_ = athr.spread_vs_;
   spread_alt_ = athr.spread_alt_;
-  units_ = athr.units_;
+  for (int i = 0; i < UNITS; ++i) {
+    units_[i] = athr.units_[i];
+  }
 }
 
 AlertThresholds::AlertThresholds() {
   detector_ = NULL;
+  detector_refs_ = NULL;
   alerting_time_ = 0;
   early_alerting_time_ = 0;
   region_ = BandsRegion::UNKNOWN;
@@ -62,12 +69,12 @@ AlertThresholds::AlertThresholds() {
   spread_gs_ = 0;
   spread_vs_ = 0;
   spread_alt_ = 0;
-  units_["alerting_time"] = "s";
-  units_["early_alerting_time"] = "s";
-  units_["spread_trk"] = "deg";
-  units_["spread_gs"] = "m/s";
-  units_["spread_vs"] = "m/s";
-  units_["spread_alt"] = "m";
+  units_[ALERTING_TIME] = "s";
+  units_[EARLY_ALERTING_TIME] = "s";
+  units_[SPREAD_TRK] = "deg";
+  units_[SPREAD_GS] = "m/s";
+  units_[SPREAD_VS] = "m/s";
+  units_[SPREAD_ALT] = "m";
 }
 
 const AlertThresholds AlertThresholds::INVALID = AlertThresholds();
@@ -77,12 +84,15 @@ bool AlertThresholds::isValid() const {
 }
 
 AlertThresholds::~AlertThresholds() {
-  delete detector_;
+  release_detector();
 }
 
 AlertThresholds& AlertThresholds::operator=(const AlertThresholds& athr) {
-  delete detector_;
-  detector_ = athr.isValid() ? athr.detector_->copy() : NULL;
+  if (this == &athr) {
+    return *this;
+  }
+  release_detector();
+  set_detector(athr);
   alerting_time_ = athr.alerting_time_;
   early_alerting_time_ = athr.early_alerting_time_;
   region_ = athr.region_;
@@ -90,14 +100,59 @@ AlertThresholds& AlertThresholds::operator=(const AlertThresholds& athr) {
   spread_gs_ = athr.spread_gs_;
   spread_vs_ = athr.spread_vs_;
   spread_alt_ = athr.spread_alt_;
-  units_ = athr.units_;
+  for (int i = 0; i < UNITS; ++i) {
+    units_[i] = athr.units_[i];
+  }
   return *this;
 }
 
+/**
+ * Share the detector of athr, if athr is valid. Requires: this object doesn't hold a detector.
+ */
+void AlertThresholds::set_detector(const AlertThresholds& athr) {
+  if (athr.isValid()) {
+    detector_ = athr.detector_;
+    detector_refs_ = athr.detector_refs_;
+    detector_refs_->fetch_add(1,std::memory_order_relaxed);
+  } else {
+    detector_ = NULL;
+    detector_refs_ = NULL;
+  }
+}
+
+/**
+ * Hold a copy of det. Its kernel kind is bound here, since the copy is shared without further
+ * modifications. Requires: this object doesn't hold a detector.
+ */
+void AlertThresholds::set_detector(const Detection3D* det) {
+  if (det != NULL) {
+    Detection3D* copy = det->copy();
+    DetectionKernel::bind(copy);
+    detector_ = copy;
+    detector_refs_ = new std::atomic<int>(1);
+  } else {
+    detector_ = NULL;
+    detector_refs_ = NULL;
+  }
+}
+
+/**
+ * Stop sharing the detector, deleting it if this is the last object holding it.
+ */
+void AlertThresholds::release_detector() {
+  // The last release must see every use of the detector by the other holders before deleting it
+  if (detector_refs_ != NULL && detector_refs_->fetch_sub(1,std::memory_order_acq_rel) == 1) {
+    delete detector_;
+    delete detector_refs_;
+  }
+  detector_ = NULL;
+  detector_refs_ = NULL;
+}
+
 /**
  * Return detector.
  */
-Detection3D* AlertThresholds::getDetectorRef() const {
+const Detection3D* AlertThresholds::getDetectorRef() const {
   return detector_;
 }
 
@@ -105,8 +160,8 @@ Detection3D* AlertThresholds::getDetectorRef() const {
  * Set detector.
  */
 void AlertThresholds::setDetector(const Detection3D* det) {
-  delete detector_;
-  detector_ = det != NULL ? det->copy() : NULL;
+  release_detector();
+  set_detector(det);
 }
 
 /**
@@ -135,7 +190,7 @@ void AlertThresholds::setAlertingTime(double val) {
  */
 void AlertThresholds::setAlertingTime(double t, const std::string& u) {
   setAlertingTime(Units::from(u,t));
-  units_["alerting_time"] = u;
+  units_[ALERTING_TIME] = u;
 }
 
 /**
@@ -164,7 +219,7 @@ void AlertThresholds::setEarlyAlertingTime(double t) {
  */
 void AlertThresholds::setEarlyAlertingTime(double t, const std::string& u) {
   setEarlyAlertingTime(Units::from(u,t));
-  units_["early_alerting_time"] = u;
+  units_[EARLY_ALERTING_TIME] = u;
 }
 
 /**
@@ -209,7 +264,7 @@ void AlertThresholds::setTrackSpread(double spread) {
  */
 void AlertThresholds::setTrackSpread(double spread, const std::string& u) {
   setTrackSpread(Units::from(u,spread));
-  units_["spread_trk"] = u;
+  units_[SPREAD_TRK] = u;
 }
 
 /**
@@ -240,7 +295,7 @@ void AlertThresholds::setGroundSpeedSpread(double spread) {
  */
 void AlertThresholds::setGroundSpeedSpread(double spread, const std::string& u) {
   setGroundSpeedSpread(Units::from(u,spread));
-  units_["spread_gs"] = u;
+  units_[SPREAD_GS] = u;
 }
 
 /**
@@ -271,7 +326,7 @@ void AlertThresholds::setVerticalSpeedSpread(double spread) {
  */
 void AlertThresholds::setVerticalSpeedSpread(double spread, const std::string& u) {
   setVerticalSpeedSpread(Units::from(u,spread));
-  units_["spread_vs"] = u;
+  units_[SPREAD_VS] = u;
 }
 
 /**
@@ -302,18 +357,18 @@ void AlertThresholds::setAltitudeSpread(double spread) {
  */
 void AlertThresholds::setAltitudeSpread(double spread, const std::string& u) {
   setAltitudeSpread(Units::from(u,spread));
-  units_["spread_alt"] = u;
+  units_[SPREAD_ALT] = u;
 }
 
 std::string AlertThresholds::toString() const {
   return  (detector_ == NULL ? "INVALID_DETECTOR" : detector_->toString())+
-      ", alerting_time = "+Units::str(getUnits("alerting_time"),alerting_time_)+
-      ", early_alerting_time = "+Units::str(getUnits("early_alerting_time"),early_alerting_time_)+
+      ", alerting_time = "+Units::str(units_[ALERTING_TIME],alerting_time_)+
+      ", early_alerting_time = "+Units::str(units_[EARLY_ALERTING_TIME],early_alerting_time_)+
       ", region = "+BandsRegion::to_string(region_)+
-      ", spread_trk = "+Units::str(getUnits("spread_trk"),spread_trk_)+
-      ", spread_gs = "+Units::str(getUnits("spread_gs"),spread_gs_)+
-      ", spread_vs = "+Units::str(getUnits("spread_vs"),spread_vs_)+
-      ", spread_alt = "+Units::str(getUnits("spread_alt"),spread_alt_);
+      ", spread_trk = "+Units::str(units_[SPREAD_TRK],spread_trk_)+
+      ", spread_gs = "+Units::str(units_[SPREAD_GS],spread_gs_)+
+      ", spread_vs = "+Units::str(units_[SPREAD_VS],spread_vs_)+
+      ", spread_alt = "+Units::str(units_[SPREAD_ALT],spread_alt_);
 }
 
 std::string AlertThresholds:: toPVS(int prec) const {
@@ -339,12 +394,12 @@ void AlertThresholds::updateParameterData(ParameterData& p) const {
   if (detector_ != NULL) {
     p.set("detector",detector_->getIdentifier());
   }
-  p.setInternal("alerting_time",alerting_time_,getUnits("alerting_time"));
-  p.setInternal("early_alerting_time",early_alerting_time_,getUnits("early_alerting_time"));
-  p.setInternal("spread_trk",spread_trk_,getUnits("spread_trk"));
-  p.setInternal("spread_gs",spread_gs_,getUnits("spread_gs"));
-  p.setInternal("spread_vs",spread_vs_,getUnits("spread_vs"));
-  p.setInternal("spread_alt",spread_alt_,getUnits("spread_alt"));
+  p.setInternal("alerting_time",alerting_time_,units_[ALERTING_TIME]);
+  p.setInternal("early_alerting_time",early_alerting_time_,units_[EARLY_ALERTING_TIME]);
+  p.setInternal("spread_trk",spread_trk_,units_[SPREAD_TRK]);
+  p.setInternal("spread_gs",spread_gs_,units_[SPREAD_GS]);
+  p.setInternal("spread_vs",spread_vs_,units_[SPREAD_VS]);
+  p.setInternal("spread_alt",spread_alt_,units_[SPREAD_ALT]);
 }
 
 void AlertThresholds::setParameters(const ParameterData& p) {
@@ -353,36 +408,37 @@ void AlertThresholds::setParameters(const ParameterData& p) {
   }
   if (p.contains("alerting_time")) {
     setAlertingTime(p.getValue("alerting_time"));
-    units_["alerting_time"] = p.getUnit("alerting_time");
+    units_[ALERTING_TIME] = p.getUnit("alerting_time");
   }
   if (p.contains("early_alerting_time")) {
     setEarlyAlertingTime(p.getValue("early_alerting_time"));
-    units_["early_alerting_time"] = p.getUnit("early_alerting_time");
+    units_[EARLY_ALERTING_TIME] = p.getUnit("early_alerting_time");
   }
   if (p.contains("spread_trk")) {
     setTrackSpread(p.getValue("spread_trk"));
-    units_["spread_trk"] = p.getUnit("spread_trk");
+    units_[SPREAD_TRK] = p.getUnit("spread_trk");
   }
   if (p.contains("spread_gs")) {
     setGroundSpeedSpread(p.getValue("spread_gs"));
-    units_["spread_gs"] = p.getUnit("spread_gs");
+    units_[SPREAD_GS] = p.getUnit("spread_gs");
   }
   if (p.contains("spread_vs")) {
     setVerticalSpeedSpread(p.getValue("spread_vs"));
-    units_["spread_vs"] = p.getUnit("spread_vs");
+    units_[SPREAD_VS] = p.getUnit("spread_vs");
   }
   if (p.contains("spread_alt")) {
     setAltitudeSpread(p.getValue("spread_alt"));
-    units_["spread_alt"] = p.getUnit("spread_alt");
+    units_[SPREAD_ALT] = p.getUnit("spread_alt");
   }
 }
 
 std::string AlertThresholds::getUnits(const std::string& key) const {
-  std::map<std::string,std::string>::const_iterator got = units_.find(key);
-  if (got == units_.end()) {
-    return "unspecified";
+  for (int i = 0; i < UNITS; ++i) {
+    if (key == units_keys[i]) {
+      return units_[i];
+    }
   }
-  return got->second;
+  return "unspecified";
 }
 
 }
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "BandsDeadline.h"
+#include "Util.h"
+#include <chrono>
+
+namespace larcfm {
+
+BandsDeadline::BandsDeadline() : never_(true), end_(0) {}
+
+BandsDeadline::BandsDeadline(double budget) : never_(false), end_(now_ns()) {
+  if (budget >= 1e9) {
+    // More than 30 years is the same as no deadline
+    never_ = true;
+  } else if (budget > 0) {
+    end_ += (long long)(budget*1e9);
+  }
+}
+
+bool BandsDeadline::expired() const {
+  return !never_ && now_ns() >= end_;
+}
+
+double BandsDeadline::remaining() const {
+  if (never_) {
+    return PINFINITY;
+  }
+  return Util::max(0.0,(end_-now_ns())*1e-9);
+}
+
+long long BandsDeadline::now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "BandsReader.h"
+#include "Position.h"
+#include "Velocity.h"
+#include <cstring>
+
+namespace larcfm {
+
+static std::string to_string(const char* s, int size) {
+  return std::string(s,strnlen(s,size));
+}
+
+BandsReader::BandsReader() : file_(NULL), error("BandsReader") {
+  std::memset(&header_,0,sizeof(BandsFileHeader));
+  for (int d = 0; d < BANDS_DIMENSIONS; ++d) {
+    offset_[d] = 0;
+  }
+}
+
+BandsReader::~BandsReader() {
+  close();
+}
+
+bool BandsReader::open(const std::string& filename) {
+  close();
+  file_ = filename == "-" ? stdin : fopen(filename.c_str(),"rb");
+  if (file_ == NULL) {
+    error.addError("File "+filename+" cannot be read");
+    return false;
+  }
+  if (fread(&header_,sizeof(BandsFileHeader),1,file_) != 1 || header_.magic != BANDS_FILE_MAGIC) {
+    error.addError("File "+filename+" is not a bands file");
+    close();
+    return false;
+  }
+  if (header_.version != BANDS_FILE_VERSION) {
+    error.addError("File "+filename+" has an unsupported version");
+    close();
+    return false;
+  }
+  return true;
+}
+
+void BandsReader::close() {
+  if (file_ != NULL && file_ != stdin) {
+    fclose(file_);
+  }
+  file_ = NULL;
+  payload_.clear();
+  text_ = "";
+}
+
+const BandsFileHeader& BandsReader::header() const {
+  return header_;
+}
+
+std::string BandsReader::units(BandsDimension dim) const {
+  return to_string(header_.units[dim],BANDS_UNITS_SIZE);
+}
+
+int BandsReader::next() {
+  if (file_ == NULL) {
+    return 0;
+  }
+  BandsRecordHeader rec;
+  if (fread(&rec,sizeof(BandsRecordHeader),1,file_) != 1) {
+    return 0;
+  }
+  payload_.resize(rec.size+1);
+  if (rec.size > 0 && fread(&payload_[0],rec.size,1,file_) != 1) {
+    error.addError("Truncated record");
+    return 0;
+  }
+  switch (rec.kind) {
+  case BandsRecordHeader::TEXT:
+  case BandsRecordHeader::INPUT_FILE:
+    text_ = std::string(&payload_[0],rec.size);
+    return rec.kind;
+  case BandsRecordHeader::STEP: {
+    if (rec.size < sizeof(BandsStepRecord)) {
+      error.addError("Invalid step record");
+      return 0;
+    }
+    int n = sizeof(BandsStepRecord)+(step().traffic+1)*sizeof(BandsAircraftRecord);
+    for (int d = 0; d < BANDS_DIMENSIONS; ++d) {
+      offset_[d] = d == 0 ? 0 : offset_[d-1]+step().dims[d-1].ranges;
+    }
+    n += (offset_[BANDS_ALT]+step().dims[BANDS_ALT].ranges)*sizeof(BandsRangeRecord);
+    if (n != (int)rec.size) {
+      error.addError("Invalid step record");
+      return 0;
+    }
+    return rec.kind;
+  }
+  default:
+    // Unknown records are skipped
+    return next();
+  }
+}
+
+const std::string& BandsReader::text() const {
+  return text_;
+}
+
+const BandsStepRecord& BandsReader::step() const {
+  return *(const BandsStepRecord*)&payload_[0];
+}
+
+int BandsReader::trafficSize() const {
+  return step().traffic;
+}
+
+const BandsAircraftRecord& BandsReader::aircraft(int ac) const {
+  return ((const BandsAircraftRecord*)(&payload_[0]+sizeof(BandsStepRecord)))[ac];
+}
+
+TrafficState BandsReader::aircraftState(int ac) const {
+  const BandsAircraftRecord& rec = aircraft(ac);
+  Position pos = rec.flags & BandsAircraftRecord::LATLON ? Position::mkLatLonAlt(rec.x,rec.y,rec.z) :
+      Position::mkXYZ(rec.x,rec.y,rec.z);
+  return TrafficState::makeOwnship(aircraftId(ac),pos,Velocity::mkVxyz(rec.vx,rec.vy,rec.vz),rec.time);
+}
+
+std::string BandsReader::aircraftId(int ac) const {
+  return to_string(aircraft(ac).id,BANDS_ID_SIZE);
+}
+
+int BandsReader::length(BandsDimension dim) const {
+  return step().dims[dim].ranges;
+}
+
+const BandsRangeRecord& BandsReader::range(BandsDimension dim, int i) const {
+  const BandsRangeRecord* ranges = (const BandsRangeRecord*)(&payload_[0]+sizeof(BandsStepRecord)+
+      (step().traffic+1)*sizeof(BandsAircraftRecord));
+  return ranges[offset_[dim]+i];
+}
+
+Interval BandsReader::interval(BandsDimension dim, int i) const {
+  return Interval(range(dim,i).low,range(dim,i).up);
+}
+
+BandsRegion::Region BandsReader::region(BandsDimension dim, int i) const {
+  return (BandsRegion::Region)range(dim,i).region;
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "BandsStats.h"
+#include "format.h"
+#ifdef DAIDALUS_STATS_
+#include <chrono>
+#endif
+
+namespace larcfm {
+
+BandsStats::BandsStats() {
+  clear();
+}
+
+bool BandsStats::isEnabled() {
+#ifdef DAIDALUS_STATS_
+  return true;
+#else
+  return false;
+#endif
+}
+
+void BandsStats::clear() {
+  detector_calls = 0;
+  trajectory_samples = 0;
+  none_bands_calls = 0;
+  core_update_time = 0;
+  peripheral_time = 0;
+  compute_level_time = 0;
+  recovery_time = 0;
+  resolution_time = 0;
+}
+
+void BandsStats::add(const BandsStats& stats) {
+  detector_calls += stats.detector_calls;
+  trajectory_samples += stats.trajectory_samples;
+  none_bands_calls += stats.none_bands_calls;
+  core_update_time += stats.core_update_time;
+  peripheral_time += stats.peripheral_time;
+  compute_level_time += stats.compute_level_time;
+  recovery_time += stats.recovery_time;
+  resolution_time += stats.resolution_time;
+}
+
+std::string BandsStats::toString() const {
+  std::string s = "";
+  s+="detector_calls = "+Fmul(detector_calls)+"\n";
+  s+="trajectory_samples = "+Fmul(trajectory_samples)+"\n";
+  s+="none_bands_calls = "+Fmul(none_bands_calls)+"\n";
+  s+="core_update_time = "+Fm6(core_update_time)+" [s]\n";
+  s+="peripheral_time = "+Fm6(peripheral_time)+" [s]\n";
+  s+="compute_level_time = "+Fm6(compute_level_time)+" [s]\n";
+  s+="recovery_time = "+Fm6(recovery_time)+" [s]\n";
+  s+="resolution_time = "+Fm6(resolution_time)+" [s]\n";
+  return s;
+}
+
+#ifdef DAIDALUS_STATS_
+
+static long long stats_clock_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+BandsStopwatch::BandsStopwatch(double* time) : time_(time), start_(time != NULL ? stats_clock_ns() : 0) {}
+
+BandsStopwatch::~BandsStopwatch() {
+  if (time_ != NULL) {
+    *time_ += (stats_clock_ns()-start_)*1e-9;
+  }
+}
+
+#else
+
+BandsStopwatch::BandsStopwatch(double* time) : time_(time), start_(0) {}
+
+BandsStopwatch::~BandsStopwatch() {}
+
+#endif
+
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "BandsWriter.h"
+#include "format.h"
+#include <cstring>
+
+namespace larcfm {
+
+const int BandsWriter::BUFFER_SIZE;
+
+static void copy_string(char* dst, const std::string& src, int size) {
+  std::strncpy(dst,src.c_str(),size-1);
+  dst[size-1] = '\0';
+}
+
+BandsWriter::BandsWriter() : file_(NULL), size_(0), most_severe_alert_level_(0), error("BandsWriter") {}
+
+BandsWriter::~BandsWriter() {
+  close();
+}
+
+bool BandsWriter::open(const std::string& filename, const KinematicBandsParameters& parameters) {
+  close();
+  file_ = filename == "-" ? stdout : fopen(filename.c_str(),"wb");
+  if (file_ == NULL) {
+    error.addError("File "+filename+" cannot be written");
+    return false;
+  }
+  most_severe_alert_level_ = parameters.alertor.mostSevereAlertLevel();
+  if (most_severe_alert_level_ > BANDS_MAX_LEVELS) {
+    error.addWarning("Only the first "+Fmi(BANDS_MAX_LEVELS)+" alert levels are written");
+  }
+  buffer_.resize(BUFFER_SIZE);
+  size_ = 0;
+  BandsFileHeader header;
+  std::memset(&header,0,sizeof(BandsFileHeader));
+  header.magic = BANDS_FILE_MAGIC;
+  header.version = BANDS_FILE_VERSION;
+  copy_string(header.units[BANDS_TRK],parameters.getUnits("trk_step"),BANDS_UNITS_SIZE);
+  copy_string(header.units[BANDS_GS],parameters.getUnits("gs_step"),BANDS_UNITS_SIZE);
+  copy_string(header.units[BANDS_VS],parameters.getUnits("vs_step"),BANDS_UNITS_SIZE);
+  copy_string(header.units[BANDS_ALT],parameters.getUnits("alt_step"),BANDS_UNITS_SIZE);
+  header.most_severe_alert_level = most_severe_alert_level_;
+  header.min[BANDS_GS] = parameters.getMinGroundSpeed();
+  header.max[BANDS_GS] = parameters.getMaxGroundSpeed();
+  header.min[BANDS_VS] = parameters.getMinVerticalSpeed();
+  header.max[BANDS_VS] = parameters.getMaxVerticalSpeed();
+  header.min[BANDS_ALT] = parameters.getMinAltitude();
+  header.max[BANDS_ALT] = parameters.getMaxAltitude();
+  std::memcpy(&buffer_[0],&header,sizeof(BandsFileHeader));
+  size_ = sizeof(BandsFileHeader);
+  return true;
+}
+
+bool BandsWriter::isOpen() const {
+  return file_ != NULL;
+}
+
+/*
+ * Reserve a record of given kind with a payload of size bytes at the end of the buffer, and return
+ * the payload. The buffer is written to the file first if the record doesn't fit.
+ */
+char* BandsWriter::append(BandsRecordHeader::Kind kind, int size) {
+  int total = sizeof(BandsRecordHeader)+size;
+  if (size_+total > (int)buffer_.size()) {
+    flush();
+    if (total > (int)buffer_.size()) {
+      buffer_.resize(total);
+    }
+  }
+  BandsRecordHeader* header = (BandsRecordHeader*)&buffer_[size_];
+  header->kind = kind;
+  header->size = size;
+  char* payload = &buffer_[size_+sizeof(BandsRecordHeader)];
+  size_ += total;
+  return payload;
+}
+
+void BandsWriter::writeString(BandsRecordHeader::Kind kind, const std::string& s) {
+  if (file_ == NULL) {
+    return;
+  }
+  char* payload = append(kind,s.size());
+  std::memcpy(payload,s.data(),s.size());
+}
+
+void BandsWriter::writeText(const std::string& text) {
+  writeString(BandsRecordHeader::TEXT,text);
+}
+
+void BandsWriter::writeFile(const std::string& filename) {
+  writeString(BandsRecordHeader::INPUT_FILE,filename);
+}
+
+void BandsWriter::setAircraft(BandsAircraftRecord& rec, const TrafficState& ac) {
+  copy_string(rec.id,ac.getId(),BANDS_ID_SIZE);
+  const Position& pos = ac.getPosition();
+  if (pos.isLatLon()) {
+    rec.flags |= BandsAircraftRecord::LATLON;
+    rec.x = pos.lat();
+    rec.y = pos.lon();
+  } else {
+    rec.x = pos.x();
+    rec.y = pos.y();
+  }
+  rec.z = pos.alt();
+  rec.vx = ac.getVelocity().x;
+  rec.vy = ac.getVelocity().y;
+  rec.vz = ac.getVelocity().z;
+  rec.time = ac.getTime();
+}
+
+// Set bit level-1 of the conflict mask, if dim is negative, or of the peripheral mask of dim, of the
+// records of the aircraft in acs. Lists of aircraft usually follow the order of traffic.
+static void set_levels(BandsAircraftRecord* recs, const std::vector<TrafficState>& traffic,
+    const std::vector<TrafficState>& acs, int level, int dim) {
+  TrafficState::nat i = 0;
+  for (TrafficState::nat j = 0; j < acs.size(); ++j) {
+    TrafficState::nat k = 0;
+    for (; k < traffic.size() && traffic[i].getId() != acs[j].getId(); ++k) {
+      i = (i+1) % traffic.size();
+    }
+    if (k == traffic.size()) {
+      continue;
+    }
+    uint32_t& mask = dim < 0 ? recs[i].conflict_levels : recs[i].peripheral_levels[dim];
+    mask |= 1u << (level-1);
+  }
+}
+
+void BandsWriter::write(Daidalus& daa, KinematicMultiBands& kb) {
+  if (file_ == NULL) {
+    return;
+  }
+  KinematicBandsCore& core = kb.core_;
+  int traffic = core.traffic.size();
+  int ranges[BANDS_DIMENSIONS] = { kb.trackLength(), kb.groundSpeedLength(), kb.verticalSpeedLength(), kb.altitudeLength() };
+  int nranges = 0;
+  for (int d = 0; d < BANDS_DIMENSIONS; ++d) {
+    ranges[d] = ranges[d] < 0 ? 0 : ranges[d];
+    nranges += ranges[d];
+  }
+  int size = sizeof(BandsStepRecord)+(traffic+1)*sizeof(BandsAircraftRecord)+nranges*sizeof(BandsRangeRecord);
+  char* payload = append(BandsRecordHeader::STEP,size);
+  std::memset(payload,0,size);
+  BandsStepRecord* step = (BandsStepRecord*)payload;
+  BandsAircraftRecord* acs = (BandsAircraftRecord*)(payload+sizeof(BandsStepRecord));
+  BandsRangeRecord* rng = (BandsRangeRecord*)(acs+traffic+1);
+
+  step->time = core.ownship.getTime();
+  step->flags = (core.parameters.isEnabledConflictCriteria() ? BandsStepRecord::CONFLICT_CRITERIA : 0) |
+      (core.parameters.isEnabledRecoveryCriteria() ? BandsStepRecord::RECOVERY_CRITERIA : 0);
+  step->traffic = traffic;
+  step->epsilon_h = core.epsilonH();
+  step->epsilon_v = core.epsilonV();
+  copy_string(step->most_urgent,core.most_urgent_ac.getId(),BANDS_ID_SIZE);
+
+  BandsDimensionRecord* dim = step->dims;
+  dim[BANDS_TRK].ownship = core.ownship.track();
+  dim[BANDS_TRK].region = kb.regionOfTrack(dim[BANDS_TRK].ownship);
+  dim[BANDS_TRK].resolution_up = kb.trackResolution(true);
+  dim[BANDS_TRK].resolution_down = kb.trackResolution(false);
+  dim[BANDS_TRK].preferred_up = kb.preferredTrackDirection();
+  dim[BANDS_TRK].recovery_time = kb.timeToTrackRecovery();
+  dim[BANDS_GS].ownship = core.ownship.groundSpeed();
+  dim[BANDS_GS].region = kb.regionOfGroundSpeed(dim[BANDS_GS].ownship);
+  dim[BANDS_GS].resolution_up = kb.groundSpeedResolution(true);
+  dim[BANDS_GS].resolution_down = kb.groundSpeedResolution(false);
+  dim[BANDS_GS].preferred_up = kb.preferredGroundSpeedDirection();
+  dim[BANDS_GS].recovery_time = kb.timeToGroundSpeedRecovery();
+  dim[BANDS_VS].ownship = core.ownship.verticalSpeed();
+  dim[BANDS_VS].region = kb.regionOfVerticalSpeed(dim[BANDS_VS].ownship);
+  dim[BANDS_VS].resolution_up = kb.verticalSpeedResolution(true);
+  dim[BANDS_VS].resolution_down = kb.verticalSpeedResolution(false);
+  dim[BANDS_VS].preferred_up = kb.preferredVerticalSpeedDirection();
+  dim[BANDS_VS].recovery_time = kb.timeToVerticalSpeedRecovery();
+  dim[BANDS_ALT].ownship = core.ownship.altitude();
+  dim[BANDS_ALT].region = kb.regionOfAltitude(dim[BANDS_ALT].ownship);
+  dim[BANDS_ALT].resolution_up = kb.altitudeResolution(true);
+  dim[BANDS_ALT].resolution_down = kb.altitudeResolution(false);
+  dim[BANDS_ALT].preferred_up = kb.preferredAltitudeDirection();
+  dim[BANDS_ALT].recovery_time = kb.timeToAltitudeRecovery();
+
+  int r = 0;
+  for (int i = 0; i < ranges[BANDS_TRK]; ++i, ++r) {
+    rng[r].low = kb.track(i).low;
+    rng[r].up = kb.track(i).up;
+    rng[r].region = kb.trackRegion(i);
+  }
+  for (int i = 0; i < ranges[BANDS_GS]; ++i, ++r) {
+    rng[r].low = kb.groundSpeed(i).low;
+    rng[r].up = kb.groundSpeed(i).up;
+    rng[r].region = kb.groundSpeedRegion(i);
+  }
+  for (int i = 0; i < ranges[BANDS_VS]; ++i, ++r) {
+    rng[r].low = kb.verticalSpeed(i).low;
+    rng[r].up = kb.verticalSpeed(i).up;
+    rng[r].region = kb.verticalSpeedRegion(i);
+  }
+  for (int i = 0; i < ranges[BANDS_ALT]; ++i, ++r) {
+    rng[r].low = kb.altitude(i).low;
+    rng[r].up = kb.altitude(i).up;
+    rng[r].region = kb.altitudeRegion(i);
+  }
+  for (int d = 0; d < BANDS_DIMENSIONS; ++d) {
+    dim[d].ranges = ranges[d];
+  }
+
+  setAircraft(acs[0],core.ownship);
+  daa.alertingAll(alerts_,detections_,times_to_violation_,0,0,0);
+  for (int i = 0; i < traffic; ++i) {
+    const TrafficState& ac = core.traffic[i];
+    BandsAircraftRecord& rec = acs[i+1];
+    setAircraft(rec,ac);
+    rec.alert = alerts_[i];
+    const ConflictData& conf = detections_[i];
+    if (conf.conflict()) {
+      rec.flags |= BandsAircraftRecord::CONFLICT;
+    }
+    rec.time_in = conf.getTimeIn();
+    rec.time_out = conf.getTimeOut();
+    rec.last_time[BANDS_TRK] = kb.lastTimeToTrackManeuver(ac);
+    rec.last_time[BANDS_GS] = kb.lastTimeToGroundSpeedManeuver(ac);
+    rec.last_time[BANDS_VS] = kb.lastTimeToVerticalSpeedManeuver(ac);
+    rec.last_time[BANDS_ALT] = kb.lastTimeToAltitudeManeuver(ac);
+  }
+  int levels = Util::min(most_severe_alert_level_,BANDS_MAX_LEVELS);
+  for (int level = 1; level <= levels; ++level) {
+    set_levels(acs+1,core.traffic,kb.conflictAircraft(level),level,-1);
+    set_levels(acs+1,core.traffic,kb.peripheralTrackAircraft(level),level,BANDS_TRK);
+    set_levels(acs+1,core.traffic,kb.peripheralGroundSpeedAircraft(level),level,BANDS_GS);
+    set_levels(acs+1,core.traffic,kb.peripheralVerticalSpeedAircraft(level),level,BANDS_VS);
+    set_levels(acs+1,core.traffic,kb.peripheralAltitudeAircraft(level),level,BANDS_ALT);
+  }
+}
+
+bool BandsWriter::flush() {
+  if (file_ == NULL) {
+    return false;
+  }
+  if (size_ > 0 && fwrite(&buffer_[0],1,size_,file_) != (size_t)size_) {
+    error.addError("Results cannot be written");
+    size_ = 0;
+    return false;
+  }
+  size_ = 0;
+  fflush(file_);
+  return true;
+}
+
+void BandsWriter::close() {
+  if (file_ != NULL) {
+    flush();
+    if (file_ != stdout) {
+      fclose(file_);
+    }
+  }
+  file_ = NULL;
+  buffer_.clear();
+  size_ = 0;
+}
+
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "ContourSet.h"
+#include "format.h"
+
+namespace larcfm {
+
+ContourSet::ContourSet() {
+  start_.push_back(0);
+}
+
+void ContourSet::clear() {
+  points_.clear();
+  start_.clear();
+  start_.push_back(0);
+  ac_idx_.clear();
+  alert_level_.clear();
+}
+
+int ContourSet::size() const {
+  return ac_idx_.size();
+}
+
+int ContourSet::numberOfPoints() const {
+  return start_.back();
+}
+
+int ContourSet::aircraftIndex(int k) const {
+  return ac_idx_[k];
+}
+
+int ContourSet::alertLevel(int k) const {
+  return alert_level_[k];
+}
+
+int ContourSet::polygonSize(int k) const {
+  return start_[k+1]-start_[k];
+}
+
+Position const & ContourSet::point(int k, int j) const {
+  return points_[start_[k]+j];
+}
+
+void ContourSet::polygon(int k, std::vector<Position>& poly) const {
+  poly.assign(points_.begin()+start_[k],points_.begin()+start_[k+1]);
+}
+
+void ContourSet::toBlobs(std::vector< std::vector<Position> >& blobs) const {
+  blobs.resize(size());
+  for (int k = 0; k < size(); ++k) {
+    polygon(k,blobs[k]);
+  }
+}
+
+void ContourSet::beginPolygon(int ac_idx, int alert_level) {
+  ac_idx_.push_back(ac_idx);
+  alert_level_.push_back(alert_level);
+}
+
+void ContourSet::addPoint(const Position& p) {
+  points_.push_back(p);
+}
+
+void ContourSet::endPolygon() {
+  if ((int)points_.size() == start_.back()) {
+    ac_idx_.pop_back();
+    alert_level_.pop_back();
+  } else {
+    start_.push_back(points_.size());
+  }
+}
+
+void ContourSet::append(const ContourSet& contours) {
+  int offset = start_.back();
+  points_.insert(points_.end(),contours.points_.begin(),contours.points_.end());
+  for (int k = 1; k < (int)contours.start_.size(); ++k) {
+    start_.push_back(offset+contours.start_[k]);
+  }
+  ac_idx_.insert(ac_idx_.end(),contours.ac_idx_.begin(),contours.ac_idx_.end());
+  alert_level_.insert(alert_level_.end(),contours.alert_level_.begin(),contours.alert_level_.end());
+}
+
+std::string ContourSet::toString() const {
+  std::string s = "";
+  for (int k = 0; k < size(); ++k) {
+    s += "Contour of aircraft "+Fmi(ac_idx_[k])+" for alert level "+Fmi(alert_level_[k])+":";
+    for (int j = 0; j < polygonSize(k); ++j) {
+      s += " "+point(k,j).toString();
+    }
+    s += "\n";
+  }
+  return s;
+}
+
+}
@@ -18,7 +18,7 @@
 
 namespace larcfm {
 
-TrafficState DCPAUrgencyStrategy::mostUrgentAircraft(Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T) {
+TrafficState DCPAUrgencyStrategy::mostUrgentAircraft(const Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T) {
   TrafficState repac = TrafficState::INVALID;
   if (!ownship.isValid() || traffic.empty()) {
     return repac;
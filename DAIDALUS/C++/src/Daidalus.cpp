@@ -25,6 +25,7 @@
 #include "format.h"
 #include "NoneUrgencyStrategy.h"
 #include "Constants.h"
+#include "ParallelLoop.h"
 
 namespace larcfm {
 
@@ -56,6 +57,7 @@ Daidalus::Daidalus(const Daidalus& daa) : error("Daidalus") {
   ownship_ = daa.ownship_;
   traffic_ = std::vector<TrafficState>();
   traffic_.insert(traffic_.end(),daa.traffic_.begin(),daa.traffic_.end());
+  traffic_index_ = daa.traffic_index_;
 }
 
 Daidalus::~Daidalus() {
@@ -72,6 +74,7 @@ Daidalus& Daidalus::operator=(const Daidalus& daa) {
   ownship_ = daa.ownship_;
   traffic_ = std::vector<TrafficState>();
   traffic_.insert(traffic_.end(),daa.traffic_.begin(),daa.traffic_.end());
+  traffic_index_ = daa.traffic_index_;
   return *this;
 }
 
@@ -112,6 +115,7 @@ void Daidalus::set_Buffered_WC_SC_228_MOPS(bool type) {
 void Daidalus::reset() {
   ownship_ = TrafficState::INVALID;
   traffic_.clear();
+  traffic_index_.clear();
   wind_vector_ = Velocity::ZEROV();
   current_time_ = 0;
 }
@@ -155,11 +159,15 @@ void Daidalus::setWindField(const Velocity& wind) {
     Velocity delta_wind = wind_vector_.Sub(wind);
     ownship_ = TrafficState::makeOwnship(ownship_.getId(),ownship_.getPosition(),
         ownship_.getVelocity().Add(delta_wind),ownship_.getTime());
+    std::vector<std::string> ids(traffic_.size());
+    std::vector<Position> pos(traffic_.size());
+    std::vector<Velocity> vel(traffic_.size());
     for (TrafficState::nat i=0; i < traffic_.size(); ++i) {
-      TrafficState ac = traffic_[i];
-      traffic_[i] = ownship_.makeIntruder(ac.getId(),ac.getPosition(),
-          ac.getVelocity().Add(delta_wind));
+      ids[i] = traffic_[i].getId();
+      pos[i] = traffic_[i].getPosition();
+      vel[i] = traffic_[i].getVelocity().Add(delta_wind);
     }
+    ownship_.makeIntruders(ids,pos,vel,traffic_);
   }
   wind_vector_ = wind;
 }
@@ -169,6 +177,7 @@ void Daidalus::setWindField(const Velocity& wind) {
  */
 void Daidalus::setOwnshipState(const std::string& id, const Position& pos, const Velocity& vel, double time) {
   traffic_.clear();
+  traffic_index_.clear();
   ownship_ = TrafficState::makeOwnship(id,pos,vel.Sub(wind_vector_),time);
   current_time_ = time;
 }
@@ -192,11 +201,10 @@ int Daidalus::addTrafficState(const std::string& id, const Position& pos, const
     setOwnshipState(id,pos,vel,time);
     return 0;
   } else {
-    double dt = current_time_-time;
-    Position pt = dt == 0 ? pos : pos.linear(vel,dt);
-    TrafficState ac = ownship_.makeIntruder(id,pt,vel.Sub(wind_vector_));
+    TrafficState ac = make_intruder(id,pos,vel,time);
     if (ac.isValid()) {
       traffic_.push_back(ac);
+      traffic_index_.insert(std::pair<std::string,int>(id,traffic_.size()-1));
       return traffic_.size();
     } else {
       return -1;
@@ -231,6 +239,101 @@ int Daidalus::addTrafficState(const TrafficState& ac) {
   return addTrafficState(ac.getId(),ac.getPosition(),ac.getVelocity());
 }
 
+TrafficState Daidalus::make_intruder(const std::string& id, const Position& pos, const Velocity& vel, double time) const {
+  double dt = current_time_-time;
+  Position pt = dt == 0 ? pos : pos.linear(vel,dt);
+  return ownship_.makeIntruder(id,pt,vel.Sub(wind_vector_));
+}
+
+void Daidalus::index_traffic() {
+  traffic_index_.clear();
+  for (TrafficState::nat i = 0; i < traffic_.size(); ++i) {
+    traffic_index_.insert(std::pair<std::string,int>(traffic_[i].getId(),i));
+  }
+}
+
+/**
+ * Set ownship state and current time, keeping traffic aircraft. Velocity vector is ground velocity.
+ * Traffic aircraft are linearly projected to the new current time. A traffic aircraft with the
+ * same identifier as the ownship is removed.
+ */
+void Daidalus::updateOwnshipState(const std::string& id, const Position& pos, const Velocity& vel, double time) {
+  if (lastTrafficIndex() < 0) {
+    setOwnshipState(id,pos,vel,time);
+    return;
+  }
+  // The ownship can't track itself as traffic
+  removeTrafficState(id);
+  double dt = time-current_time_;
+  bool latlon = pos.isLatLon() || ownship_.getPosition().isLatLon();
+  ownship_ = TrafficState::makeOwnship(id,pos,vel.Sub(wind_vector_),time);
+  // Intruders are relative to the ownship: they have to be re-projected, except when
+  // states are Euclidean and time doesn't change.
+  if (dt != 0 || latlon) {
+    std::vector<std::string> ids(traffic_.size());
+    std::vector<Position> pos(traffic_.size());
+    std::vector<Velocity> vel(traffic_.size());
+    for (TrafficState::nat i=0; i < traffic_.size(); ++i) {
+      const TrafficState& ac = traffic_[i];
+      Velocity vi = ac.getVelocity().Add(wind_vector_); // Original ground velocity
+      ids[i] = ac.getId();
+      pos[i] = dt == 0 ? ac.getPosition() : ac.getPosition().linear(vi,dt);
+      vel[i] = ac.getVelocity();
+    }
+    ownship_.makeIntruders(ids,pos,vel,traffic_);
+  }
+  current_time_ = time;
+}
+
+/**
+ * Update state of traffic aircraft with given identifier, or add it if there is no such aircraft.
+ */
+int Daidalus::updateTrafficState(const std::string& id, const Position& pos, const Velocity& vel, double time) {
+  if (lastTrafficIndex() < 0) {
+    setOwnshipState(id,pos,vel,time);
+    return 0;
+  }
+  if (id == ownship_.getId()) {
+    error.addError("updateTrafficState: "+id+" is the ownship, use updateOwnshipState");
+    return -1;
+  }
+  TrafficIndex::const_iterator it = traffic_index_.find(id);
+  if (it == traffic_index_.end()) {
+    return addTrafficState(id,pos,vel,time);
+  }
+  TrafficState ac = make_intruder(id,pos,vel,time);
+  if (ac.isValid()) {
+    traffic_[it->second] = ac;
+    return it->second+1;
+  }
+  return -1;
+}
+
+/**
+ * Remove traffic aircraft with given identifier. The last traffic aircraft takes the index of the
+ * removed one.
+ */
+bool Daidalus::removeTrafficState(const std::string& id) {
+  TrafficIndex::iterator it = traffic_index_.find(id);
+  if (it == traffic_index_.end()) {
+    return false;
+  }
+  int i = it->second;
+  int last = traffic_.size()-1;
+  if (i != last) {
+    traffic_[i] = traffic_[last];
+  }
+  traffic_.pop_back();
+  traffic_index_.erase(it);
+  if (traffic_index_.size() != traffic_.size()) {
+    // There are duplicated identifiers
+    index_traffic();
+  } else if (i != last) {
+    traffic_index_[traffic_[i].getId()] = i;
+  }
+  return true;
+}
+
 /**
  * Exchange ownship aircraft with aircraft at index ac_idx.
  */
@@ -238,15 +341,18 @@ void Daidalus::resetOwnship(int ac_idx) {
   if (1 <= ac_idx && ac_idx <= lastTrafficIndex()) {
     int ac = ac_idx-1;
     TrafficState new_own = TrafficState::makeOwnship(traffic_[ac]);
-    TrafficState old_own = new_own.makeIntruder(ownship_);
-    ownship_ = new_own;
+    std::vector<std::string> ids(traffic_.size());
+    std::vector<Position> pos(traffic_.size());
+    std::vector<Velocity> vel(traffic_.size());
     for (TrafficState::nat i = 0; i < traffic_.size(); ++i) {
-      if (i == (TrafficState::nat)ac) {
-        traffic_[i] = old_own;
-      } else {
-        traffic_[i] = ownship_.makeIntruder(traffic_[i]);
-      }
+      const TrafficState& ai = i == (TrafficState::nat)ac ? ownship_ : traffic_[i];
+      ids[i] = ai.getId();
+      pos[i] = ai.getPosition();
+      vel[i] = ai.getVelocity();
     }
+    ownship_ = new_own;
+    ownship_.makeIntruders(ids,pos,vel,traffic_);
+    index_traffic();
   } else {
     error.addError("resetOwnship: aircraft index "+Fmi(ac_idx)+" is out of bounds");
   }
@@ -267,9 +373,9 @@ int Daidalus::aircraftIndex(const std::string& name) const {
     if (ownship_.getId() == name) {
       return 0;
     }
-    for (TrafficState::nat i = 0; i < traffic_.size(); ++i) {
-      if (traffic_[i].getId() == name)
-        return i+1;
+    TrafficIndex::const_iterator it = traffic_index_.find(name);
+    if (it != traffic_index_.end()) {
+      return it->second+1;
     }
   }
   return -1;
@@ -291,12 +397,17 @@ void Daidalus::setCurrentTime(double time) {
     Velocity vo = ownship_.getVelocity().Add(wind_vector_); // Original ground velocity
     Position po = ownship_.getPosition().linear(vo,dt);
     ownship_ = TrafficState::makeOwnship(ownship_.getId(),po,ownship_.getVelocity(),time);
+    std::vector<std::string> ids(traffic_.size());
+    std::vector<Position> pos(traffic_.size());
+    std::vector<Velocity> vel(traffic_.size());
     for (TrafficState::nat i=0; i < traffic_.size(); ++i) {
-      TrafficState ac = traffic_[i];
+      const TrafficState& ac = traffic_[i];
       Velocity vi = ac.getVelocity().Add(wind_vector_); // Original ground velocity
-      Position pi = ac.getPosition().linear(vi,dt);
-      traffic_[i] = ownship_.makeIntruder(ac.getId(),pi,ac.getVelocity());
+      ids[i] = ac.getId();
+      pos[i] = ac.getPosition().linear(vi,dt);
+      vel[i] = ac.getVelocity();
     }
+    ownship_.makeIntruders(ids,pos,vel,traffic_);
     current_time_ = time;
   }
 }
@@ -335,13 +446,98 @@ int Daidalus::alerting(int ac_idx) {
   return alerting(ac_idx,0,0,0);
 }
 
+/*
+ * Alerting of chunks of traffic aircraft. Chunk c uses bands kbs[c], so that chunks don't share
+ * mutable state.
+ */
+class AlertingBody : public ParallelLoop::Body {
+public:
+  const std::vector<KinematicMultiBands*>& kbs;
+  const std::vector<TrafficState>& traffic;
+  int turning, accelerating, climbing;
+  std::vector<int>& alerts;
+
+  AlertingBody(const std::vector<KinematicMultiBands*>& k, const std::vector<TrafficState>& tr,
+      int t, int a, int c, std::vector<int>& al) :
+        kbs(k), traffic(tr), turning(t), accelerating(a), climbing(c), alerts(al) {}
+
+  void run(int begin, int end) {
+    int n = traffic.size();
+    int chunks = kbs.size();
+    for (int c = begin; c < end; ++c) {
+      int last = (int)((long long)n*(c+1)/chunks);
+      for (int i = (int)((long long)n*c/chunks); i < last; ++i) {
+        alerts[i] = kbs[c]->alerting(traffic[i],turning,accelerating,climbing);
+      }
+    }
+  }
+};
+
+/**
+ * Computes alerting type of ownship and all traffic aircraft for current aircraft states,
+ * i.e., alerts[ac_idx-1] is alerting(ac_idx,turning,accelerating,climbing). The bands
+ * objects of the alerting logic are set up once for all aircraft, and aircraft are split
+ * across threads when there are many of them, see ParallelLoop.
+ */
+void Daidalus::alertingAll(std::vector<int>& alerts, int turning, int accelerating, int climbing) {
+  alerts.clear();
+  if (lastTrafficIndex() < 1) {
+    return;
+  }
+  int n = traffic_.size();
+  // Each chunk should have enough aircraft to pay for its bands and thread
+  int chunks = Util::max(1,Util::min(ParallelLoop::concurrency(),n/8));
+  if ((int)chunk_kbs_.size() < chunks-1) {
+    chunk_kbs_.resize(chunks-1);
+  }
+  std::vector<KinematicMultiBands*> kbs;
+  kbs.push_back(&kb_);
+  for (int c = 0; c < chunks-1; ++c) {
+    kbs.push_back(&chunk_kbs_[c]);
+  }
+  for (int c = 0; c < chunks; ++c) {
+    kinematicMultiBands(*kbs[c]);
+  }
+  alerts.resize(n);
+  AlertingBody body(kbs,traffic_,turning,accelerating,climbing,alerts);
+  ParallelLoop::run(chunks,body);
+  for (int c = 1; c < chunks; ++c) {
+    kb_.core_.stats.add(kbs[c]->getStats());
+    kbs[c]->clearStats();
+  }
+}
+
+/**
+ * Computes alerting type of ownship and all traffic aircraft for current aircraft states,
+ * i.e., alerts[ac_idx-1] is alerting(ac_idx).
+ */
+void Daidalus::alertingAll(std::vector<int>& alerts) {
+  alertingAll(alerts,0,0,0);
+}
+
+/**
+ * Same as alertingAll(alerts,turning,accelerating,climbing). In addition, detections[ac_idx-1]
+ * is detection(ac_idx) and times_to_violation[ac_idx-1] is timeToViolation(ac_idx).
+ */
+void Daidalus::alertingAll(std::vector<int>& alerts, std::vector<ConflictData>& detections,
+    std::vector<double>& times_to_violation, int turning, int accelerating, int climbing) {
+  alertingAll(alerts,turning,accelerating,climbing);
+  detections.clear();
+  times_to_violation.clear();
+  for (int ac = 1; ac <= lastTrafficIndex(); ++ac) {
+    detections.push_back(detection(ac));
+    const ConflictData& det = detections.back();
+    times_to_violation.push_back(det.conflict() ? det.getTimeIn() : PINFINITY);
+  }
+}
+
 /**
  * Detects conflict with aircraft at index ac_idx for given alert level.
  * Conflict data provides time to violation and time to end of violation
  * within lookahead time.
  */
 ConflictData Daidalus::detection(int ac_idx, int alert_level) const {
-  Detection3D* detector = parameters.alertor.detectorRef(alert_level);
+  const Detection3D* detector = parameters.alertor.detectorRef(alert_level);
   if (1 <= ac_idx && ac_idx <= lastTrafficIndex() && detector != NULL) {
     TrafficState ac = traffic_[ac_idx-1];
     return detector->conflictDetection(ownship_.get_s(),ownship_.get_v(),ac.get_s(),ac.get_v(),
@@ -396,6 +592,20 @@ void Daidalus::kinematicMultiBands(KinematicMultiBands& bands) const {
   }
 }
 
+/**
+ * Returns instrumentation counters and phase times of the alerting logic.
+ */
+BandsStats const & Daidalus::getAlertingStats() const {
+  return kb_.getStats();
+}
+
+/**
+ * Sets instrumentation counters and phase times of the alerting logic to 0.
+ */
+void Daidalus::clearAlertingStats() {
+  kb_.clearStats();
+}
+
 /**
  * Returns state of ownship.
  */
@@ -438,7 +648,7 @@ void Daidalus::setUrgencyStrategy(const UrgencyStrategy* strat) {
  * Returns most urgent aircraft for given alert level according to urgency strategy.
  */
 TrafficState Daidalus::mostUrgentAircraft(int alert_level) const {
-  Detection3D* detector = parameters.alertor.detectorRef(alert_level);
+  const Detection3D* detector = parameters.alertor.detectorRef(alert_level);
   if (lastTrafficIndex() > 0 && detector != NULL) {
     return urgency_strat_->mostUrgentAircraft(detector,ownship_,traffic_,parameters.getLookaheadTime());
   } else {
@@ -453,115 +663,230 @@ TrafficState Daidalus::mostUrgentAircraft() const {
   return mostUrgentAircraft(0);
 }
 
-void Daidalus::add_blob(std::vector< std::vector<Position> >& blobs, std::deque<Position>& vin, std::deque<Position>& vout) {
-  if (vin.empty() && vout.empty()) {
-    return;
+/*
+ * Points of the contour being computed. Points are added to the front or to the back
+ * of the list of time-in points (in) and of the list of time-out points (out). The
+ * contour is in followed by out.
+ */
+class ContourBuilder {
+public:
+  std::vector<Position> in_front; // Reversed
+  std::vector<Position> in_back;
+  std::vector<Position> out_front; // Reversed
+  std::vector<Position> out_back;
+
+  /* Add contour, if not empty, to contours and clear the lists of points */
+  void add_blob(ContourSet& contours, int ac_idx, int alert_level) {
+    if (in_front.empty() && in_back.empty() && out_front.empty() && out_back.empty()) {
+      return;
+    }
+    contours.beginPolygon(ac_idx,alert_level);
+    for (int i = in_front.size()-1; i >= 0; --i) {
+      contours.addPoint(in_front[i]);
+    }
+    for (int i = 0; i < (int)in_back.size(); ++i) {
+      contours.addPoint(in_back[i]);
+    }
+    for (int i = out_front.size()-1; i >= 0; --i) {
+      contours.addPoint(out_front[i]);
+    }
+    for (int i = 0; i < (int)out_back.size(); ++i) {
+      contours.addPoint(out_back[i]);
+    }
+    contours.endPolygon();
+    in_front.clear();
+    in_back.clear();
+    out_front.clear();
+    out_back.clear();
   }
-  // Add conflict contour
-  std::vector<Position> blob = std::vector<Position>();
-  blob.insert(blob.end(),vin.begin(),vin.end());
-  blob.insert(blob.end(),vout.begin(),vout.end());
-  blobs.push_back(blob);
-  vin.clear();
-  vout.clear();
-}
+};
 
-/**
- * Computes horizontal contours contributed by aircraft at index ac_idx, for
- * given alert level. A contour is a non-empty list of points in counter-clockwise
- * direction representing a polygon.
- * @param blobs list of track contours returned by reference.
- * @param ac_idx is the index of the aircraft used to compute the contours.
- */
-void Daidalus::horizontalContours(std::vector< std::vector<Position> >& blobs, int ac_idx, int alert_level) {
-  Detection3D* detector = parameters.alertor.detectorRef(alert_level);
-  blobs.clear();
-  if (1 <= ac_idx && ac_idx <= lastTrafficIndex() && detector != NULL) {
-    std::deque<Position> vin = std::deque<Position>();
-    Position po = ownship_.getPosition();
-    Velocity vo = ownship_.getVelocity();
-    TrafficState intruder = traffic_[ac_idx-1];
-    Vect3 si = intruder.get_s();
-    Velocity vi = intruder.get_v();
-    double current_trk = vo.trk();
-    std::deque<Position> vout = std::deque<Position>();
-    /* First step: Computes conflict contour (contour in the current path of the aircraft).
-     * Get contour portion to the right.  If los.getTimeIn() == 0, a 360 degree
-     * contour will be computed. Otherwise, stops at the first non-conflict degree.
-     */
-    double right = 0; // Contour conflict limit to the right relative to current track  [0-2pi rad]
-    double two_pi = 2*Pi;
-    for (; right < two_pi; right += parameters.getTrackStep()) {
-      Velocity vop = vo.mkTrk(current_trk+right);
-      LossData los = detector->conflictDetection(ownship_.get_s(),ownship_.vel_to_v(po,vop),si,vi,
+/*
+ * Add to contours the horizontal contours contributed by intruder, with aircraft index ac_idx,
+ * for detector of given alert level. Contours are sampled at every track step for any detector:
+ * CriticalVectors and TangentLine only give the tracks tangent to a CD3D cylinder, not the WCV volumes
+ * of the configurations, and even then the points of a contour are the time-in and time-out positions
+ * along each sampled track, so the sweep would still be needed.
+ */
+static void contour_sweep(ContourSet& contours, ContourBuilder& blob, const KinematicBandsParameters& parameters,
+    const TrafficState& ownship, const TrafficState& intruder, const Detection3D* detector, int ac_idx, int alert_level) {
+  Position po = ownship.getPosition();
+  Velocity vo = ownship.getVelocity();
+  Vect3 si = intruder.get_s();
+  Velocity vi = intruder.get_v();
+  double current_trk = vo.trk();
+  /* First step: Computes conflict contour (contour in the current path of the aircraft).
+   * Get contour portion to the right.  If los.getTimeIn() == 0, a 360 degree
+   * contour will be computed. Otherwise, stops at the first non-conflict degree.
+   */
+  double right = 0; // Contour conflict limit to the right relative to current track  [0-2pi rad]
+  double two_pi = 2*Pi;
+  for (; right < two_pi; right += parameters.getTrackStep()) {
+    Velocity vop = vo.mkTrk(current_trk+right);
+    LossData los = detector->conflictDetection(ownship.get_s(),ownship.vel_to_v(po,vop),si,vi,
+        0,parameters.getLookaheadTime());
+    if ( !los.conflict() ) {
+      break;
+    }
+    if (los.getTimeIn() != 0 ) {
+      // if not in los, add position at time in (counter clock-wise)
+      blob.in_back.push_back(po.linear(vop,los.getTimeIn()));
+    }
+    // in any case, add position ad time out (counter clock-wise)
+    blob.out_front.push_back(po.linear(vop,los.getTimeOut()));
+  }
+  /* Second step: Compute conflict contour to the left */
+  double left = 0;  // Contour conflict limit to the left relative to current track [0-2pi rad]
+  if (0 < right && right < two_pi) {
+    /* There is a conflict contour, but not a violation */
+    for (left = parameters.getTrackStep(); left < two_pi; left += parameters.getTrackStep()) {
+      Velocity vop = vo.mkTrk(current_trk-left);
+      LossData los = detector->conflictDetection(ownship.get_s(),ownship.vel_to_v(po,vop),si,vi,
           0,parameters.getLookaheadTime());
       if ( !los.conflict() ) {
         break;
       }
-      if (los.getTimeIn() != 0 ) {
-        // if not in los, add position at time in (counter clock-wise)
-        vin.push_back(po.linear(vop,los.getTimeIn()));
-      }
-      // in any case, add position ad time out (counter clock-wise)
-      vout.push_front(po.linear(vop,los.getTimeOut()));
+      blob.in_front.push_back(po.linear(vop,los.getTimeIn()));
+      blob.out_back.push_back(po.linear(vop,los.getTimeOut()));
     }
-    /* Second step: Compute conflict contour to the left */
-    double left = 0;  // Contour conflict limit to the left relative to current track [0-2pi rad]
-    if (0 < right && right < two_pi) {
-      /* There is a conflict contour, but not a violation */
-      for (left = parameters.getTrackStep(); left < two_pi; left += parameters.getTrackStep()) {
-        Velocity vop = vo.mkTrk(current_trk-left);
-        LossData los = detector->conflictDetection(ownship_.get_s(),ownship_.vel_to_v(po,vop),si,vi,
-            0,parameters.getLookaheadTime());
-        if ( !los.conflict() ) {
+  }
+  blob.add_blob(contours,ac_idx,alert_level);
+  // Third Step: Look for other blobs to the right within track threshold
+  if (right < parameters.getHorizontalContourThreshold()) {
+    for (; right < two_pi-left; right += parameters.getTrackStep()) {
+      Velocity vop = vo.mkTrk(current_trk+right);
+      LossData los = detector->conflictDetection(ownship.get_s(),ownship.vel_to_v(po,vop),si,vi,
+          0,parameters.getLookaheadTime());
+      if (los.conflict()) {
+        blob.in_back.push_back(po.linear(vop,los.getTimeIn()));
+        blob.out_front.push_back(po.linear(vop,los.getTimeOut()));
+      } else {
+        blob.add_blob(contours,ac_idx,alert_level);
+        if (right >= parameters.getHorizontalContourThreshold()) {
           break;
         }
-        vin.push_front(po.linear(vop,los.getTimeIn()));
-        vout.push_back(po.linear(vop,los.getTimeOut()));
       }
     }
-    add_blob(blobs,vin,vout);
-    // Third Step: Look for other blobs to the right within track threshold
-    if (right < parameters.getHorizontalContourThreshold()) {
-      for (; right < two_pi-left; right += parameters.getTrackStep()) {
-        Velocity vop = vo.mkTrk(current_trk+right);
-        LossData los = detector->conflictDetection(ownship_.get_s(),ownship_.vel_to_v(po,vop),si,vi,
-            0,parameters.getLookaheadTime());
-        if (los.conflict()) {
-          vin.push_back(po.linear(vop,los.getTimeIn()));
-          vout.push_front(po.linear(vop,los.getTimeOut()));
-        } else {
-          add_blob(blobs,vin,vout);
-          if (right >= parameters.getHorizontalContourThreshold()) {
-            break;
-          }
-        }
-      }
-      add_blob(blobs,vin,vout);
-    }
-    // Fourth Step: Look for other blobs to the left within track threshold
-    if (left < parameters.getHorizontalContourThreshold()) {
-      for (; left < two_pi-right; left += parameters.getTrackStep()) {
-        Velocity vop = vo.mkTrk(current_trk-left);
-        LossData los = detector->conflictDetection(ownship_.get_s(),ownship_.vel_to_v(po,vop),si,vi,
-            0,parameters.getLookaheadTime());
-        if (los.conflict()) {
-          vin.push_front(po.linear(vop,los.getTimeIn()));
-          vout.push_back(po.linear(vop,los.getTimeOut()));
-        } else {
-          add_blob(blobs,vin,vout);
-          if (left >= parameters.getHorizontalContourThreshold()) {
-            break;
-          }
+    blob.add_blob(contours,ac_idx,alert_level);
+  }
+  // Fourth Step: Look for other blobs to the left within track threshold
+  if (left < parameters.getHorizontalContourThreshold()) {
+    for (; left < two_pi-right; left += parameters.getTrackStep()) {
+      Velocity vop = vo.mkTrk(current_trk-left);
+      LossData los = detector->conflictDetection(ownship.get_s(),ownship.vel_to_v(po,vop),si,vi,
+          0,parameters.getLookaheadTime());
+      if (los.conflict()) {
+        blob.in_front.push_back(po.linear(vop,los.getTimeIn()));
+        blob.out_back.push_back(po.linear(vop,los.getTimeOut()));
+      } else {
+        blob.add_blob(contours,ac_idx,alert_level);
+        if (left >= parameters.getHorizontalContourThreshold()) {
+          break;
         }
       }
-      add_blob(blobs,vin,vout);
     }
+    blob.add_blob(contours,ac_idx,alert_level);
+  }
+}
+
+/**
+ * Computes horizontal contours contributed by aircraft at index ac_idx, for
+ * given alert level. A contour is a non-empty list of points in counter-clockwise
+ * direction representing a polygon.
+ * @param blobs list of track contours returned by reference.
+ * @param ac_idx is the index of the aircraft used to compute the contours.
+ */
+void Daidalus::horizontalContours(std::vector< std::vector<Position> >& blobs, int ac_idx, int alert_level) {
+  const Detection3D* detector = parameters.alertor.detectorRef(alert_level);
+  blobs.clear();
+  if (1 <= ac_idx && ac_idx <= lastTrafficIndex() && detector != NULL) {
+    ContourSet contours;
+    ContourBuilder blob;
+    contour_sweep(contours,blob,parameters,ownship_,traffic_[ac_idx-1],detector,ac_idx,alert_level);
+    contours.toBlobs(blobs);
   } else {
     error.addError("trackContour: aircraft index "+Fmi(ac_idx)+" is out of bounds");
   }
 }
 
+/*
+ * Contours of a list of (aircraft index, alert level) pairs. Each pair has its own set of
+ * contours, so that pairs can be computed concurrently.
+ */
+class ContourSweepBody : public ParallelLoop::Body {
+public:
+  const KinematicBandsParameters& parameters;
+  const TrafficState& ownship;
+  const std::vector<TrafficState>& traffic;
+  const std::vector<int>& ac_idx;
+  const std::vector<int>& alert_level;
+  std::vector<ContourSet>& parts;
+
+  ContourSweepBody(const KinematicBandsParameters& p, const TrafficState& own, const std::vector<TrafficState>& tr,
+      const std::vector<int>& acs, const std::vector<int>& levels, std::vector<ContourSet>& cs) :
+        parameters(p), ownship(own), traffic(tr), ac_idx(acs), alert_level(levels), parts(cs) {}
+
+  void run(int begin, int end) {
+    ContourBuilder blob;
+    for (int i = begin; i < end; ++i) {
+      parts[i].clear();
+      contour_sweep(parts[i],blob,parameters,ownship,traffic[ac_idx[i]-1],
+          parameters.alertor.detectorRef(alert_level[i]),ac_idx[i],alert_level[i]);
+    }
+  }
+};
+
+/**
+ * Computes horizontal contours contributed by all traffic aircraft, for given alert level,
+ * and puts them in contours. If alert_level is 0, conflict alert level is used.
+ */
+void Daidalus::horizontalContours(ContourSet& contours, int alert_level) {
+  if (alert_level == 0) {
+    alert_level = parameters.alertor.conflictAlertLevel();
+  }
+  std::vector<int> levels;
+  if (parameters.alertor.detectorRef(alert_level) != NULL) {
+    levels.push_back(alert_level);
+  }
+  horizontal_contours(contours,levels);
+}
+
+/**
+ * Computes horizontal contours contributed by all traffic aircraft, for all alert levels,
+ * and puts them in contours.
+ */
+void Daidalus::horizontalContours(ContourSet& contours) {
+  std::vector<int> levels;
+  for (int alert_level = 1; alert_level <= parameters.alertor.mostSevereAlertLevel(); ++alert_level) {
+    if (parameters.alertor.detectorRef(alert_level) != NULL) {
+      levels.push_back(alert_level);
+    }
+  }
+  horizontal_contours(contours,levels);
+}
+
+/**
+ * Put in contours the horizontal contours contributed by all traffic aircraft for the given
+ * alert levels. Contours are ordered by alert level and then by aircraft index.
+ */
+void Daidalus::horizontal_contours(ContourSet& contours, const std::vector<int>& levels) {
+  contours.clear();
+  std::vector<int> ac_idx;
+  std::vector<int> alert_level;
+  for (int l = 0; l < (int)levels.size(); ++l) {
+    for (int ac = 1; ac <= lastTrafficIndex(); ++ac) {
+      ac_idx.push_back(ac);
+      alert_level.push_back(levels[l]);
+    }
+  }
+  contour_parts_.resize(ac_idx.size());
+  ContourSweepBody body(parameters,ownship_,traffic_,ac_idx,alert_level,contour_parts_);
+  ParallelLoop::run(ac_idx.size(),body);
+  for (int i = 0; i < (int)ac_idx.size(); ++i) {
+    contours.append(contour_parts_[i]);
+  }
+}
+
 /**
  * Computes horizontal contours contributed by aircraft at index ac_idx, for
  * conflict alert level. A contour is a non-empty list of points in counter-clockwise
@@ -39,9 +39,15 @@ TERMINATION OF THIS AGREEMENT.
 
 #include "Daidalus.h"
 #include "DaidalusFileWalker.h"
+#include "LatencyProfile.h"
+#include <chrono>
 
 using namespace larcfm;
 
+static double now() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 int main(int argc, char* argv[]) {
 
   // Create a Daidalus object for an unbuffered well-clear volume and instantaneous bands
@@ -51,6 +57,7 @@ int main(int argc, char* argv[]) {
 	ParameterData params;
 	std::string conf = "";
 	bool echo = false;
+	bool profile = false;
 
 	// A Daidalus object can be configured either programatically or by using a configuration file.
 	for (int a=1;a < argc; ++a) {
@@ -80,6 +87,8 @@ int main(int argc, char* argv[]) {
 			}
 		} else if (arga == "--echo" || arga == "-echo") {
 		        echo = true;
+		} else if (arga == "--profile" || arga == "-profile") {
+			profile = true;
 		} else if ((startsWith(arga,"--o") || startsWith(arga,"-o")) && a+1 < argc) {
 			output_file = argv[++a];
 		} else if (startsWith(arga,"-") && arga.find('=') != std::string::npos) {
@@ -94,6 +103,7 @@ int main(int argc, char* argv[]) {
 			std::cerr << "  --<var>=<val>\n\t<key> is any configuration variable and val is its value (including units, if any), e.g., --lookahead_time=5[min]" << std::endl;
 			std::cerr << "  --output <output_file>\n\tOutput information to <output_file>" << std::endl;
 			std::cerr << "  --echo\n\tEcho configuration and traffic list in standard outoput" << std::endl;
+			std::cerr << "  --profile\n\tPrint in standard error the latency percentiles of each phase of a time step\n\t(read, alerting, output) and the slowest time steps" << std::endl;
 			std::cerr << "  --help\n\tPrint this message" << std::endl;
 			exit(0);
 		} else if (startsWith(arga,"-")){
@@ -138,7 +148,7 @@ int main(int argc, char* argv[]) {
 	std::cout << "Processing DAIDALUS file " << input_file << std::endl;
 	std::cout << "Generating CSV file " << output_file << std::endl;
 	DaidalusFileWalker walker(input_file);
-	Detection3D* detector = daa.parameters.alertor.conflictDetectorRef();
+	const Detection3D* detector = daa.parameters.alertor.conflictDetectorRef();
 	std::string uhor = daa.parameters.getUnits("min_horizontal_recovery");
 	std::string uver = daa.parameters.getUnits("min_vertical_recovery");
 	std::string ugs = daa.parameters.getUnits("gs_step");
@@ -161,17 +171,27 @@ int main(int argc, char* argv[]) {
 	out << std::endl;
 	out << line_units << std::endl;
 
+	LatencyProfile latencies;
+	int read_phase = latencies.addPhase("read");
+	int alerting_phase = latencies.addPhase("alerting");
+	int output_phase = latencies.addPhase("output");
+	int total_phase = latencies.addPhase("total");
+	std::vector<int> alerts;
 	while (!walker.atEnd()) {
+		double t0 = now();
 		walker.readState(daa);
+		double t1 = now();
 		if (echo) {
 		  std::cout << daa.toString() << std::endl;
 		}
 		// At this point, daa has the state information of ownhsip and traffic for a given time
+		daa.alertingAll(alerts);
+		double t2 = now();
 		for (int ac=1; ac <= daa.lastTrafficIndex(); ++ac) {
 			out << daa.getCurrentTime();
 			out << ", " << daa.getOwnshipState().getId();
 			out << ", " << daa.getAircraftState(ac).getId();
-			int alert = daa.alerting(ac);
+			int alert = alerts[ac-1];
 			out << ", " << alert;
 			ConflictData det;
 			bool one=false;
@@ -199,7 +219,7 @@ int main(int argc, char* argv[]) {
 				}
 				out << ", ";
 				if (detector != NULL && detector->getSimpleSuperClassName() == "WCV_tvar") {
-					double tau_mod  = ((WCV_tvar*)detector)->horizontal_tvar(det.get_s().vect2(),det.get_v().vect2());
+					double tau_mod  = ((const WCV_tvar*)detector)->horizontal_tvar(det.get_s().vect2(),det.get_v().vect2());
 					if (tau_mod > 0) {
 						out << tau_mod;
 					}
@@ -207,6 +227,18 @@ int main(int argc, char* argv[]) {
 			}
 			out << std::endl;
 		}
+		if (profile) {
+			double t3 = now();
+			double time = daa.getCurrentTime();
+			latencies.add(read_phase,t1-t0,input_file,time);
+			latencies.add(alerting_phase,t2-t1,input_file,time);
+			latencies.add(output_phase,t3-t2,input_file,time);
+			latencies.add(total_phase,t3-t0,input_file,time);
+		}
 	}
 	out.close();
+	if (profile) {
+		std::cerr << "** Profile of " << latencies.getHistogram(total_phase).count() << " time steps" <<
+				std::endl << latencies.toString();
+	}
 }
@@ -0,0 +1,325 @@
+/**
+
+Notices:
+
+Copyright 2019 United States Government as represented by the
+Administrator of the National Aeronautics and Space Administration. No
+copyright is claimed in the United States under Title 17,
+U.S. Code. All Other Rights Reserved.
+
+Disclaimers
+
+No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY
+WARRANTY OF ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY,
+INCLUDING, BUT NOT LIMITED TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE
+WILL CONFORM TO SPECIFICATIONS, ANY IMPLIED WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, OR FREEDOM FROM
+INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE ERROR
+FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER,
+CONSTITUTE AN ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT
+OF ANY RESULTS, RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY
+OTHER APPLICATIONS RESULTING FROM USE OF THE SUBJECT SOFTWARE.
+FURTHER, GOVERNMENT AGENCY DISCLAIMS ALL WARRANTIES AND LIABILITIES
+REGARDING THIRD-PARTY SOFTWARE, IF PRESENT IN THE ORIGINAL SOFTWARE,
+AND DISTRIBUTES IT "AS IS."
+
+Waiver and Indemnity: RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS
+AGAINST THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND
+SUBCONTRACTORS, AS WELL AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF
+THE SUBJECT SOFTWARE RESULTS IN ANY LIABILITIES, DEMANDS, DAMAGES,
+EXPENSES OR LOSSES ARISING FROM SUCH USE, INCLUDING ANY DAMAGES FROM
+PRODUCTS BASED ON, OR RESULTING FROM, RECIPIENT'S USE OF THE SUBJECT
+SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD HARMLESS THE UNITED
+STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL AS ANY
+PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.  RECIPIENT'S SOLE
+REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE, UNILATERAL
+TERMINATION OF THIS AGREEMENT.
+ **/
+
+#include "BandsReader.h"
+#include "Units.h"
+#include "Util.h"
+#include "string_util.h"
+#include "format.h"
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+using namespace larcfm;
+
+static const char* dim_names[BANDS_DIMENSIONS] = { "Track", "Ground Speed", "Vertical Speed", "Altitude" };
+
+/*
+ * Text of the results of a step in the standard output format of DaidalusBatch, i.e.,
+ * KinematicMultiBands::outputString followed by conflict intervals and alerting.
+ */
+static std::string standard_step(const BandsReader& reader) {
+  const BandsStepRecord& step = reader.step();
+  int levels = Util::min(reader.header().most_severe_alert_level,BANDS_MAX_LEVELS);
+  std::string units[BANDS_DIMENSIONS];
+  for (int d = 0; d < BANDS_DIMENSIONS; ++d) {
+    units[d] = reader.units((BandsDimension)d);
+  }
+  std::string uxy = "m";
+  if (Units::isCompatible(units[BANDS_GS],"knot")) {
+    uxy = "nmi";
+  } else if (Units::isCompatible(units[BANDS_GS],"fpm")) {
+    uxy = "ft";
+  } else if (Units::isCompatible(units[BANDS_GS],"kph")) {
+    uxy = "km";
+  }
+  int traffic = reader.trafficSize();
+  std::vector<TrafficState> acs;
+  for (int ac = 0; ac <= traffic; ++ac) {
+    acs.push_back(reader.aircraftState(ac));
+  }
+  std::string s="";
+  // Info
+  s+="Time: "+Units::str("s",step.time)+"\n";
+  s+=acs[0].formattedHeader(uxy,units[BANDS_ALT],units[BANDS_GS],units[BANDS_VS]);
+  for (int ac = 0; ac <= traffic; ++ac) {
+    s+=acs[ac].formattedTrafficState(uxy,units[BANDS_ALT],units[BANDS_GS],units[BANDS_VS]);
+  }
+  s+="Conflict Criteria: ";
+  s+=(step.flags & BandsStepRecord::CONFLICT_CRITERIA) ? "Enabled\n" : "Disabled\n";
+  s+="Recovery Criteria: ";
+  s+=(step.flags & BandsStepRecord::RECOVERY_CRITERIA) ? "Enabled\n" : "Disabled\n";
+  s+="Most Urgent Aircraft: "+std::string(step.most_urgent,strnlen(step.most_urgent,BANDS_ID_SIZE))+"\n";
+  s+="Horizontal Epsilon: "+Fmi(step.epsilon_h)+"\n";
+  s+="Vertical Epsilon: "+Fmi(step.epsilon_v)+"\n";
+  // Alerting
+  for (int level = 1; level <= levels; ++level) {
+    std::vector<TrafficState> conflict;
+    for (int ac = 1; ac <= traffic; ++ac) {
+      if (reader.aircraft(ac).conflict_levels & (1u << (level-1))) {
+        conflict.push_back(acs[ac]);
+      }
+    }
+    s+="Conflict Aircraft (alert level "+Fmi(level)+"): "+TrafficState::listToString(conflict)+"\n";
+  }
+  // Bands
+  for (int d = 0; d < BANDS_DIMENSIONS; ++d) {
+    const BandsDimensionRecord& dim = step.dims[d];
+    const std::string& u = units[d];
+    std::string name = dim_names[d];
+    std::string up = d == BANDS_TRK ? "right" : "up";
+    std::string down = d == BANDS_TRK ? "left" : "down";
+    s+="Ownship "+name+": "+Units::str(u,dim.ownship)+"\n";
+    s+="Region of Current "+name+": "+BandsRegion::to_string((BandsRegion::Region)dim.region)+"\n";
+    s+=name+" Bands ["+u+","+u+"]:\n";
+    for (int i = 0; i < reader.length((BandsDimension)d); ++i) {
+      Interval ia = reader.interval((BandsDimension)d,i);
+      if (!ia.isEmpty()) {
+        ia = Interval(Units::to(u,ia.low),Units::to(u,ia.up));
+      }
+      s+="  "+ia.toString()+" "+BandsRegion::to_string(reader.region((BandsDimension)d,i))+"\n";
+    }
+    for (int level = 1; level <= levels; ++level) {
+      std::vector<TrafficState> peripheral;
+      for (int ac = 1; ac <= traffic; ++ac) {
+        if (reader.aircraft(ac).peripheral_levels[d] & (1u << (level-1))) {
+          peripheral.push_back(acs[ac]);
+        }
+      }
+      s+="Peripheral "+name+" Aircraft (alert level "+Fmi(level)+"): "+TrafficState::listToString(peripheral)+"\n";
+    }
+    s+=name+" Resolution ("+up+"): "+Units::str(u,dim.resolution_up)+"\n";
+    s+=name+" Resolution ("+down+"): "+Units::str(u,dim.resolution_down)+"\n";
+    s+="Preferred "+name+" Direction: "+(dim.preferred_up ? up : down)+"\n";
+    s+="Time to "+name+" Recovery: "+Units::str("s",dim.recovery_time)+"\n";
+  }
+  // Last times to maneuver
+  for (int ac = 1; ac <= traffic; ++ac) {
+    s+="Last Times to Maneuver with Respect to "+reader.aircraftId(ac)+"\n";
+    for (int d = 0; d < BANDS_DIMENSIONS; ++d) {
+      s+="  Last Time to "+std::string(dim_names[d])+" Maneuver: "+Units::str("s",reader.aircraft(ac).last_time[d])+"\n";
+    }
+  }
+  // Conflict intervals and alerting
+  for (int ac = 1; ac <= traffic; ++ac) {
+    const BandsAircraftRecord& rec = reader.aircraft(ac);
+    if (rec.flags & BandsAircraftRecord::CONFLICT) {
+      s+="Predicted Loss of Well-Clear With "+reader.aircraftId(ac)+" in "+Units::str("s",rec.time_in)+
+          " - "+Units::str("s",rec.time_out)+"\n";
+    }
+  }
+  for (int ac = 1; ac <= traffic; ++ac) {
+    if (reader.aircraft(ac).alert > 0) {
+      s+="Alert "+Fmi(reader.aircraft(ac).alert)+" with "+reader.aircraftId(ac)+"\n";
+    }
+  }
+  return s+"\n";
+}
+
+static std::string region2str(BandsRegion::Region r) {
+  switch (r) {
+  case BandsRegion::NONE: return "0";
+  case BandsRegion::FAR: return "1";
+  case BandsRegion::MID: return "2";
+  case BandsRegion::NEAR: return "3";
+  case BandsRegion::RECOVERY: return "4";
+  default: return "-1";
+  }
+}
+
+/*
+ * Input of drawmultibands.py, as produced by DrawMultiBands, for the steps of the first input file in
+ * reader. Bands are in the units of the configuration of the writer, except track bands, which are in degrees.
+ */
+static bool draw(BandsReader& reader, std::ostream& out) {
+  static const char* bands_names[BANDS_DIMENSIONS] = { "TrkBands", "GsBands", "VsBands", "AltBands" };
+  static const char* min_max_names[BANDS_DIMENSIONS] = { "", "MinMaxGs", "MinMaxVs", "MinMaxAlt" };
+  static const char* own_names[BANDS_DIMENSIONS] = { "OwnTrk", "OwnGs", "OwnVs", "OwnAlt" };
+  std::string units[BANDS_DIMENSIONS];
+  for (int d = 0; d < BANDS_DIMENSIONS; ++d) {
+    units[d] = reader.units((BandsDimension)d);
+  }
+  units[BANDS_TRK] = "deg";
+  std::string scenario = "";
+  std::string ownship = "";
+  std::string str_to = "";
+  std::string str_own[BANDS_DIMENSIONS];
+  std::string str_bands[BANDS_DIMENSIONS];
+  std::vector<std::string> alerting_ids;
+  std::map<std::string,std::string> alerting_times;
+  int files = 0;
+  for (int kind = reader.next(); kind != 0; kind = reader.next()) {
+    if (kind == BandsRecordHeader::INPUT_FILE) {
+      if (++files > 1) {
+        std::cerr << "** Warning: Only the steps of " << scenario << " are drawn" << std::endl;
+        break;
+      }
+      std::string name = reader.text();
+      name = name.substr(name.find_last_of('/')+1);
+      scenario = name.find('.') != std::string::npos ? name.substr(0,name.find_last_of('.')) : name;
+    } else if (kind == BandsRecordHeader::STEP) {
+      const BandsStepRecord& step = reader.step();
+      ownship = reader.aircraftId(0);
+      str_to += Fm8(step.time)+" ";
+      for (int d = 0; d < BANDS_DIMENSIONS; ++d) {
+        double own = d == BANDS_TRK ? Util::to_pi(step.dims[d].ownship) : step.dims[d].ownship;
+        str_own[d] += Fm8(Units::to(units[d],own))+" ";
+        str_bands[d] += std::string(bands_names[d])+":"+Fm8(step.time)+":";
+        for (int i = 0; i < reader.length((BandsDimension)d); ++i) {
+          Interval ia = reader.interval((BandsDimension)d,i);
+          if (!ia.isEmpty()) {
+            ia = Interval(Units::to(units[d],ia.low),Units::to(units[d],ia.up));
+          }
+          str_bands[d] += ia.toString()+" "+region2str(reader.region((BandsDimension)d,i))+" ";
+        }
+        str_bands[d] += "\n";
+      }
+      for (int ac = 1; ac <= reader.trafficSize(); ++ac) {
+        int alert = reader.aircraft(ac).alert;
+        if (alert > 0) {
+          std::string id = reader.aircraftId(ac);
+          if (alerting_times.find(id) == alerting_times.end()) {
+            alerting_ids.push_back(id);
+            alerting_times[id] = "AlertingTimes:"+id+":";
+          }
+          alerting_times[id] += Fm8(step.time)+" "+Fmi(alert)+" ";
+        }
+      }
+    }
+  }
+  if (reader.hasError()) {
+    return false;
+  }
+  const BandsFileHeader& header = reader.header();
+  out << "# This file can be processed with the Python script drawmultibands.py" << std::endl;
+  out << "Scenario:" << scenario << std::endl;
+  out << "Ownship:" << ownship << std::endl;
+  out << "# Bands Encoding" << std::endl;
+  out << "# NONE = " << region2str(BandsRegion::NONE) << std::endl;
+  out << "# FAR = " << region2str(BandsRegion::FAR) << std::endl;
+  out << "# MID = " << region2str(BandsRegion::MID) << std::endl;
+  out << "# NEAR = " << region2str(BandsRegion::NEAR) << std::endl;
+  out << "# RECOVERY = " << region2str(BandsRegion::RECOVERY) << std::endl;
+  for (int d = BANDS_GS; d < BANDS_DIMENSIONS; ++d) {
+    out << min_max_names[d] << ":" << FmPrecision(Units::to(units[d],header.min[d])) << " " <<
+        FmPrecision(Units::to(units[d],header.max[d])) << ":" << units[d] << std::endl;
+  }
+  for (int d = 0; d < BANDS_DIMENSIONS; ++d) {
+    out << str_bands[d];
+  }
+  out << "MostSevereAlertLevel:" << header.most_severe_alert_level << std::endl;
+  for (int i = 0; i < (int)alerting_ids.size(); ++i) {
+    out << alerting_times[alerting_ids[i]] << std::endl;
+  }
+  out << "Times:" << str_to << std::endl;
+  for (int d = 0; d < BANDS_DIMENSIONS; ++d) {
+    out << own_names[d] << ":" << str_own[d] << std::endl;
+  }
+  return true;
+}
+
+static bool standard(BandsReader& reader, std::ostream& out) {
+  for (int kind = reader.next(); kind != 0; kind = reader.next()) {
+    if (kind == BandsRecordHeader::TEXT) {
+      out << reader.text();
+    } else if (kind == BandsRecordHeader::INPUT_FILE) {
+      out << "# File: " << reader.text() << std::endl;
+    } else {
+      out << standard_step(reader);
+    }
+  }
+  return !reader.hasError();
+}
+
+static void printHelpMsg() {
+  std::cerr << "Usage:" << std::endl;
+  std::cerr << "  DaidalusBandsConverter [<option>] <bands_file>" << std::endl;
+  std::cerr << "  Convert <bands_file>, written by DaidalusBatch --binary, to the standard output format of DaidalusBatch" << std::endl;
+  std::cerr << "  <option> can be" << std::endl;
+  std::cerr << "  --out <output_file>\n\tOutput information to <output_file>" << std::endl;
+  std::cerr << "  --draw\n\tProduce the input of the Python script drawmultibands.py instead" << std::endl;
+  std::cerr << "  --help\n\tPrint this message" << std::endl;
+  exit(0);
+}
+
+int main(int argc, char* argv[]) {
+  std::string input_file = "";
+  std::string output_file = "";
+  bool to_draw = false;
+  for (int a=1; a < argc; ++a) {
+    std::string arga = argv[a];
+    if ((startsWith(arga,"--o") || startsWith(arga,"-o")) && a+1 < argc) {
+      output_file = argv[++a];
+    } else if (arga == "--draw" || arga == "-draw") {
+      to_draw = true;
+    } else if (startsWith(arga,"--h") || startsWith(arga,"-h")) {
+      printHelpMsg();
+    } else if (startsWith(arga,"-") && arga != "-") {
+      std::cerr << "** Error: Unknown option " << arga << std::endl;
+      exit(1);
+    } else if (input_file == "") {
+      input_file = arga;
+    } else {
+      std::cerr << "** Error: Only one input file can be provided (" << a << ")" << std::endl;
+      exit(1);
+    }
+  }
+  if (input_file == "") {
+    printHelpMsg();
+  }
+  BandsReader reader;
+  if (!reader.open(input_file)) {
+    std::cerr << "** Error: " << reader.getMessage() << std::endl;
+    exit(1);
+  }
+  std::ofstream fout;
+  std::ostream* out = &std::cout;
+  if (output_file != "") {
+    fout.open(output_file.c_str());
+    out = &fout;
+  }
+  bool ok = to_draw ? draw(reader,*out) : standard(reader,*out);
+  if (!ok) {
+    std::cerr << "** Error: " << reader.getMessage() << std::endl;
+    exit(1);
+  }
+  return 0;
+}
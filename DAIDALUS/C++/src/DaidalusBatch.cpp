@@ -11,11 +11,15 @@
 #include <iostream>
 #include <fstream>
 #include "DaidalusProcessor.h"
+#include "BandsWriter.h"
+#include "LatencyProfile.h"
+#include <chrono>
 
 using namespace larcfm;
 
 const int STANDARD = 0;
 const int PVS = 1;
+const int BINARY = 2;
 const int precision = 10;
 
 
@@ -28,6 +32,11 @@ public:
 	int format;
 	std::ostream* out;
 	double prj_t;
+	BandsWriter writer;
+	bool profile;
+	LatencyProfile latencies;
+	// Phases of a time step in latencies
+	int read_phase, setup_phase, trk_phase, gs_phase, vs_phase, alt_phase, alerting_phase, output_phase, total_phase;
 
 	DaidalusBatch() {
 		verbose = false;
@@ -35,6 +44,20 @@ public:
 		format = STANDARD;
 		out = &std::cout;
 		prj_t = 0;
+		profile = false;
+		read_phase = latencies.addPhase("read");
+		setup_phase = latencies.addPhase("setup");
+		trk_phase = latencies.addPhase("trk");
+		gs_phase = latencies.addPhase("gs");
+		vs_phase = latencies.addPhase("vs");
+		alt_phase = latencies.addPhase("alt");
+		alerting_phase = latencies.addPhase("alerting");
+		output_phase = latencies.addPhase("output");
+		total_phase = latencies.addPhase("total");
+	}
+
+	static double now() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
 	}
 
 	static void printHelpMsg() {
@@ -47,7 +70,9 @@ public:
 		std::cout << "  --verbose\n\tPrint extra information" << std::endl;
 		std::cout << "  --raw\n\tPrint raw information" << std::endl;
 		std::cout << "  --pvs\n\tProduce PVS output format" << std::endl;
+		std::cout << "  --binary\n\tProduce binary output format, which DaidalusBandsConverter turns into the standard output format.\n\tOption --raw doesn't apply" << std::endl;
 		std::cout << "  --project t\n\tLinearly project all aircraft t seconds for computing bands and alerting" << std::endl;
+		std::cout << "  --profile\n\tPrint in standard error the latency percentiles of each phase of a time step (read, setup,\n\tbands of each dimension, alerting, output) and the slowest time steps. In binary format,\n\talerting is part of output" << std::endl;
 		std::cout << "  --<var>=<val>\n\t<key> is any configuration variable and val is its value (including units, if any), e.g., --lookahead_time=5[min]" << std::endl;
 		std::cout << getHelpString() << std::endl;
 		exit(0);
@@ -136,13 +161,13 @@ public:
 		}
 	}
 
-	void alerting(Daidalus& daa) {
+	void alerting(Daidalus& daa, const std::vector<int>& alerts) {
 		std::string s="";
 		bool comma = false;
 		switch (format) {
 		case STANDARD:
 			for (int ac=1; ac <= daa.lastTrafficIndex(); ++ac) {
-				int alert_ac = daa.alerting(ac);
+				int alert_ac = alerts[ac-1];
 				if (alert_ac > 0) {
 					(*out) << s << "Alert " << alert_ac << " with " << daa.getAircraftState(ac).getId() << std::endl;
 				}
@@ -157,7 +182,7 @@ public:
 				} else {
 					comma = true;
 				}
-				s += daa.alerting(ac);
+				s += alerts[ac-1];
 			}
 			s += " :)";
 			(*out) << "%%% Alerting:\n" << s << std::endl;
@@ -168,13 +193,50 @@ public:
 	}
 
 	void processTime(Daidalus& daa, const std::string& filename) {
+		double time = daa.getCurrentTime();
+		double t0 = now();
 		daa.setCurrentTime(daa.getCurrentTime()+prj_t);
 		KinematicMultiBands kb;
 		daa.kinematicMultiBands(kb);
-		header(daa,kb,filename);
-		bands(kb);
-		intervalOfConflict(daa);
-		alerting(daa);
+		double t1 = now();
+		if (profile) {
+			// Bands are computed on demand. They are computed here, so that each dimension is timed.
+			double t = t1;
+			kb.trackLength();
+			latencies.add(trk_phase,now()-t,filename,time);
+			t = now();
+			kb.groundSpeedLength();
+			latencies.add(gs_phase,now()-t,filename,time);
+			t = now();
+			kb.verticalSpeedLength();
+			latencies.add(vs_phase,now()-t,filename,time);
+			t = now();
+			kb.altitudeLength();
+			latencies.add(alt_phase,now()-t,filename,time);
+		}
+		double t2 = now();
+		std::vector<int> alerts;
+		if (format == BINARY) {
+			writer.write(daa,kb);
+		} else {
+			daa.alertingAll(alerts);
+			double t = now();
+			if (profile) {
+				latencies.add(alerting_phase,t-t2,filename,time);
+			}
+			t2 = t;
+			header(daa,kb,filename);
+			bands(kb);
+			intervalOfConflict(daa);
+			alerting(daa,alerts);
+		}
+		if (profile) {
+			double t3 = now();
+			latencies.add(read_phase,getReadTime(),filename,time);
+			latencies.add(setup_phase,t1-t0,filename,time);
+			latencies.add(output_phase,t3-t2,filename,time);
+			latencies.add(total_phase,getReadTime()+t3-t0,filename,time);
+		}
 	}
 
 };
@@ -208,6 +270,10 @@ int main(int argc, const char* argv[]) {
 			walker.raw = true;
 		} else if (arga == "--pvs" || arga == "-pvs") {
 			walker.format = PVS;
+		} else if (arga == "--binary" || arga == "-binary") {
+			walker.format = BINARY;
+		} else if (arga == "--profile" || arga == "-profile") {
+			walker.profile = true;
 		} else if (startsWith(arga,"--proj") || startsWith(arga,"-proj")) {
 			++a;
 			walker.prj_t = Util::parse_double(argv[a]);
@@ -229,7 +295,7 @@ int main(int argc, const char* argv[]) {
 		walker.printHelpMsg();
 	}
 	std::ofstream fout;
-	if (output != "") {
+	if (output != "" && walker.format != BINARY) {
 		fout.open(output.c_str());
 		walker.out = &fout;
 	}
@@ -255,6 +321,15 @@ int main(int argc, const char* argv[]) {
 		(*walker.out) << "%%% Options: " << options << std::endl;
 		(*walker.out) << "%%% Parameters:\n"+daa.parameters.toPVS(precision) << std::endl;
 		break;
+	case BINARY:
+		if (!walker.writer.open(output != "" ? output : "-",daa.parameters)) {
+			std::cerr << "** Error: " << walker.writer.getMessage() << std::endl;
+			exit(1);
+		}
+		if (walker.verbose) {
+			walker.writer.writeText("# "+Daidalus::release()+"\n# Options: "+options+"\n#\n"+daa.toString()+"#\n\n");
+		}
+		break;
 	default:
 		break;
 	}
@@ -267,14 +342,23 @@ int main(int argc, const char* argv[]) {
 		case PVS:
 			(*walker.out) << "%%% File: " << filename << std::endl;
 			break;
+		case BINARY:
+			walker.writer.writeFile(filename);
+			break;
 		default:
 			break;
 		}
 		walker.processFile(filename,daa);
 	}
-	if (output != "") {
+	if (walker.format == BINARY) {
+		walker.writer.close();
+	} else if (output != "") {
 		fout.close();
 	}
+	if (walker.profile) {
+		std::cerr << "** Profile of " << walker.latencies.getHistogram(walker.total_phase).count() <<
+				" time steps" << std::endl << walker.latencies.toString();
+	}
 
 }//main
 
@@ -0,0 +1,683 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "DaidalusCheckpoint.h"
+#include "NoneUrgencyStrategy.h"
+#include "DCPAUrgencyStrategy.h"
+#include "FixedAircraftUrgencyStrategy.h"
+#include "ParameterData.h"
+#include "Projection.h"
+#include "IntervalSet.h"
+#include "BandsRange.h"
+#include <cstring>
+#include <cstdio>
+
+namespace larcfm {
+
+const uint32_t DaidalusCheckpoint::MAGIC;
+const uint32_t DaidalusCheckpoint::VERSION;
+
+// Kinds of urgency strategies
+enum { URGENCY_NONE, URGENCY_DCPA, URGENCY_FIXED, URGENCY_OTHER };
+
+// Kinds of parameter entries
+enum { ENTRY_NUMBER, ENTRY_STRING };
+
+/*
+ * Appends values to a snapshot. Strings are stored as their size followed by their characters.
+ */
+class DaidalusCheckpoint::Writer {
+public:
+  std::vector<char>& out;
+
+  Writer(std::vector<char>& data) : out(data) {}
+
+  void bytes(const void* p, unsigned long size) {
+    const char* c = static_cast<const char*>(p);
+    out.insert(out.end(),c,c+size);
+  }
+  void u32(uint32_t val) { bytes(&val,sizeof(uint32_t)); }
+  void i32(int32_t val) { bytes(&val,sizeof(int32_t)); }
+  void flag(bool val) { u32(val ? 1 : 0); }
+  void real(double val) { bytes(&val,sizeof(double)); }
+  void str(const std::string& s) {
+    u32(s.size());
+    bytes(s.data(),s.size());
+  }
+  void vect3(const Vect3& v) {
+    real(v.x);
+    real(v.y);
+    real(v.z);
+  }
+  void interval(const Interval& i) {
+    real(i.low);
+    real(i.up);
+  }
+  void intervalSet(const IntervalSet& set) {
+    u32(set.size());
+    for (int i = 0; i < set.size(); ++i) {
+      interval(set.getInterval(i));
+    }
+  }
+
+  /*
+   * Traffic state with the origin of its projection. Cartesian position and velocity are stored, so
+   * that they don't have to be projected again.
+   */
+  void state(const TrafficState& ac) {
+    str(ac.getId());
+    flag(ac.isLatLon());
+    const Position& pos = ac.getPosition();
+    if (pos.isLatLon()) {
+      real(pos.lat());
+      real(pos.lon());
+      real(pos.alt());
+    } else {
+      vect3(pos.point());
+    }
+    vect3(ac.getVelocity());
+    vect3(ac.get_s());
+    vect3(ac.get_v());
+    real(ac.getTime());
+    LatLonAlt origin = ac.eprj_.getProjectionPoint();
+    real(origin.lat());
+    real(origin.lon());
+    real(origin.alt());
+  }
+
+  /*
+   * Aircraft of a list of traffic states that is a subset of traffic, as indices into traffic.
+   */
+  void aircraft(const std::vector<TrafficState>& acs, const std::vector<TrafficState>& traffic) {
+    u32(acs.size());
+    for (TrafficState::nat i = 0; i < acs.size(); ++i) {
+      i32(index(acs[i],traffic));
+    }
+  }
+
+  /*
+   * Index of ac in traffic, -1 if it isn't there
+   */
+  static int index(const TrafficState& ac, const std::vector<TrafficState>& traffic) {
+    for (TrafficState::nat i = 0; i < traffic.size(); ++i) {
+      if (traffic[i].getId() == ac.getId() && traffic[i].get_s().x == ac.get_s().x &&
+          traffic[i].get_s().y == ac.get_s().y && traffic[i].get_s().z == ac.get_s().z) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  void parameters(const KinematicBandsParameters& parameters) {
+    unsigned long start = out.size();
+    u32(0); // Size of the section, set below
+    ParameterData p = parameters.getParameters();
+    std::vector<std::string> keys = p.getList();
+    u32(keys.size());
+    for (unsigned int i = 0; i < keys.size(); ++i) {
+      str(keys[i]);
+      if (p.isNumber(keys[i])) {
+        u32(ENTRY_NUMBER);
+        real(p.getValue(keys[i]));
+        str(p.getUnit(keys[i]));
+      } else {
+        u32(ENTRY_STRING);
+        str(p.getString(keys[i]));
+      }
+    }
+    uint32_t size = out.size()-start-sizeof(uint32_t);
+    std::memcpy(&out[start],&size,sizeof(uint32_t));
+  }
+
+};
+
+/*
+ * Reads values from a snapshot. Reading past the end of the snapshot sets failed and returns zeros.
+ */
+class DaidalusCheckpoint::Reader {
+public:
+  const char* p;
+  const char* end;
+  bool failed;
+  // Last projection that has been restored, which is usually the one of the next state
+  bool has_eprj;
+  LatLonAlt eprj_origin;
+  EuclideanProjection eprj;
+
+  Reader(const std::vector<char>& data) : p(data.empty() ? NULL : &data[0]), end(p+data.size()),
+      failed(false), has_eprj(false) {}
+
+  bool bytes(void* dst, unsigned long size) {
+    if (failed || (unsigned long)(end-p) < size) {
+      failed = true;
+      std::memset(dst,0,size);
+      return false;
+    }
+    std::memcpy(dst,p,size);
+    p += size;
+    return true;
+  }
+  uint32_t u32() { uint32_t val; bytes(&val,sizeof(uint32_t)); return val; }
+  int32_t i32() { int32_t val; bytes(&val,sizeof(int32_t)); return val; }
+  bool flag() { return u32() != 0; }
+  double real() { double val; bytes(&val,sizeof(double)); return val; }
+  std::string str() {
+    uint32_t size = u32();
+    if (failed || (unsigned long)(end-p) < size) {
+      failed = true;
+      return "";
+    }
+    std::string s(p,size);
+    p += size;
+    return s;
+  }
+  Vect3 vect3() {
+    double x = real();
+    double y = real();
+    double z = real();
+    return Vect3(x,y,z);
+  }
+  Interval interval() {
+    double low = real();
+    double up = real();
+    return Interval(low,up);
+  }
+  IntervalSet intervalSet() {
+    uint32_t size = u32();
+    if (size > (uint32_t)IntervalSet::max_intervals) {
+      failed = true;
+      return IntervalSet();
+    }
+    std::vector<Interval> v;
+    v.reserve(size);
+    for (uint32_t i = 0; i < size && !failed; ++i) {
+      v.push_back(interval());
+    }
+    return failed || v.empty() ? IntervalSet() : IntervalSet(v);
+  }
+  /* Check that a list of size elements of at least element_size bytes each fits in the snapshot */
+  bool fits(uint32_t size, unsigned long element_size) {
+    if (failed || (unsigned long)(end-p)/element_size < size) {
+      failed = true;
+    }
+    return !failed;
+  }
+
+  TrafficState state() {
+    std::string id = str();
+    bool latlon = flag();
+    Position pos;
+    if (latlon) {
+      double lat = real();
+      double lon = real();
+      double alt = real();
+      pos = Position::mkLatLonAlt(lat,lon,alt);
+    } else {
+      pos = Position(vect3());
+    }
+    Velocity vel = Velocity::make(vect3());
+    Vect3 s = vect3();
+    Velocity v = Velocity::make(vect3());
+    double time = real();
+    double lat = real();
+    double lon = real();
+    double alt = real();
+    if (!has_eprj || lat != eprj_origin.lat() || lon != eprj_origin.lon() || alt != eprj_origin.alt()) {
+      eprj_origin = LatLonAlt::mk(lat,lon,alt);
+      eprj = Projection::createProjection(eprj_origin);
+      has_eprj = true;
+    }
+    return TrafficState(id,pos,vel,s,v,time,eprj);
+  }
+
+  void aircraft(std::vector<TrafficState>& acs, const std::vector<TrafficState>& traffic) {
+    uint32_t size = u32();
+    acs.clear();
+    if (!fits(size,sizeof(int32_t))) {
+      return;
+    }
+    acs.reserve(size);
+    for (uint32_t i = 0; i < size; ++i) {
+      int32_t k = i32();
+      acs.push_back(0 <= k && k < (int)traffic.size() ? traffic[k] : TrafficState::INVALID);
+    }
+  }
+
+  void states(std::vector<TrafficState>& traffic) {
+    uint32_t size = u32();
+    traffic.clear();
+    if (!fits(size,sizeof(uint32_t))) {
+      return;
+    }
+    traffic.reserve(size);
+    for (uint32_t i = 0; i < size && !failed; ++i) {
+      traffic.push_back(state());
+    }
+  }
+
+};
+
+DaidalusCheckpoint::DaidalusCheckpoint() : error("DaidalusCheckpoint") {}
+
+void DaidalusCheckpoint::save(const Daidalus& daa) {
+  data_.clear();
+  Writer out(data_);
+  CheckpointHeader header;
+  std::memset(&header,0,sizeof(CheckpointHeader));
+  out.bytes(&header,sizeof(CheckpointHeader));
+  save_daidalus(out,daa);
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.size = data_.size();
+  std::memcpy(&data_[0],&header,sizeof(CheckpointHeader));
+}
+
+void DaidalusCheckpoint::save(const Daidalus& daa, const KinematicMultiBands& kb) {
+  save(daa);
+  Writer out(data_);
+  save_bands(out,kb);
+  CheckpointHeader* header = (CheckpointHeader*)&data_[0];
+  header->flags |= CheckpointHeader::HAS_BANDS;
+  header->size = data_.size();
+}
+
+void DaidalusCheckpoint::save_daidalus(Writer& out, const Daidalus& daa) const {
+  out.parameters(daa.parameters);
+  out.real(daa.current_time_);
+  out.vect3(daa.wind_vector_);
+  const UrgencyStrategy* strat = daa.urgency_strat_;
+  if (dynamic_cast<const NoneUrgencyStrategy*>(strat) != NULL) {
+    out.u32(URGENCY_NONE);
+  } else if (dynamic_cast<const DCPAUrgencyStrategy*>(strat) != NULL) {
+    out.u32(URGENCY_DCPA);
+  } else if (dynamic_cast<const FixedAircraftUrgencyStrategy*>(strat) != NULL) {
+    out.u32(URGENCY_FIXED);
+    out.str(dynamic_cast<const FixedAircraftUrgencyStrategy*>(strat)->getFixedAircraftId());
+  } else {
+    out.u32(URGENCY_OTHER);
+  }
+  out.state(daa.ownship_);
+  out.u32(daa.traffic_.size());
+  for (TrafficState::nat i = 0; i < daa.traffic_.size(); ++i) {
+    out.state(daa.traffic_[i]);
+  }
+}
+
+void DaidalusCheckpoint::save_bands(Writer& out, const KinematicMultiBands& kb) const {
+  const KinematicBandsCore& core = kb.core_;
+  out.parameters(core.parameters);
+  out.state(core.ownship);
+  out.u32(core.traffic.size());
+  for (TrafficState::nat i = 0; i < core.traffic.size(); ++i) {
+    out.state(core.traffic[i]);
+  }
+  out.state(core.most_urgent_ac);
+  out.flag(core.outdated_);
+  out.i32(core.epsh_);
+  out.i32(core.epsv_);
+  out.u32(core.conflict_acs_.size());
+  for (unsigned int i = 0; i < core.conflict_acs_.size(); ++i) {
+    out.aircraft(core.conflict_acs_[i],core.traffic);
+  }
+  out.u32(core.tiov_.size());
+  for (unsigned int i = 0; i < core.tiov_.size(); ++i) {
+    out.interval(core.tiov_[i]);
+  }
+  out.i32(core.current_alert_);
+  save_real_bands(out,kb.trk_band_,core.traffic);
+  save_real_bands(out,kb.gs_band_,core.traffic);
+  save_real_bands(out,kb.vs_band_,core.traffic);
+  save_real_bands(out,kb.alt_band_,core.traffic);
+  save_real_bands(out,kb.spread_trk_band_,core.traffic);
+  save_real_bands(out,kb.spread_gs_band_,core.traffic);
+  save_real_bands(out,kb.spread_vs_band_,core.traffic);
+  save_real_bands(out,kb.spread_alt_band_,core.traffic);
+}
+
+void DaidalusCheckpoint::save_real_bands(Writer& out, const KinematicRealBands& band,
+    const std::vector<TrafficState>& traffic) const {
+  out.real(band.min_);
+  out.real(band.max_);
+  out.flag(band.rel_);
+  out.real(band.mod_);
+  out.flag(band.circular_);
+  out.real(band.step_);
+  out.flag(band.recovery_);
+  out.flag(band.outdated_);
+  out.i32(band.checked_);
+  out.u32(band.peripheral_acs_.size());
+  for (unsigned int i = 0; i < band.peripheral_acs_.size(); ++i) {
+    out.aircraft(band.peripheral_acs_[i],traffic);
+  }
+  out.u32(band.peripheral_outdated_.size());
+  for (unsigned int i = 0; i < band.peripheral_outdated_.size(); ++i) {
+    out.flag(band.peripheral_outdated_[i]);
+  }
+  out.u32(band.ranges_.size());
+  for (BandsRange::nat i = 0; i < band.ranges_.size(); ++i) {
+    out.interval(band.ranges_[i].interval);
+    out.i32(band.ranges_[i].region);
+  }
+  out.real(band.recovery_time_);
+  out.u32(band.resolutions_.size());
+  for (unsigned int i = 0; i < band.resolutions_.size(); ++i) {
+    out.interval(band.resolutions_[i]);
+  }
+  out.u32(band.none_sets_.size());
+  for (unsigned int i = 0; i < band.none_sets_.size(); ++i) {
+    out.intervalSet(band.none_sets_[i]);
+  }
+  out.u32(band.regions_.size());
+  for (unsigned int i = 0; i < band.regions_.size(); ++i) {
+    out.i32(band.regions_[i]);
+  }
+  out.i32(band.stage_);
+  out.intervalSet(band.conflict_none_set_);
+  out.flag(band.interrupted_);
+}
+
+bool DaidalusCheckpoint::check_header() {
+  if (data_.size() < sizeof(CheckpointHeader)) {
+    error.addError("Snapshot is truncated");
+    return false;
+  }
+  const CheckpointHeader* header = (const CheckpointHeader*)&data_[0];
+  if (header->magic != MAGIC) {
+    error.addError("Data is not a snapshot");
+    return false;
+  }
+  if (header->version != VERSION) {
+    error.addError("Snapshot has an unsupported version");
+    return false;
+  }
+  if (header->size != data_.size()) {
+    error.addError("Snapshot is truncated");
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Read a parameters section into parameters, unless it's the same as the last one, which is kept in
+ * parameters_data
+ */
+bool DaidalusCheckpoint::restore_parameters(Reader& in, std::vector<char>& parameters_data,
+    KinematicBandsParameters& parameters) {
+  uint32_t size = in.u32();
+  if (in.failed || (unsigned long)(in.end-in.p) < size) {
+    in.failed = true;
+    return false;
+  }
+  const char* section = in.p;
+  in.p += size;
+  if (parameters_data.size() == size && size > 0 && std::memcmp(&parameters_data[0],section,size) == 0) {
+    return true;
+  }
+  std::vector<char> data(section,section+size);
+  Reader entries(data);
+  ParameterData p;
+  uint32_t n = entries.u32();
+  for (uint32_t i = 0; i < n && !entries.failed; ++i) {
+    std::string key = entries.str();
+    if (entries.u32() == ENTRY_NUMBER) {
+      double val = entries.real();
+      p.setInternal(key,val,entries.str());
+    } else {
+      p.set(key,entries.str());
+    }
+  }
+  if (entries.failed) {
+    in.failed = true;
+    return false;
+  }
+  parameters = KinematicBandsParameters();
+  parameters.setParameters(p);
+  parameters_data.swap(data);
+  return true;
+}
+
+/*
+ * State of a Daidalus object, other than its parameters, as read from a snapshot
+ */
+class DaidalusCheckpoint::State {
+public:
+  double current_time;
+  Velocity wind;
+  uint32_t urgency;
+  std::string fixed_id;
+  TrafficState ownship;
+  std::vector<TrafficState> traffic;
+};
+
+bool DaidalusCheckpoint::read_daidalus(Reader& in, State& state) {
+  if (!restore_parameters(in,daa_parameters_data_,daa_parameters_)) {
+    return false;
+  }
+  state.current_time = in.real();
+  state.wind = Velocity::make(in.vect3());
+  state.urgency = in.u32();
+  state.fixed_id = state.urgency == URGENCY_FIXED ? in.str() : "";
+  state.ownship = in.state();
+  in.states(state.traffic);
+  return !in.failed;
+}
+
+void DaidalusCheckpoint::restore_daidalus(State& state, Daidalus& daa) {
+  daa.parameters = daa_parameters_;
+  daa.current_time_ = state.current_time;
+  daa.wind_vector_ = state.wind;
+  if (state.urgency == URGENCY_NONE) {
+    NoneUrgencyStrategy strat;
+    daa.setUrgencyStrategy(&strat);
+  } else if (state.urgency == URGENCY_DCPA) {
+    DCPAUrgencyStrategy strat;
+    daa.setUrgencyStrategy(&strat);
+  } else if (state.urgency == URGENCY_FIXED) {
+    FixedAircraftUrgencyStrategy strat(state.fixed_id);
+    daa.setUrgencyStrategy(&strat);
+  } else {
+    error.addWarning("Urgency strategy of the snapshot is unknown, the current one is kept");
+  }
+  daa.ownship_ = state.ownship;
+  daa.traffic_.swap(state.traffic);
+  daa.index_traffic();
+}
+
+bool DaidalusCheckpoint::restore_bands(Reader& in, KinematicMultiBands& kb) {
+  if (!restore_parameters(in,kb_parameters_data_,kb_parameters_)) {
+    return false;
+  }
+  kb.setKinematicBandsParameters(kb_parameters_);
+  kb.update_spread_bands();
+  KinematicBandsCore& core = kb.core_;
+  core.ownship = in.state();
+  in.states(core.traffic);
+  core.most_urgent_ac = in.state();
+  core.outdated_ = in.flag();
+  core.epsh_ = in.i32();
+  core.epsv_ = in.i32();
+  uint32_t size = in.u32();
+  core.conflict_acs_.clear();
+  if (in.fits(size,sizeof(uint32_t))) {
+    core.conflict_acs_.resize(size);
+    for (uint32_t i = 0; i < size; ++i) {
+      in.aircraft(core.conflict_acs_[i],core.traffic);
+    }
+  }
+  size = in.u32();
+  core.tiov_.clear();
+  if (in.fits(size,2*sizeof(double))) {
+    for (uint32_t i = 0; i < size; ++i) {
+      core.tiov_.push_back(in.interval());
+    }
+  }
+  core.current_alert_ = in.i32();
+  restore_real_bands(in,kb.trk_band_,core.traffic);
+  restore_real_bands(in,kb.gs_band_,core.traffic);
+  restore_real_bands(in,kb.vs_band_,core.traffic);
+  restore_real_bands(in,kb.alt_band_,core.traffic);
+  restore_real_bands(in,kb.spread_trk_band_,core.traffic);
+  restore_real_bands(in,kb.spread_gs_band_,core.traffic);
+  restore_real_bands(in,kb.spread_vs_band_,core.traffic);
+  restore_real_bands(in,kb.spread_alt_band_,core.traffic);
+  return !in.failed;
+}
+
+void DaidalusCheckpoint::restore_real_bands(Reader& in, KinematicRealBands& band,
+    const std::vector<TrafficState>& traffic) const {
+  band.min_ = in.real();
+  band.max_ = in.real();
+  band.rel_ = in.flag();
+  band.mod_ = in.real();
+  band.circular_ = in.flag();
+  band.step_ = in.real();
+  band.recovery_ = in.flag();
+  band.outdated_ = in.flag();
+  band.checked_ = in.i32();
+  uint32_t size = in.u32();
+  band.peripheral_acs_.clear();
+  if (in.fits(size,sizeof(uint32_t))) {
+    band.peripheral_acs_.resize(size);
+    for (uint32_t i = 0; i < size; ++i) {
+      in.aircraft(band.peripheral_acs_[i],traffic);
+    }
+  }
+  size = in.u32();
+  band.peripheral_outdated_.clear();
+  if (in.fits(size,sizeof(uint32_t))) {
+    for (uint32_t i = 0; i < size; ++i) {
+      band.peripheral_outdated_.push_back(in.flag());
+    }
+  }
+  size = in.u32();
+  band.ranges_.clear();
+  if (in.fits(size,2*sizeof(double)+sizeof(int32_t))) {
+    band.ranges_.reserve(size);
+    for (uint32_t i = 0; i < size; ++i) {
+      Interval interval = in.interval();
+      band.ranges_.push_back(BandsRange(interval,(BandsRegion::Region)in.i32()));
+    }
+  }
+  band.recovery_time_ = in.real();
+  size = in.u32();
+  band.resolutions_.clear();
+  if (in.fits(size,2*sizeof(double))) {
+    for (uint32_t i = 0; i < size; ++i) {
+      band.resolutions_.push_back(in.interval());
+    }
+  }
+  size = in.u32();
+  band.none_sets_.clear();
+  if (in.fits(size,sizeof(uint32_t))) {
+    for (uint32_t i = 0; i < size; ++i) {
+      band.none_sets_.push_back(in.intervalSet());
+    }
+  }
+  size = in.u32();
+  band.regions_.clear();
+  if (in.fits(size,sizeof(int32_t))) {
+    for (uint32_t i = 0; i < size; ++i) {
+      band.regions_.push_back((BandsRegion::Region)in.i32());
+    }
+  }
+  band.stage_ = in.i32();
+  band.conflict_none_set_ = in.intervalSet();
+  band.deadline_ = NULL;
+  band.interrupted_ = in.flag();
+}
+
+bool DaidalusCheckpoint::restore(Daidalus& daa) {
+  if (!check_header()) {
+    return false;
+  }
+  Reader in(data_);
+  in.p += sizeof(CheckpointHeader);
+  State state;
+  if (!read_daidalus(in,state)) {
+    error.addError("Snapshot is corrupted");
+    return false;
+  }
+  restore_daidalus(state,daa);
+  return true;
+}
+
+bool DaidalusCheckpoint::restore(Daidalus& daa, KinematicMultiBands& kb) {
+  if (!check_header()) {
+    kb.clear();
+    return false;
+  }
+  if (!hasBands()) {
+    error.addError("Snapshot doesn't hold bands");
+    kb.clear();
+    return false;
+  }
+  // Bands are restored first, so that daa isn't modified if they are corrupted
+  Reader in(data_);
+  in.p += sizeof(CheckpointHeader);
+  State state;
+  if (!read_daidalus(in,state)) {
+    error.addError("Snapshot is corrupted");
+    kb.clear();
+    return false;
+  }
+  if (!restore_bands(in,kb)) {
+    error.addError("Snapshot is corrupted");
+    kb.clear();
+    return false;
+  }
+  restore_daidalus(state,daa);
+  return true;
+}
+
+bool DaidalusCheckpoint::hasBands() const {
+  return data_.size() >= sizeof(CheckpointHeader) &&
+      (((const CheckpointHeader*)&data_[0])->flags & CheckpointHeader::HAS_BANDS) != 0;
+}
+
+const std::vector<char>& DaidalusCheckpoint::data() const {
+  return data_;
+}
+
+void DaidalusCheckpoint::setData(const char* data, unsigned long size) {
+  data_.assign(data,data+size);
+}
+
+bool DaidalusCheckpoint::writeToFile(const std::string& filename) const {
+  FILE* file = fopen(filename.c_str(),"wb");
+  if (file == NULL) {
+    error.addError("File "+filename+" cannot be written");
+    return false;
+  }
+  bool ok = data_.empty() || fwrite(&data_[0],data_.size(),1,file) == 1;
+  if (fclose(file) != 0 || !ok) {
+    error.addError("File "+filename+" cannot be written");
+    return false;
+  }
+  return true;
+}
+
+bool DaidalusCheckpoint::readFromFile(const std::string& filename) {
+  FILE* file = fopen(filename.c_str(),"rb");
+  if (file == NULL) {
+    error.addError("File "+filename+" cannot be read");
+    return false;
+  }
+  data_.clear();
+  char buffer[1 << 16];
+  unsigned long n;
+  while ((n = fread(buffer,1,sizeof(buffer),file)) > 0) {
+    data_.insert(data_.end(),buffer,buffer+n);
+  }
+  bool ok = !ferror(file);
+  fclose(file);
+  if (!ok) {
+    error.addError("File "+filename+" cannot be read");
+  }
+  return ok;
+}
+
+}
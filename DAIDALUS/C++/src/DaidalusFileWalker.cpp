@@ -22,8 +22,7 @@ void DaidalusFileWalker::init() {
   sr_.setWindowSize(1);
   index_ = 0;
   times_ = sr_.sequenceKeys();
-  if (times_.size() > 0)
-    sr_.setActive(times_[0]);
+  sr_.setActiveIndex(0);
 }
 
 void DaidalusFileWalker::resetInputFile(const std::string& filename) {
@@ -72,7 +71,7 @@ bool DaidalusFileWalker::goToTime(double t) {
 bool DaidalusFileWalker::goToTimeStep(int i) {
   if (0 <= i && (unsigned int)i < times_.size()) {
     index_ = i;
-    sr_.setActive(times_[index_]);
+    sr_.setActiveIndex(index_);
     return true;
   }
   return false;
@@ -100,16 +99,10 @@ void DaidalusFileWalker::goPrev() {
 }
 
 int DaidalusFileWalker::indexOfTime(double t) const {
-  int i = -1;
   if (t >= firstTime() && t <= lastTime()) {
-    i = 0;
-    for (; (unsigned int)i < times_.size()-1; ++i) {
-      if (t >= times_[i] && t < times_[i+1]) {
-        break;
-      }
-    }
+    return sr_.sequenceIndex(t);
   }
-  return i;
+  return -1;
 }
 
 void DaidalusFileWalker::readState(Daidalus& daa) {
@@ -6,6 +6,7 @@
 #include "Velocity.h"
 #include "Util.h"
 #include "string_util.h"
+#include <chrono>
 
 using namespace larcfm;
 
@@ -15,6 +16,7 @@ DaidalusProcessor::DaidalusProcessor() {
 	relative_ = 0;
 	options_ = "";
 	ownship_ = "";
+	read_time_ = 0;
 }
 
 DaidalusProcessor::DaidalusProcessor(const std::string& own) {
@@ -23,6 +25,7 @@ DaidalusProcessor::DaidalusProcessor(const std::string& own) {
 	relative_ = 0;
 	options_ = "";
 	ownship_ = own;
+	read_time_ = 0;
 }
 
 double DaidalusProcessor::getFrom() const {
@@ -41,6 +44,11 @@ std::string DaidalusProcessor::getOwnship() const {
 	return ownship_;
 }
 
+/* Time, in seconds, spent reading the states of the time step being processed */
+double DaidalusProcessor::getReadTime() const {
+	return read_time_;
+}
+
 std::string DaidalusProcessor::getHelpString() {
 	std::string s = "";
 	s += "  --ownship <id>\n\tSet ownship to aircraft with identifier <id>\n";
@@ -127,7 +135,9 @@ void DaidalusProcessor::processFile(const std::string& filename, Daidalus &daa)
 	if (dw.goToTime(from) && from <= to) {
 		while (!dw.atEnd() && dw.getTime() <= to) {
 			double t = dw.getTime();
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 			dw.readState(daa);
+			read_time_ = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
 			if (ownship_ != "") {
 				daa.resetOwnship(ownship_);
 				if (daa.hasError()) {
@@ -0,0 +1,375 @@
+/**
+
+Notices:
+
+Copyright 2019 United States Government as represented by the
+Administrator of the National Aeronautics and Space Administration. No
+copyright is claimed in the United States under Title 17,
+U.S. Code. All Other Rights Reserved.
+
+Disclaimers
+
+No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY
+WARRANTY OF ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY,
+INCLUDING, BUT NOT LIMITED TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE
+WILL CONFORM TO SPECIFICATIONS, ANY IMPLIED WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, OR FREEDOM FROM
+INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE ERROR
+FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER,
+CONSTITUTE AN ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT
+OF ANY RESULTS, RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY
+OTHER APPLICATIONS RESULTING FROM USE OF THE SUBJECT SOFTWARE.
+FURTHER, GOVERNMENT AGENCY DISCLAIMS ALL WARRANTIES AND LIABILITIES
+REGARDING THIRD-PARTY SOFTWARE, IF PRESENT IN THE ORIGINAL SOFTWARE,
+AND DISTRIBUTES IT "AS IS."
+
+Waiver and Indemnity: RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS
+AGAINST THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND
+SUBCONTRACTORS, AS WELL AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF
+THE SUBJECT SOFTWARE RESULTS IN ANY LIABILITIES, DEMANDS, DAMAGES,
+EXPENSES OR LOSSES ARISING FROM SUCH USE, INCLUDING ANY DAMAGES FROM
+PRODUCTS BASED ON, OR RESULTING FROM, RECIPIENT'S USE OF THE SUBJECT
+SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD HARMLESS THE UNITED
+STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL AS ANY
+PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.  RECIPIENT'S SOLE
+REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE, UNILATERAL
+TERMINATION OF THIS AGREEMENT.
+ **/
+
+#include "Daidalus.h"
+#include "DaidalusFileWalker.h"
+#include "KinematicMultiBands.h"
+#include "ScenarioGenerator.h"
+#include "SharedRecords.h"
+#include "LatencyHistogram.h"
+#include "string_util.h"
+#include "format.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <dirent.h>
+
+using namespace larcfm;
+
+/*
+ * Frames of a scenario, as traffic records. The records of frame f are records[start[f]] to
+ * records[start[f+1]-1], the first one being the ownship.
+ */
+class Scenario {
+
+public:
+
+  std::string name;
+  std::vector<TrafficRecord> records;
+  std::vector<int> start;
+
+  int numberOfFrames() const {
+    return start.empty() ? 0 : start.size()-1;
+  }
+
+  /* Largest number of aircraft, including the ownship, in a frame */
+  int maxAircraft() const {
+    int n = 0;
+    for (int f = 0; f < numberOfFrames(); ++f) {
+      n = Util::max(n,start[f+1]-start[f]);
+    }
+    return n;
+  }
+
+  void generate(const ScenarioGenerator& gen) {
+    name = "generated";
+    records.clear();
+    start.clear();
+    Position pos;
+    Velocity vel;
+    for (int f = 0; f < gen.numberOfFrames(); ++f) {
+      start.push_back(records.size());
+      double t = gen.frameTime(f);
+      for (int ac = 0; ac < gen.aircraft; ++ac) {
+        gen.state(ac,t,pos,vel);
+        records.push_back(TrafficRecord());
+        records.back().set(gen.getId(ac),pos,vel,t,ac == 0 ? TrafficRecord::OWNSHIP : 0);
+      }
+    }
+    start.push_back(records.size());
+  }
+
+  /*
+   * Read a file of traffic records, as written by DaidalusScenarioGenerator --binary, or a file in
+   * DAIDALUS format. Return false if the file cannot be read or if it has identifiers that don't fit in
+   * traffic records.
+   */
+  bool read(const std::string& filename) {
+    name = filename;
+    records.clear();
+    start.clear();
+    if (readBinary(filename)) {
+      return true;
+    }
+    records.clear();
+    start.clear();
+    std::ifstream in(filename.c_str());
+    if (!in) {
+      return false;
+    }
+    in.close();
+    DaidalusFileWalker walker(filename);
+    Daidalus daa;
+    while (!walker.atEnd()) {
+      walker.readState(daa);
+      start.push_back(records.size());
+      for (int ac = 0; ac <= daa.lastTrafficIndex(); ++ac) {
+        const TrafficState& state = daa.getAircraftState(ac);
+        records.push_back(TrafficRecord());
+        if (!records.back().set(state.getId(),state.getPosition(),state.getVelocity(),daa.getCurrentTime(),
+            ac == 0 ? TrafficRecord::OWNSHIP : 0)) {
+          return false;
+        }
+      }
+    }
+    start.push_back(records.size());
+    return true;
+  }
+
+private:
+
+  /* A file of traffic records is a whole number of records, the last one ending the stream */
+  bool readBinary(const std::string& filename) {
+    FILE* file = fopen(filename.c_str(),"rb");
+    if (file == NULL) {
+      return false;
+    }
+    TrafficRecord rec;
+    bool ended = false;
+    while (!ended && fread(&rec,sizeof(TrafficRecord),1,file) == 1) {
+      if (rec.flags & TrafficRecord::END_OF_STREAM) {
+        ended = true;
+      } else {
+        if ((rec.flags & TrafficRecord::OWNSHIP) || start.empty()) {
+          start.push_back(records.size());
+        }
+        records.push_back(rec);
+      }
+    }
+    ended = ended && fgetc(file) == EOF;
+    fclose(file);
+    start.push_back(records.size());
+    return ended;
+  }
+
+};
+
+/*
+ * Times per cycle of Daidalus over the frames of a scenario. A cycle sets the states of the frame,
+ * computes the alert levels of all traffic aircraft, and computes the bands of all dimensions.
+ */
+class ScalingStudy {
+
+public:
+
+  int warmup;   // Number of untimed cycles before the timed ones
+  bool verbose;
+
+  ScalingStudy() : warmup(1), verbose(false) {}
+
+  static std::string header() {
+    return "config, scenario, aircraft, cycles, update_ms, alerting_ms, bands_ms, cycle_mean_ms, cycle_p50_ms, cycle_p90_ms, cycle_p99_ms, cycle_max_ms, us_per_intruder, alerts";
+  }
+
+  /* Run the frames of scenario and return a row of the table */
+  std::string run(const std::string& config, Daidalus& daa, const Scenario& scenario) {
+    LatencyHistogram cycle;
+    double update = 0;
+    double alerting = 0;
+    double bands = 0;
+    long alerts = 0;
+    int cycles = 0;
+    std::vector<int> levels;
+    for (int f = 0; f < scenario.numberOfFrames(); ++f) {
+      bool timed = f >= warmup || scenario.numberOfFrames() <= warmup;
+      double t0 = now();
+      for (int r = scenario.start[f]; r < scenario.start[f+1]; ++r) {
+        const TrafficRecord& rec = scenario.records[r];
+        if (r == scenario.start[f]) {
+          daa.setOwnshipState(rec.getId(),rec.getPosition(),rec.getVelocity(),rec.time);
+        } else {
+          daa.addTrafficState(rec.getId(),rec.getPosition(),rec.getVelocity());
+        }
+      }
+      double t1 = now();
+      daa.alertingAll(levels);
+      double t2 = now();
+      daa.kinematicMultiBands(kb_);
+      kb_.trackLength();
+      kb_.groundSpeedLength();
+      kb_.verticalSpeedLength();
+      kb_.altitudeLength();
+      double t3 = now();
+      if (verbose) {
+        std::cerr << "** " << scenario.name << " at " << Fm3(daa.getCurrentTime()) << " [s]: " <<
+            Fm3((t3-t0)*1e3) << " [ms]" << std::endl;
+      }
+      if (!timed) {
+        continue;
+      }
+      ++cycles;
+      update += t1-t0;
+      alerting += t2-t1;
+      bands += t3-t2;
+      cycle.add(t3-t0);
+      for (unsigned int i = 0; i < levels.size(); ++i) {
+        if (levels[i] > 0) {
+          ++alerts;
+        }
+      }
+    }
+    int aircraft = scenario.maxAircraft();
+    double n = Util::max(1,cycles);
+    return config+", "+scenario.name+", "+Fmi(aircraft)+", "+Fmi(cycles)+", "+
+        Fm4(update/n*1e3)+", "+Fm4(alerting/n*1e3)+", "+Fm4(bands/n*1e3)+", "+
+        Fm4(cycle.mean()*1e3)+", "+Fm4(cycle.percentile(0.5)*1e3)+", "+
+        Fm4(cycle.percentile(0.9)*1e3)+", "+Fm4(cycle.percentile(0.99)*1e3)+", "+
+        Fm4(cycle.max()*1e3)+", "+Fm3(cycle.mean()*1e6/Util::max(1,aircraft-1))+", "+
+        Fm2(alerts/n);
+  }
+
+private:
+
+  KinematicMultiBands kb_;
+
+  static double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+};
+
+static void printHelpMsg() {
+  std::cerr << "Usage:" << std::endl;
+  std::cerr << "  DaidalusScaling [<option>] [<file> ...]" << std::endl;
+  std::cerr << "  Run Daidalus over synthetic airspaces of increasing size, or over the given files, and print" << std::endl;
+  std::cerr << "  the time per cycle for each configuration. A cycle sets the aircraft states, computes the alert" << std::endl;
+  std::cerr << "  levels of all traffic aircraft, and computes the bands of all dimensions. Files are in DAIDALUS" << std::endl;
+  std::cerr << "  format or are written by DaidalusScenarioGenerator --binary" << std::endl;
+  std::cerr << "  <option> can be" << std::endl;
+  std::cerr << "  --config <file>\n\tLoad configuration <file>. This option can be repeated (default configuration is the default one)" << std::endl;
+  std::cerr << "  --configs <dir>\n\tLoad each configuration file *.txt in <dir>, e.g., ../Configurations" << std::endl;
+  std::cerr << "  --aircraft <n>,<n>,...\n\tNumber of aircraft of the synthetic airspaces, including the ownship\n\t(default 10,50,100,500,1000,5000)" << std::endl;
+  std::cerr << "  --cycles <n>\n\tNumber of timed cycles per synthetic airspace. It sets the duration (default 10)" << std::endl;
+  std::cerr << "  --warmup <n>\n\tNumber of untimed cycles before the timed ones (default 1)" << std::endl;
+  std::cerr << "  --out <file>\n\tWrite the table to <file> (default standard output)" << std::endl;
+  std::cerr << "  --verbose\n\tPrint the time of every cycle in standard error" << std::endl;
+  std::cerr << "  Synthetic airspaces are set by the options of DaidalusScenarioGenerator:" << std::endl;
+  std::cerr << ScenarioGenerator::getHelpString();
+  std::cerr << "  --help\n\tPrint this message" << std::endl;
+  exit(0);
+}
+
+/* Configuration files *.txt in dir, sorted by name */
+static void configFiles(const std::string& dir, std::vector<std::string>& configs) {
+  DIR* d = opendir(dir.c_str());
+  if (d == NULL) {
+    std::cerr << "** Error: Directory " << dir << " cannot be read" << std::endl;
+    exit(1);
+  }
+  std::vector<std::string> files;
+  struct dirent* entry;
+  while ((entry = readdir(d)) != NULL) {
+    std::string file = entry->d_name;
+    if (file.size() > 4 && file.substr(file.size()-4) == ".txt") {
+      files.push_back(dir+"/"+file);
+    }
+  }
+  closedir(d);
+  std::sort(files.begin(),files.end());
+  configs.insert(configs.end(),files.begin(),files.end());
+}
+
+int main(int argc, const char* argv[]) {
+  ScenarioGenerator gen;
+  ScalingStudy study;
+  std::vector<std::string> configs;
+  std::vector<int> counts;
+  std::vector<std::string> files;
+  std::string output = "";
+  int cycles = 10;
+  for (int a=1; a < argc; ++a) {
+    std::string arga = argv[a];
+    int used = 0;
+    if ((arga == "--aircraft" || arga == "-aircraft") && a+1 < argc) {
+      std::vector<std::string> list = split(argv[++a],",");
+      for (unsigned int i = 0; i < list.size(); ++i) {
+        counts.push_back(Util::max(1,atoi(list[i].c_str())));
+      }
+    } else if ((arga == "--configs" || arga == "-configs") && a+1 < argc) {
+      configFiles(argv[++a],configs);
+    } else if ((startsWith(arga,"--conf") || startsWith(arga,"-conf") || arga == "-c") && a+1 < argc) {
+      configs.push_back(argv[++a]);
+    } else if ((arga == "--cycles" || arga == "-cycles") && a+1 < argc) {
+      cycles = Util::max(1,atoi(argv[++a]));
+    } else if ((arga == "--warmup" || arga == "-warmup") && a+1 < argc) {
+      study.warmup = Util::max(0,atoi(argv[++a]));
+    } else if ((startsWith(arga,"--out") || startsWith(arga,"-out") || arga == "-o") && a+1 < argc) {
+      output = argv[++a];
+    } else if (arga == "--verbose" || arga == "-verbose" || arga == "-v") {
+      study.verbose = true;
+    } else if ((used = gen.processOptions(argv,argc,a)) > 0) {
+      a += used-1;
+    } else if (startsWith(arga,"--h") || startsWith(arga,"-h")) {
+      printHelpMsg();
+    } else if (startsWith(arga,"-")) {
+      std::cerr << "** Error: Unknown option " << arga << std::endl;
+      exit(1);
+    } else {
+      files.push_back(arga);
+    }
+  }
+  if (configs.empty()) {
+    configs.push_back("");
+  }
+  if (counts.empty() && files.empty()) {
+    int defaults[] = {10, 50, 100, 500, 1000, 5000};
+    counts.assign(defaults,defaults+6);
+  }
+  std::ofstream fout;
+  std::ostream* out = &std::cout;
+  if (output != "") {
+    fout.open(output.c_str());
+    if (!fout) {
+      std::cerr << "** Error: File " << output << " cannot be written" << std::endl;
+      exit(1);
+    }
+    out = &fout;
+  }
+  std::vector<Scenario> scenarios(counts.size()+files.size());
+  gen.duration = (cycles+study.warmup-1)*gen.step;
+  for (unsigned int i = 0; i < counts.size(); ++i) {
+    gen.aircraft = counts[i];
+    gen.generate();
+    scenarios[i].generate(gen);
+    std::cerr << "** Generated " << gen.toString() << std::endl;
+  }
+  for (unsigned int i = 0; i < files.size(); ++i) {
+    if (!scenarios[counts.size()+i].read(files[i])) {
+      std::cerr << "** Error: File " << files[i] << " cannot be read" << std::endl;
+      exit(1);
+    }
+  }
+  (*out) << "# " << Daidalus::release() << std::endl;
+  (*out) << ScalingStudy::header() << std::endl;
+  for (unsigned int c = 0; c < configs.size(); ++c) {
+    Daidalus daa;
+    if (configs[c] != "" && !daa.parameters.loadFromFile(configs[c])) {
+      std::cerr << "** Error: File " << configs[c] << " not found" << std::endl;
+      exit(1);
+    }
+    std::string config = configs[c] == "" ? "default" : configs[c].substr(configs[c].find_last_of('/')+1);
+    for (unsigned int i = 0; i < scenarios.size(); ++i) {
+      (*out) << study.run(config,daa,scenarios[i]) << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+/**
+
+Notices:
+
+Copyright 2019 United States Government as represented by the
+Administrator of the National Aeronautics and Space Administration. No
+copyright is claimed in the United States under Title 17,
+U.S. Code. All Other Rights Reserved.
+
+Disclaimers
+
+No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY
+WARRANTY OF ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY,
+INCLUDING, BUT NOT LIMITED TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE
+WILL CONFORM TO SPECIFICATIONS, ANY IMPLIED WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, OR FREEDOM FROM
+INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE ERROR
+FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER,
+CONSTITUTE AN ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT
+OF ANY RESULTS, RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY
+OTHER APPLICATIONS RESULTING FROM USE OF THE SUBJECT SOFTWARE.
+FURTHER, GOVERNMENT AGENCY DISCLAIMS ALL WARRANTIES AND LIABILITIES
+REGARDING THIRD-PARTY SOFTWARE, IF PRESENT IN THE ORIGINAL SOFTWARE,
+AND DISTRIBUTES IT "AS IS."
+
+Waiver and Indemnity: RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS
+AGAINST THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND
+SUBCONTRACTORS, AS WELL AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF
+THE SUBJECT SOFTWARE RESULTS IN ANY LIABILITIES, DEMANDS, DAMAGES,
+EXPENSES OR LOSSES ARISING FROM SUCH USE, INCLUDING ANY DAMAGES FROM
+PRODUCTS BASED ON, OR RESULTING FROM, RECIPIENT'S USE OF THE SUBJECT
+SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD HARMLESS THE UNITED
+STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL AS ANY
+PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.  RECIPIENT'S SOLE
+REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE, UNILATERAL
+TERMINATION OF THIS AGREEMENT.
+ **/
+
+#include "ScenarioGenerator.h"
+#include "string_util.h"
+#include <iostream>
+#include <cstdlib>
+
+using namespace larcfm;
+
+static void printHelpMsg() {
+  std::cerr << "Usage:" << std::endl;
+  std::cerr << "  DaidalusScenarioGenerator [<option>]" << std::endl;
+  std::cerr << "  Write a reproducible synthetic airspace, where AC0 is the ownship, for scaling studies" << std::endl;
+  std::cerr << "  <option> can be" << std::endl;
+  std::cerr << "  --out <file>\n\tWrite the scenario to <file> (default standard output)" << std::endl;
+  std::cerr << "  --binary\n\tWrite the scenario as fixed-layout traffic records, as read by DaidalusScaling,\n\tinstead of DAIDALUS format" << std::endl;
+  std::cerr << ScenarioGenerator::getHelpString();
+  std::cerr << "  --help\n\tPrint this message" << std::endl;
+  exit(0);
+}
+
+int main(int argc, const char* argv[]) {
+  ScenarioGenerator gen;
+  std::string output = "-";
+  bool binary = false;
+  for (int a=1; a < argc; ++a) {
+    std::string arga = argv[a];
+    int used = gen.processOptions(argv,argc,a);
+    if (used > 0) {
+      a += used-1;
+    } else if ((startsWith(arga,"--out") || startsWith(arga,"-out") || arga == "-o") && a+1 < argc) {
+      output = argv[++a];
+    } else if (arga == "--binary" || arga == "-binary") {
+      binary = true;
+    } else if (startsWith(arga,"--h") || startsWith(arga,"-h")) {
+      printHelpMsg();
+    } else {
+      std::cerr << "** Error: Unknown option " << arga << std::endl;
+      exit(1);
+    }
+  }
+  gen.generate();
+  bool ok = binary ? gen.writeBinary(output) : gen.writeDaa(output);
+  if (!ok) {
+    std::cerr << "** Error: File " << output << " cannot be written" << std::endl;
+    exit(1);
+  }
+  if (output != "-") {
+    std::cerr << "** " << gen.numberOfFrames() << " frames, " << gen.toString() << std::endl;
+  }
+  return 0;
+}
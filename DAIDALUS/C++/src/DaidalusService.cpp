@@ -0,0 +1,744 @@
+/**
+
+Notices:
+
+Copyright 2019 United States Government as represented by the
+Administrator of the National Aeronautics and Space Administration. No
+copyright is claimed in the United States under Title 17,
+U.S. Code. All Other Rights Reserved.
+
+Disclaimers
+
+No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY
+WARRANTY OF ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY,
+INCLUDING, BUT NOT LIMITED TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE
+WILL CONFORM TO SPECIFICATIONS, ANY IMPLIED WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, OR FREEDOM FROM
+INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE ERROR
+FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER,
+CONSTITUTE AN ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT
+OF ANY RESULTS, RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY
+OTHER APPLICATIONS RESULTING FROM USE OF THE SUBJECT SOFTWARE.
+FURTHER, GOVERNMENT AGENCY DISCLAIMS ALL WARRANTIES AND LIABILITIES
+REGARDING THIRD-PARTY SOFTWARE, IF PRESENT IN THE ORIGINAL SOFTWARE,
+AND DISTRIBUTES IT "AS IS."
+
+Waiver and Indemnity: RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS
+AGAINST THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND
+SUBCONTRACTORS, AS WELL AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF
+THE SUBJECT SOFTWARE RESULTS IN ANY LIABILITIES, DEMANDS, DAMAGES,
+EXPENSES OR LOSSES ARISING FROM SUCH USE, INCLUDING ANY DAMAGES FROM
+PRODUCTS BASED ON, OR RESULTING FROM, RECIPIENT'S USE OF THE SUBJECT
+SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD HARMLESS THE UNITED
+STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL AS ANY
+PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.  RECIPIENT'S SOLE
+REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE, UNILATERAL
+TERMINATION OF THIS AGREEMENT.
+ **/
+
+#include "Daidalus.h"
+#include "KinematicMultiBands.h"
+#include "SPSCQueue.h"
+#include "LatencyHistogram.h"
+#include "SharedRing.h"
+#include "SharedRecords.h"
+#include "StateReader.h"
+#include "string_util.h"
+#include "format.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <chrono>
+#include <map>
+#include <set>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <sched.h>
+#ifdef DAIDALUS_THREADS_
+#include <pthread.h>
+#endif
+
+using namespace larcfm;
+
+/*
+ * Traffic states of one ownship at one time, read by the ingest stage, and the alerting and bands
+ * computed for them by the compute stage. Frames go from one stage to the next through bounded
+ * queues and they are recycled by the output stage.
+ */
+struct ServiceFrame {
+  double time;
+  std::vector<std::string> ids; // ids[0] is the ownship
+  std::vector<Position> pos;
+  std::vector<Velocity> vel;
+  long long received; // Time, in nanoseconds, when the last line of the frame was read
+  long long computed; // Time, in nanoseconds, when the computation of the frame started
+  long long done;     // Time, in nanoseconds, when the computation of the frame ended
+
+  std::vector<std::string> traffic;
+  std::vector<int> alerts;
+  std::vector<BandsRange> bands[4]; // Track, ground speed, vertical speed, and altitude
+  bool final;
+
+  void clear() {
+    ids.clear();
+    pos.clear();
+    vel.clear();
+    traffic.clear();
+    alerts.clear();
+    for (int i = 0; i < 4; ++i) {
+      bands[i].clear();
+    }
+    final = true;
+  }
+};
+
+static long long now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class DaidalusService {
+
+public:
+
+  Daidalus prototype; // Configuration of the Daidalus objects of each ownship
+  int capacity;       // Capacity of the queues between stages
+  double budget;      // If non-negative, time budget for bands, in seconds
+  bool bands;         // Compute bands
+  bool verbose;       // Print metrics of every frame
+
+  DaidalusService() : capacity(64), budget(-1), bands(true), verbose(false),
+      in_(NULL), out_(NULL), input_(NULL), output_(NULL), free_(NULL), in_ring_(NULL), out_ring_(NULL),
+      pending_time_(0), has_pending_(false), frames_(0), ingest_stalls_(0), compute_stalls_(0), output_stalls_(0) {}
+
+  ~DaidalusService() {
+    std::map<std::string,Daidalus*>::iterator it;
+    for (it = daa_.begin(); it != daa_.end(); ++it) {
+      delete it->second;
+    }
+  }
+
+  /*
+   * Read traffic records from in until the end of the stream and write results to out.
+   * Ingest, compute, and output stages run on their own threads when compiled with DAIDALUS_THREADS_,
+   * as the Makefile does.
+   */
+  void serve(FILE* in, FILE* out) {
+    in_ = in;
+    out_ = out;
+    reader_.openStream(&line_);
+    has_pending_ = false;
+    clear_metrics();
+    header();
+#ifdef DAIDALUS_THREADS_
+    SPSCQueue<ServiceFrame*> input(capacity);
+    SPSCQueue<ServiceFrame*> output(capacity);
+    SPSCQueue<ServiceFrame*> recycled(2*capacity);
+    input_ = &input;
+    output_ = &output;
+    free_ = &recycled;
+    pthread_t compute_thread;
+    pthread_t output_thread;
+    pthread_create(&compute_thread,NULL,compute_stage,this);
+    pthread_create(&output_thread,NULL,output_stage,this);
+    ingest_loop();
+    pthread_join(compute_thread,NULL);
+    pthread_join(output_thread,NULL);
+    ServiceFrame* frame;
+    while (recycled.tryPop(frame)) {
+      delete frame;
+    }
+    input_ = output_ = free_ = NULL;
+#else
+    // Without threads, stages run one after another on each frame
+    ServiceFrame frame;
+    while (read_frame(frame)) {
+      compute(frame);
+      write(frame);
+    }
+#endif
+    std::cerr << metrics() << std::flush;
+  }
+
+  /*
+   * Read TrafficRecord frames from shared ring in until the end of the stream and write ResultRecord
+   * results to shared ring out. Records of in are consumed in place by the compute stage. The stream
+   * ends with an END_OF_STREAM record in both rings.
+   */
+  void serve_shared(SharedRing& in, SharedRing& out) {
+    in_ring_ = &in;
+    out_ring_ = &out;
+    clear_metrics();
+#ifdef DAIDALUS_THREADS_
+    SPSCQueue<ServiceFrame*> output(capacity);
+    SPSCQueue<ServiceFrame*> recycled(2*capacity);
+    output_ = &output;
+    free_ = &recycled;
+    pthread_t output_thread;
+    pthread_create(&output_thread,NULL,output_stage,this);
+    consume_loop();
+    pthread_join(output_thread,NULL);
+    ServiceFrame* frame;
+    while (recycled.tryPop(frame)) {
+      delete frame;
+    }
+    output_ = free_ = NULL;
+#else
+    ServiceFrame frame;
+    while (consume_frame(frame)) {
+      write_shared(frame);
+    }
+#endif
+    put(ResultRecord::END_OF_STREAM,"","",0,0,0,0);
+    in_ring_ = out_ring_ = NULL;
+    std::cerr << metrics() << std::flush;
+  }
+
+  std::string metrics() const {
+    std::string s = "";
+    s += "** Frames: "+Fmul(frames_)+"\n";
+    s += "** Latency (read to written): "+latency_.toString()+"\n";
+    s += "** Compute time: "+compute_time_.toString()+"\n";
+    s += "** Backpressure: "+Fmul(ingest_stalls_)+" ingest stalls, "+Fmul(compute_stalls_)+" compute stalls, "+
+        Fmul(output_stalls_)+" output stalls\n";
+    return s;
+  }
+
+private:
+
+  void clear_metrics() {
+    latency_.clear();
+    compute_time_.clear();
+    frames_ = 0;
+    ingest_stalls_ = 0;
+    compute_stalls_ = 0;
+    output_stalls_ = 0;
+  }
+
+  FILE* in_;
+  FILE* out_;
+  StateReader reader_;               // Reader of the lines of in_, which are fed one at a time through line_
+  std::istringstream line_;
+  std::map<std::string,Daidalus*> daa_; // Daidalus object per ownship
+  KinematicMultiBands kb_;
+  std::set<std::string> frame_ids_;
+  SPSCQueue<ServiceFrame*>* input_;  // From ingest to compute
+  SPSCQueue<ServiceFrame*>* output_; // From compute to output
+  SPSCQueue<ServiceFrame*>* free_;   // From output back to ingest
+  SharedRing* in_ring_;              // Shared ring of TrafficRecord, when input is shared memory
+  SharedRing* out_ring_;             // Shared ring of ResultRecord, when output is shared memory
+  std::string pending_id_;           // Aircraft state read ahead of the frame being read
+  Position pending_pos_;
+  Velocity pending_vel_;
+  double pending_time_;
+  bool has_pending_;
+  LatencyHistogram latency_;
+  LatencyHistogram compute_time_;
+  unsigned long frames_;
+  unsigned long ingest_stalls_;
+  unsigned long compute_stalls_;
+  unsigned long output_stalls_;
+
+  /*
+   * Read the next frame, i.e., consecutive aircraft states with the same time, into frame. A blank line
+   * also ends a frame. Return false at the end of the stream.
+   */
+  bool read_frame(ServiceFrame& frame) {
+    frame.clear();
+    if (has_pending_) {
+      add_state(frame,pending_id_,pending_pos_,pending_vel_,pending_time_);
+      has_pending_ = false;
+    }
+    char* buffer = NULL;
+    size_t size = 0;
+    ssize_t n;
+    while ((n = getline(&buffer,&size,in_)) >= 0) {
+      std::string line(buffer,n);
+      std::string id;
+      Position pos;
+      Velocity vel;
+      double time;
+      line_.clear();
+      line_.str(trimCopy(line));
+      bool state = reader_.readState(id,pos,vel,time);
+      if (reader_.hasMessage()) {
+        std::cerr << "** Warning: " << reader_.getMessage() << std::endl;
+      }
+      if (state) {
+        if (!frame.ids.empty() && time != frame.time) {
+          pending_id_ = id;
+          pending_pos_ = pos;
+          pending_vel_ = vel;
+          pending_time_ = time;
+          has_pending_ = true;
+          break;
+        }
+        add_state(frame,id,pos,vel,time);
+      } else if (!frame.ids.empty() && trimCopy(line) == "") {
+        break;
+      }
+    }
+    free(buffer);
+    frame.received = now_ns();
+    return !frame.ids.empty();
+  }
+
+  static void add_state(ServiceFrame& frame, const std::string& id, const Position& pos, const Velocity& vel, double time) {
+    frame.time = time;
+    frame.ids.push_back(id);
+    frame.pos.push_back(pos);
+    frame.vel.push_back(vel);
+  }
+
+  /* Return Daidalus object of ownship, creating it if needed */
+  Daidalus& instance(const std::string& ownship) {
+    std::map<std::string,Daidalus*>::iterator it = daa_.find(ownship);
+    if (it == daa_.end()) {
+      it = daa_.insert(std::make_pair(ownship,new Daidalus(prototype))).first;
+    }
+    return *it->second;
+  }
+
+  /* Compute alerting and bands of frame */
+  void compute(ServiceFrame& frame) {
+    frame.computed = now_ns();
+    Daidalus& daa = instance(frame.ids[0]);
+    daa.updateOwnshipState(frame.ids[0],frame.pos[0],frame.vel[0],frame.time);
+    frame_ids_.clear();
+    for (int i = 1; i < (int)frame.ids.size(); ++i) {
+      daa.updateTrafficState(frame.ids[i],frame.pos[i],frame.vel[i],frame.time);
+      frame_ids_.insert(frame.ids[i]);
+    }
+    results(daa,frame);
+  }
+
+  /*
+   * Remove traffic aircraft that are not in frame_ids_, compute alerting and bands of daa, and put them
+   * in frame.
+   */
+  void results(Daidalus& daa, ServiceFrame& frame) {
+    // Traffic aircraft that are not in the frame are no longer tracked
+    for (int ac = daa.lastTrafficIndex(); ac >= 1; --ac) {
+      if (frame_ids_.find(daa.getAircraftState(ac).getId()) == frame_ids_.end()) {
+        daa.removeTrafficState(daa.getAircraftState(ac).getId());
+      }
+    }
+    for (int ac = 1; ac <= daa.lastTrafficIndex(); ++ac) {
+      frame.traffic.push_back(daa.getAircraftState(ac).getId());
+    }
+    daa.alertingAll(frame.alerts);
+    if (bands) {
+      daa.kinematicMultiBands(kb_);
+      if (budget >= 0) {
+        frame.final = kb_.computeBandsWithin(budget);
+      }
+      for (int i = 0; i < kb_.trackLength(); ++i) {
+        frame.bands[0].push_back(BandsRange(kb_.track(i),kb_.trackRegion(i)));
+      }
+      for (int i = 0; i < kb_.groundSpeedLength(); ++i) {
+        frame.bands[1].push_back(BandsRange(kb_.groundSpeed(i),kb_.groundSpeedRegion(i)));
+      }
+      for (int i = 0; i < kb_.verticalSpeedLength(); ++i) {
+        frame.bands[2].push_back(BandsRange(kb_.verticalSpeed(i),kb_.verticalSpeedRegion(i)));
+      }
+      for (int i = 0; i < kb_.altitudeLength(); ++i) {
+        frame.bands[3].push_back(BandsRange(kb_.altitude(i),kb_.altitudeRegion(i)));
+      }
+    }
+    frame.done = now_ns();
+    compute_time_.add((frame.done-frame.computed)*1e-9);
+  }
+
+  /*
+   * Read the next frame from the shared ring in_ring_. Records are applied in place to the Daidalus
+   * object of the ownship, without copies, and the results are put in frame. Wait while the ring
+   * is empty. Return false at the end of the stream.
+   */
+  bool consume_frame(ServiceFrame& frame) {
+    frame.clear();
+    Daidalus* daa = NULL;
+    frame_ids_.clear();
+    for (int spins = 0;;) {
+      const TrafficRecord* rec = (const TrafficRecord*)in_ring_->peek();
+      if (rec == NULL) {
+        backoff(spins);
+        continue;
+      }
+      spins = 0;
+      if (rec->flags & TrafficRecord::END_OF_STREAM) {
+        in_ring_->release();
+        return false;
+      }
+      if (rec->flags & TrafficRecord::OWNSHIP) {
+        if (daa != NULL) {
+          std::cerr << "** Warning: Frame of " << frame.ids[0] << " at " << Fm3(frame.time) << " [s] without end" << std::endl;
+        }
+        frame.clear();
+        frame.ids.push_back(rec->getId());
+        frame.time = rec->time;
+        // Records are consumed as soon as they are available, so the frame is not queued
+        frame.received = frame.computed = now_ns();
+        frame_ids_.clear();
+        daa = &instance(frame.ids[0]);
+        daa->updateOwnshipState(frame.ids[0],rec->getPosition(),rec->getVelocity(),rec->time);
+      } else if (daa != NULL) {
+        std::string id = rec->getId();
+        daa->updateTrafficState(id,rec->getPosition(),rec->getVelocity(),rec->time);
+        frame_ids_.insert(id);
+      } else {
+        std::cerr << "** Warning: Traffic record " << rec->getId() << " without ownship ignored" << std::endl;
+      }
+      bool end = (rec->flags & TrafficRecord::END_OF_FRAME) != 0;
+      in_ring_->release();
+      if (end && daa != NULL) {
+        results(*daa,frame);
+        return true;
+      }
+    }
+  }
+
+  /* Put record in shared ring out_ring_, waiting while the ring is full. Return true if it had to wait. */
+  bool put(ResultRecord::Kind kind, const std::string& ownship, const std::string& traffic, int value,
+      double time, double low, double up) {
+    ResultRecord* rec;
+    int spins = 0;
+    while ((rec = (ResultRecord*)out_ring_->reserve()) == NULL) {
+      backoff(spins);
+    }
+    rec->set(kind,ownship,traffic,value,time,low,up);
+    out_ring_->commit();
+    return spins > 0;
+  }
+
+  /* Write results of frame in shared ring out_ring_ */
+  void write_shared(const ServiceFrame& frame) {
+    bool stalled = false;
+    const std::string& ownship = frame.ids[0];
+    for (int ac = 0; ac < (int)frame.traffic.size(); ++ac) {
+      stalled |= put(ResultRecord::ALERT,ownship,frame.traffic[ac],frame.alerts[ac],frame.time,0,0);
+    }
+    for (int d = 0; d < 4; ++d) {
+      for (int i = 0; i < (int)frame.bands[d].size(); ++i) {
+        const BandsRange& r = frame.bands[d][i];
+        stalled |= put((ResultRecord::Kind)(ResultRecord::TRK+d),ownship,"",r.region,frame.time,
+            r.interval.low,r.interval.up);
+      }
+    }
+    stalled |= put(ResultRecord::END,ownship,"",frame.final ? 1 : 0,frame.time,0,0);
+    if (stalled) {
+      ++output_stalls_;
+    }
+    record_latency(frame);
+  }
+
+  void header() {
+    fprintf(out_,"# Records: ALERT, time [s], ownship, traffic, alert level\n");
+    if (bands) {
+      fprintf(out_,"#          TRK|GS|VS|ALT, time [s], ownship, low, up, region\n");
+      fprintf(out_,"# Units:   TRK [%s], GS [%s], VS [%s], ALT [%s]\n",
+          prototype.parameters.getUnits("trk_step").c_str(),prototype.parameters.getUnits("gs_step").c_str(),
+          prototype.parameters.getUnits("vs_step").c_str(),prototype.parameters.getUnits("alt_step").c_str());
+    }
+    fprintf(out_,"#          END, time [s], ownship, final (0 if bands are approximate)\n");
+    fflush(out_);
+  }
+
+  /* Serialize results of frame */
+  void write(const ServiceFrame& frame) {
+    static const char* dims[4] = { "TRK", "GS", "VS", "ALT" };
+    std::string units[4] = { prototype.parameters.getUnits("trk_step"), prototype.parameters.getUnits("gs_step"),
+        prototype.parameters.getUnits("vs_step"), prototype.parameters.getUnits("alt_step") };
+    const char* ownship = frame.ids[0].c_str();
+    for (int ac = 0; ac < (int)frame.traffic.size(); ++ac) {
+      fprintf(out_,"ALERT, %.6f, %s, %s, %d\n",frame.time,ownship,frame.traffic[ac].c_str(),frame.alerts[ac]);
+    }
+    for (int d = 0; d < 4; ++d) {
+      for (int i = 0; i < (int)frame.bands[d].size(); ++i) {
+        const BandsRange& r = frame.bands[d][i];
+        fprintf(out_,"%s, %.6f, %s, %.6f, %.6f, %s\n",dims[d],frame.time,ownship,
+            Units::to(units[d],r.interval.low),Units::to(units[d],r.interval.up),
+            BandsRegion::to_string(r.region).c_str());
+      }
+    }
+    fprintf(out_,"END, %.6f, %s, %d\n",frame.time,ownship,frame.final ? 1 : 0);
+    fflush(out_);
+    record_latency(frame);
+  }
+
+  void record_latency(const ServiceFrame& frame) {
+    double latency = (now_ns()-frame.received)*1e-9;
+    latency_.add(latency);
+    ++frames_;
+    if (verbose) {
+      std::cerr << "** Frame " << frames_ << " (" << frame.ids[0] << " at " << Fm3(frame.time) << " [s]): latency "
+          << Fm3(latency*1e3) << " [ms], queued " << Fm3((frame.computed-frame.received)*1e-6)
+          << " [ms], compute " << Fm3((frame.done-frame.computed)*1e-6) << " [ms]" << std::endl;
+    }
+  }
+
+  /* Wait policy of a stage that can't make progress: spin, then yield, then sleep */
+  static void backoff(int& spins) {
+    ++spins;
+    if (spins < 64) {
+      return;
+    } else if (spins < 128) {
+      sched_yield();
+    } else {
+      usleep(50);
+    }
+  }
+
+  /* Write results of frame to the output of the service */
+  void output(const ServiceFrame& frame) {
+    if (out_ring_ != NULL) {
+      write_shared(frame);
+    } else {
+      write(frame);
+    }
+  }
+
+#ifdef DAIDALUS_THREADS_
+
+  /* Push frame into queue, waiting while it's full. Return true if the stage had to wait. */
+  static bool push(SPSCQueue<ServiceFrame*>& queue, ServiceFrame* frame) {
+    int spins = 0;
+    while (!queue.tryPush(frame)) {
+      backoff(spins);
+    }
+    return spins > 0;
+  }
+
+  static ServiceFrame* pop(SPSCQueue<ServiceFrame*>& queue) {
+    ServiceFrame* frame;
+    int spins = 0;
+    while (!queue.tryPop(frame)) {
+      backoff(spins);
+    }
+    return frame;
+  }
+
+  /* Ingest stage. A NULL frame marks the end of the stream. */
+  void ingest_loop() {
+    for (;;) {
+      ServiceFrame* frame;
+      if (!free_->tryPop(frame)) {
+        frame = new ServiceFrame();
+      }
+      if (!read_frame(*frame)) {
+        delete frame;
+        push(*input_,NULL);
+        return;
+      }
+      if (push(*input_,frame)) {
+        ++ingest_stalls_;
+      }
+    }
+  }
+
+  /* Ingest and compute stages on a shared ring: records are consumed by the compute stage */
+  void consume_loop() {
+    for (;;) {
+      ServiceFrame* frame;
+      if (!free_->tryPop(frame)) {
+        frame = new ServiceFrame();
+      }
+      if (!consume_frame(*frame)) {
+        delete frame;
+        push(*output_,NULL);
+        return;
+      }
+      if (push(*output_,frame)) {
+        ++compute_stalls_;
+      }
+    }
+  }
+
+  static void* compute_stage(void* arg) {
+    DaidalusService* service = (DaidalusService*)arg;
+    for (;;) {
+      ServiceFrame* frame = pop(*service->input_);
+      if (frame != NULL) {
+        service->compute(*frame);
+      }
+      if (push(*service->output_,frame)) {
+        ++service->compute_stalls_;
+      }
+      if (frame == NULL) {
+        return NULL;
+      }
+    }
+  }
+
+  static void* output_stage(void* arg) {
+    DaidalusService* service = (DaidalusService*)arg;
+    for (;;) {
+      ServiceFrame* frame = pop(*service->output_);
+      if (frame == NULL) {
+        return NULL;
+      }
+      service->output(*frame);
+      if (!service->free_->tryPush(frame)) {
+        delete frame;
+      }
+    }
+  }
+
+#endif
+
+};
+
+// Names of the shared memory rings, which are removed when the service is terminated by a signal
+static std::string shm_in_name = "";
+static std::string shm_out_name = "";
+
+static void remove_shm(int sig) {
+  shm_unlink(shm_in_name.c_str());
+  shm_unlink(shm_out_name.c_str());
+  _exit(128+sig);
+}
+
+static void printHelpMsg() {
+  std::cerr << "Usage:" << std::endl;
+  std::cerr << "  DaidalusService [<option>]" << std::endl;
+  std::cerr << "  Read traffic records in DAIDALUS format from standard input, or from clients of a local socket," << std::endl;
+  std::cerr << "  and write alerting and bands records. Aircraft states with the same time form a frame, whose" << std::endl;
+  std::cerr << "  first aircraft is the ownship. A blank line also ends a frame. There is one persistent Daidalus" << std::endl;
+  std::cerr << "  object per ownship. Traffic aircraft that are not in a frame are removed from that object." << std::endl;
+  std::cerr << "  <option> can be" << std::endl;
+  std::cerr << "  --config <config_file>\n\tLoad configuration <config_file>" << std::endl;
+  std::cerr << "  --<var>=<val>\n\t<key> is any configuration variable and val is its value (including units, if any), e.g., --lookahead_time=5[min]" << std::endl;
+  std::cerr << "  --socket <path>\n\tServe clients of local socket <path>, one at a time. Records are written back to the client" << std::endl;
+  std::cerr << "  --shm <name>\n\tRead TrafficRecord records from shared memory ring <name>.in and write ResultRecord records\n\tto shared memory ring <name>.out, e.g., --shm /daidalus. See DaidalusStubProducer" << std::endl;
+  std::cerr << "  --shm_replace\n\tRemove existing shared memory rings <name>.in and <name>.out before creating them, e.g., the\n\trings left by a service that was killed. By default, the service doesn't start if they exist" << std::endl;
+  std::cerr << "  --ring <n>\n\tCapacity, in records, of the shared memory rings (default 4096)" << std::endl;
+  std::cerr << "  --output <output_file>\n\tWrite records to <output_file> instead of standard output or socket client" << std::endl;
+  std::cerr << "  --queue <n>\n\tCapacity, in frames, of the queues between stages (default 64)" << std::endl;
+  std::cerr << "  --budget <t>\n\tTime budget, in seconds, for the bands of a frame, see KinematicMultiBands::computeBandsWithin" << std::endl;
+  std::cerr << "  --nobands\n\tOnly compute alerting" << std::endl;
+  std::cerr << "  --verbose\n\tPrint latency of every frame in standard error" << std::endl;
+  std::cerr << "  --help\n\tPrint this message" << std::endl;
+  exit(0);
+}
+
+int main(int argc, char* argv[]) {
+  DaidalusService service;
+  ParameterData params;
+  std::string socket_path = "";
+  std::string shm_name = "";
+  bool shm_replace = false;
+  int ring_capacity = 4096;
+  std::string output_file = "";
+  for (int a=1; a < argc; ++a) {
+    std::string arga = argv[a];
+    if ((startsWith(arga,"--c") || startsWith(arga,"-c")) && a+1 < argc) {
+      arga = argv[++a];
+      if (!service.prototype.parameters.loadFromFile(arga)) {
+        std::cerr << "** Error: File " << arga << " not found" << std::endl;
+        exit(1);
+      }
+    } else if (arga == "--shm_replace" || arga == "-shm_replace") {
+      shm_replace = true;
+    } else if ((arga == "--shm" || arga == "-shm") && a+1 < argc) {
+      shm_name = argv[++a];
+    } else if ((startsWith(arga,"--r") || startsWith(arga,"-r")) && a+1 < argc) {
+      ring_capacity = Util::max(2,atoi(argv[++a]));
+    } else if ((startsWith(arga,"--s") || startsWith(arga,"-s")) && a+1 < argc) {
+      socket_path = argv[++a];
+    } else if ((startsWith(arga,"--o") || startsWith(arga,"-o")) && a+1 < argc) {
+      output_file = argv[++a];
+    } else if ((startsWith(arga,"--q") || startsWith(arga,"-q")) && a+1 < argc) {
+      service.capacity = Util::max(1,atoi(argv[++a]));
+    } else if ((startsWith(arga,"--b") || startsWith(arga,"-b")) && a+1 < argc) {
+      service.budget = Util::parse_double(argv[++a]);
+    } else if (arga == "--nobands" || arga == "-nobands") {
+      service.bands = false;
+    } else if (arga == "--verbose" || arga == "-verbose" || arga == "-v") {
+      service.verbose = true;
+    } else if (startsWith(arga,"-") && arga.find('=') != std::string::npos) {
+      std::string keyval = arga.substr(arga.find_last_of('-')+1);
+      params.set(keyval);
+    } else if (startsWith(arga,"--h") || startsWith(arga,"-h")) {
+      printHelpMsg();
+    } else {
+      std::cerr << "** Error: Unknown option " << arga << std::endl;
+      exit(1);
+    }
+  }
+  if (params.size() > 0) {
+    service.prototype.parameters.setParameters(params);
+  }
+  FILE* out = NULL;
+  if (output_file != "") {
+    out = fopen(output_file.c_str(),"w");
+    if (out == NULL) {
+      std::cerr << "** Error: File " << output_file << " cannot be written" << std::endl;
+      exit(1);
+    }
+  }
+  if (shm_name != "") {
+    SharedRing in;
+    SharedRing out_ring;
+    if (shm_replace) {
+      SharedRing::remove(shm_name+".in");
+      SharedRing::remove(shm_name+".out");
+    }
+    if (!in.create(shm_name+".in",sizeof(TrafficRecord),ring_capacity) ||
+        !out_ring.create(shm_name+".out",sizeof(ResultRecord),ring_capacity)) {
+      std::cerr << "** Error: " << in.getMessage() << out_ring.getMessage() << std::endl;
+      // Only the rings created here are removed
+      in.close();
+      out_ring.close();
+      exit(1);
+    }
+    shm_in_name = shm_name+".in";
+    shm_out_name = shm_name+".out";
+    signal(SIGINT,remove_shm);
+    signal(SIGTERM,remove_shm);
+    std::cerr << "Serving producers of shared memory rings " << shm_name << ".in and " << shm_name << ".out" << std::endl;
+    for (;;) {
+      service.serve_shared(in,out_ring);
+    }
+  } else if (socket_path == "") {
+    service.serve(stdin,out != NULL ? out : stdout);
+  } else {
+    // A client that goes away must not terminate the service
+    signal(SIGPIPE,SIG_IGN);
+    int server = socket(AF_UNIX,SOCK_STREAM,0);
+    struct sockaddr_un addr;
+    memset(&addr,0,sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (server < 0 || socket_path.size() >= sizeof(addr.sun_path)) {
+      std::cerr << "** Error: Socket " << socket_path << " cannot be created" << std::endl;
+      exit(1);
+    }
+    strncpy(addr.sun_path,socket_path.c_str(),sizeof(addr.sun_path)-1);
+    unlink(socket_path.c_str());
+    if (bind(server,(struct sockaddr*)&addr,sizeof(addr)) < 0 || listen(server,1) < 0) {
+      std::cerr << "** Error: Socket " << socket_path << " cannot be bound" << std::endl;
+      exit(1);
+    }
+    std::cerr << "Serving clients of socket " << socket_path << std::endl;
+    for (;;) {
+      int client = accept(server,NULL,NULL);
+      if (client < 0) {
+        continue;
+      }
+      FILE* in = fdopen(client,"r");
+      FILE* client_out = out != NULL ? out : fdopen(dup(client),"w");
+      service.serve(in,client_out);
+      if (client_out != out) {
+        fclose(client_out);
+      }
+      fclose(in);
+    }
+  }
+  if (out != NULL) {
+    fclose(out);
+  }
+  return 0;
+}
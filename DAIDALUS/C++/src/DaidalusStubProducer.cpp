@@ -0,0 +1,235 @@
+/**
+
+Notices:
+
+Copyright 2019 United States Government as represented by the
+Administrator of the National Aeronautics and Space Administration. No
+copyright is claimed in the United States under Title 17,
+U.S. Code. All Other Rights Reserved.
+
+Disclaimers
+
+No Warranty: THE SUBJECT SOFTWARE IS PROVIDED "AS IS" WITHOUT ANY
+WARRANTY OF ANY KIND, EITHER EXPRESSED, IMPLIED, OR STATUTORY,
+INCLUDING, BUT NOT LIMITED TO, ANY WARRANTY THAT THE SUBJECT SOFTWARE
+WILL CONFORM TO SPECIFICATIONS, ANY IMPLIED WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, OR FREEDOM FROM
+INFRINGEMENT, ANY WARRANTY THAT THE SUBJECT SOFTWARE WILL BE ERROR
+FREE, OR ANY WARRANTY THAT DOCUMENTATION, IF PROVIDED, WILL CONFORM TO
+THE SUBJECT SOFTWARE. THIS AGREEMENT DOES NOT, IN ANY MANNER,
+CONSTITUTE AN ENDORSEMENT BY GOVERNMENT AGENCY OR ANY PRIOR RECIPIENT
+OF ANY RESULTS, RESULTING DESIGNS, HARDWARE, SOFTWARE PRODUCTS OR ANY
+OTHER APPLICATIONS RESULTING FROM USE OF THE SUBJECT SOFTWARE.
+FURTHER, GOVERNMENT AGENCY DISCLAIMS ALL WARRANTIES AND LIABILITIES
+REGARDING THIRD-PARTY SOFTWARE, IF PRESENT IN THE ORIGINAL SOFTWARE,
+AND DISTRIBUTES IT "AS IS."
+
+Waiver and Indemnity: RECIPIENT AGREES TO WAIVE ANY AND ALL CLAIMS
+AGAINST THE UNITED STATES GOVERNMENT, ITS CONTRACTORS AND
+SUBCONTRACTORS, AS WELL AS ANY PRIOR RECIPIENT.  IF RECIPIENT'S USE OF
+THE SUBJECT SOFTWARE RESULTS IN ANY LIABILITIES, DEMANDS, DAMAGES,
+EXPENSES OR LOSSES ARISING FROM SUCH USE, INCLUDING ANY DAMAGES FROM
+PRODUCTS BASED ON, OR RESULTING FROM, RECIPIENT'S USE OF THE SUBJECT
+SOFTWARE, RECIPIENT SHALL INDEMNIFY AND HOLD HARMLESS THE UNITED
+STATES GOVERNMENT, ITS CONTRACTORS AND SUBCONTRACTORS, AS WELL AS ANY
+PRIOR RECIPIENT, TO THE EXTENT PERMITTED BY LAW.  RECIPIENT'S SOLE
+REMEDY FOR ANY SUCH MATTER SHALL BE THE IMMEDIATE, UNILATERAL
+TERMINATION OF THIS AGREEMENT.
+ **/
+
+#include "Daidalus.h"
+#include "DaidalusFileWalker.h"
+#include "LatencyHistogram.h"
+#include "SharedRing.h"
+#include "SharedRecords.h"
+#include "string_util.h"
+#include "format.h"
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <deque>
+#include <unistd.h>
+#include <sched.h>
+
+using namespace larcfm;
+
+/*
+ * Producer of traffic records for a DaidalusService started with option --shm. It plays the role of
+ * a co-located surveillance process: frames of a DAIDALUS file are written in the input ring of the
+ * service and the results are read back from the output ring.
+ */
+class StubProducer {
+
+public:
+
+  bool verbose;
+  bool sync; // Wait for the results of a frame before writing the next one
+
+  StubProducer() : verbose(false), sync(false), done_(false) {}
+
+  /* Attach to the rings of the service, waiting at most timeout seconds for the service to create them */
+  bool attach(const std::string& name, double timeout) {
+    for (double waited = 0; ; waited += 0.1) {
+      if (in_.open(name+".in",sizeof(TrafficRecord)) && out_.open(name+".out",sizeof(ResultRecord))) {
+        return true;
+      }
+      in_.close();
+      if (waited >= timeout) {
+        std::cerr << "** Error: " << in_.getMessage() << out_.getMessage() << std::endl;
+        return false;
+      }
+      usleep(100000);
+    }
+  }
+
+  /* Write the frames of file to the service and print the results */
+  void play(const std::string& file, const std::string& config) {
+    Daidalus daa;
+    if (config != "" && !daa.parameters.loadFromFile(config)) {
+      std::cerr << "** Error: File " << config << " not found" << std::endl;
+      exit(1);
+    }
+    utrk_ = daa.parameters.getUnits("trk_step");
+    ugs_ = daa.parameters.getUnits("gs_step");
+    uvs_ = daa.parameters.getUnits("vs_step");
+    ualt_ = daa.parameters.getUnits("alt_step");
+    DaidalusFileWalker walker(file);
+    int frames = 0;
+    while (!walker.atEnd()) {
+      walker.readState(daa);
+      for (int ac = 0; ac <= daa.lastTrafficIndex(); ++ac) {
+        const TrafficState& state = daa.getAircraftState(ac);
+        if (!TrafficRecord::validId(state.getId())) {
+          std::cerr << "** Error: Identifier " << state.getId() << " is longer than " << TrafficRecord::ID_SIZE-1
+              << " characters" << std::endl;
+          exit(1);
+        }
+        uint32_t flags = ac == 0 ? TrafficRecord::OWNSHIP : 0;
+        if (ac == daa.lastTrafficIndex()) {
+          flags |= TrafficRecord::END_OF_FRAME;
+        }
+        put(state.getId(),state.getPosition(),state.getVelocity(),daa.getCurrentTime(),flags);
+      }
+      sent_.push_back(now_ns());
+      ++frames;
+      drain();
+      while (sync && !sent_.empty()) {
+        if (!drain()) {
+          sched_yield();
+        }
+      }
+    }
+    put("",Position::INVALID(),Velocity::INVALIDV(),0,TrafficRecord::END_OF_STREAM);
+    while (!done_) {
+      if (!drain()) {
+        sched_yield();
+      }
+    }
+    std::cerr << "** " << frames << " frames, round-trip latency: " << latency_.toString() << std::endl;
+  }
+
+private:
+
+  SharedRing in_;
+  SharedRing out_;
+  std::string utrk_, ugs_, uvs_, ualt_;
+  std::deque<long long> sent_; // Times, in nanoseconds, when the frames without results were written
+  LatencyHistogram latency_;
+  bool done_;
+
+  static long long now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /* Write one record in the input ring. While the ring is full, results are drained. */
+  void put(const std::string& id, const Position& pos, const Velocity& vel, double time, uint32_t flags) {
+    TrafficRecord* rec;
+    while ((rec = (TrafficRecord*)in_.reserve()) == NULL) {
+      if (!drain()) {
+        sched_yield();
+      }
+    }
+    rec->set(id,pos,vel,time,flags);
+    in_.commit();
+  }
+
+  /* Print the results available in the output ring. Return true if there was any. */
+  bool drain() {
+    bool any = false;
+    const ResultRecord* rec;
+    while ((rec = (const ResultRecord*)out_.peek()) != NULL) {
+      any = true;
+      if (rec->kind == ResultRecord::END_OF_STREAM) {
+        done_ = true;
+      } else {
+        printf("%s\n",rec->toString(utrk_,ugs_,uvs_,ualt_).c_str());
+        if (rec->kind == ResultRecord::END && !sent_.empty()) {
+          long long latency = now_ns()-sent_.front();
+          sent_.pop_front();
+          latency_.add(latency*1e-9);
+          if (verbose) {
+            std::cerr << "** Frame at " << Fm3(rec->time) << " [s]: round-trip latency " << Fm3(latency*1e-6) << " [ms]" << std::endl;
+          }
+        }
+      }
+      out_.release();
+    }
+    return any;
+  }
+};
+
+static void printHelpMsg() {
+  std::cerr << "Usage:" << std::endl;
+  std::cerr << "  DaidalusStubProducer [<option>] <daa_file>" << std::endl;
+  std::cerr << "  Write the frames of <daa_file> as traffic records in the shared memory rings of a DaidalusService" << std::endl;
+  std::cerr << "  started with option --shm, and print the alerting and bands records that it computes" << std::endl;
+  std::cerr << "  <option> can be" << std::endl;
+  std::cerr << "  --shm <name>\n\tName of the shared memory rings (default /daidalus)" << std::endl;
+  std::cerr << "  --config <config_file>\n\tUnits of bands are the ones of <config_file>" << std::endl;
+  std::cerr << "  --timeout <t>\n\tWait at most <t> seconds for the service (default 10)" << std::endl;
+  std::cerr << "  --sync\n\tWrite a frame when the results of the previous one have been read. Otherwise, frames are written\n\tas fast as the ring allows and latency includes queuing in the service" << std::endl;
+  std::cerr << "  --verbose\n\tPrint round-trip latency of every frame in standard error" << std::endl;
+  std::cerr << "  --help\n\tPrint this message" << std::endl;
+  exit(0);
+}
+
+int main(int argc, char* argv[]) {
+  StubProducer producer;
+  std::string shm_name = "/daidalus";
+  std::string config = "";
+  std::string input_file = "";
+  double timeout = 10;
+  for (int a=1; a < argc; ++a) {
+    std::string arga = argv[a];
+    if ((arga == "--shm" || arga == "-shm") && a+1 < argc) {
+      shm_name = argv[++a];
+    } else if ((startsWith(arga,"--c") || startsWith(arga,"-c")) && a+1 < argc) {
+      config = argv[++a];
+    } else if ((startsWith(arga,"--t") || startsWith(arga,"-t")) && a+1 < argc) {
+      timeout = Util::parse_double(argv[++a]);
+    } else if (arga == "--sync" || arga == "-sync") {
+      producer.sync = true;
+    } else if (arga == "--verbose" || arga == "-verbose" || arga == "-v") {
+      producer.verbose = true;
+    } else if (startsWith(arga,"--h") || startsWith(arga,"-h")) {
+      printHelpMsg();
+    } else if (startsWith(arga,"-")) {
+      std::cerr << "** Error: Unknown option " << arga << std::endl;
+      exit(1);
+    } else if (input_file == "") {
+      input_file = arga;
+    } else {
+      std::cerr << "** Error: Only one input file can be provided (" << a << ")" << std::endl;
+      exit(1);
+    }
+  }
+  if (input_file == "") {
+    printHelpMsg();
+  }
+  if (!producer.attach(shm_name,timeout)) {
+    exit(1);
+  }
+  producer.play(input_file,config);
+  return 0;
+}
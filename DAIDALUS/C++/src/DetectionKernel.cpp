@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "DetectionKernel.h"
+#include "WCV_TAUMOD.h"
+#include "WCV_TCPA.h"
+#include "WCV_TEP.h"
+#include "CDCylinder.h"
+#include "TCAS3D.h"
+#include <typeinfo>
+
+namespace larcfm {
+
+DetectionKernel::Kind DetectionKernel::resolve(const Detection3D* det) {
+  // Exact type match: subclasses of the predefined detectors may override their behavior
+  const std::type_info& t = typeid(*det);
+  if (t == typeid(WCV_TAUMOD)) {
+    return WCV_TAUMOD_KIND;
+  }
+  if (t == typeid(WCV_TCPA)) {
+    return WCV_TCPA_KIND;
+  }
+  if (t == typeid(WCV_TEP)) {
+    return WCV_TEP_KIND;
+  }
+  if (t == typeid(CDCylinder)) {
+    return CDCYLINDER_KIND;
+  }
+  if (t == typeid(TCAS3D)) {
+    return TCAS3D_KIND;
+  }
+  return GENERIC;
+}
+
+}
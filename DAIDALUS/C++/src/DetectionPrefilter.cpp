@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "DetectionPrefilter.h"
+#include "DetectionKernel.h"
+#include "WCV_tvar.h"
+#include "CDCylinder.h"
+#include <cmath>
+
+namespace larcfm {
+
+// Relative margin (2^-12) and absolute margin [m] of the screen
+static const float PREFILTER_REL = 1.0f/4096.0f;
+static const float PREFILTER_ABS = 1.0f;
+
+DetectionPrefilter::DetectionPrefilter(const Detection3D* det) {
+  active_ = true;
+  switch (DetectionKernel::kind(det)) {
+  case DetectionKernel::WCV_TAUMOD_KIND:
+  case DetectionKernel::WCV_TCPA_KIND:
+  case DetectionKernel::WCV_TEP_KIND: {
+    const WCV_tvar* wcv = static_cast<const WCV_tvar*>(det);
+    D_ = (float)wcv->getDTHR();
+    TD_ = (float)wcv->getTTHR();
+    H_ = (float)wcv->getZTHR();
+    TH_ = (float)wcv->getTCOA();
+    break;
+  }
+  case DetectionKernel::CDCYLINDER_KIND: {
+    const CDCylinder* cyl = static_cast<const CDCylinder*>(det);
+    D_ = (float)cyl->getHorizontalSeparation();
+    TD_ = 0;
+    H_ = (float)cyl->getVerticalSeparation();
+    TH_ = 0;
+    break;
+  }
+  default:
+    active_ = false;
+    D_ = TD_ = H_ = TH_ = 0;
+  }
+}
+
+void DetectionPrefilter::screen(int n, const float* sx, const float* sy, const float* sz,
+    const float* vx, const float* vy, const float* vz,
+    float b, float e, unsigned char* clear) const {
+  if (!active_) {
+    for (int i = 0; i < n; ++i) {
+      clear[i] = 0;
+    }
+    return;
+  }
+  // Branch-free loop body, suitable for vectorization. NaN/infinite values are never screened out.
+  for (int i = 0; i < n; ++i) {
+    float sqvh = vx[i]*vx[i]+vy[i]*vy[i];
+    float sdotv = sx[i]*vx[i]+sy[i]*vy[i];
+    float t = sqvh > 0.0f ? -sdotv/sqvh : b;
+    t = t < b ? b : (t > e ? e : t);
+    float dx = sx[i]+t*vx[i];
+    float dy = sy[i]+t*vy[i];
+    float nvh = std::sqrt(sqvh);
+    float mag = std::abs(sx[i])+std::abs(sy[i])+std::abs(e)*nvh;
+    float rh = (D_+TD_*nvh)*(1.0f+PREFILTER_REL)+PREFILTER_REL*mag+PREFILTER_ABS;
+    float zb = sz[i]+b*vz[i];
+    float ze = sz[i]+e*vz[i];
+    float zmin = zb*ze <= 0.0f ? 0.0f : (std::abs(zb) < std::abs(ze) ? std::abs(zb) : std::abs(ze));
+    float nvz = std::abs(vz[i]);
+    float rz = (H_+TH_*nvz)*(1.0f+PREFILTER_REL)+PREFILTER_REL*(std::abs(sz[i])+std::abs(e)*nvz)+PREFILTER_ABS;
+    clear[i] = (unsigned char)((dx*dx+dy*dy > rh*rh) | (zmin > rz));
+  }
+}
+
+}
@@ -65,25 +65,19 @@ namespace larcfm {
     }
   }
   
-  static Vect3 equator_map(const Vect3& ref, const Vect3& p) {
-    Vect3 xmult = ref.Hat();
-    Vect3 ymult = vect3_orthog_toy(ref).Hat();
-    Vect3 zmult = ref.cross(vect3_orthog_toy(ref)).Hat();
+  static Vect3 equator_map(const Vect3& xmult, const Vect3& ymult, const Vect3& zmult, const Vect3& p) {
     return Vect3(xmult.dot(p), ymult.dot(p), zmult.dot(p));
   }
   
-  static Vect3 equator_map_inv(const Vect3& ref, const Vect3& p) {
-    Vect3 xmult = ref.Hat();
-    Vect3 ymult = vect3_orthog_toy(ref).Hat();
-    Vect3 zmult = ref.cross(vect3_orthog_toy(ref)).Hat();
+  static Vect3 equator_map_inv(const Vect3& xmult, const Vect3& ymult, const Vect3& zmult, const Vect3& p) {
     Vect3 xmultInv = Vect3(xmult.x, ymult.x, zmult.x);
     Vect3 ymultInv = Vect3(xmult.y, ymult.y, zmult.y);
     Vect3 zmultInv = Vect3(xmult.z, ymult.z, zmult.z);
     return  Vect3(xmultInv.dot(p), ymultInv.dot(p), zmultInv.dot(p));
   }
   
-  static Vect2 sphere_to_plane(const Vect3& ref, const Vect3& p) {
-    Vect3 v = equator_map(ref,p);
+  static Vect2 sphere_to_plane(const Vect3& xmult, const Vect3& ymult, const Vect3& zmult, const Vect3& p) {
+    Vect3 v = equator_map(xmult,ymult,zmult,p);
     return Vect2(v.y, -v.z);
   }
   
@@ -100,18 +94,27 @@ namespace larcfm {
       projAlt = 0;
       ref = Vect3();
       llaRef = LatLonAlt::ZERO();
+      init_basis();
     }
     
     ENUProjection::ENUProjection(const LatLonAlt& lla) {
         projAlt = lla.alt();
         ref = spherical2xyz(lla.lat(),lla.lon());
         llaRef = lla;
+        init_basis();
     }
     
     ENUProjection::ENUProjection(double lat, double lon, double alt) {
         projAlt = alt;
         ref = spherical2xyz(lat,lon);
         llaRef = LatLonAlt::mk(lat, lon, alt);
+        init_basis();
+    }
+
+    void ENUProjection::init_basis() {
+      xmult = ref.Hat();
+      ymult = vect3_orthog_toy(ref).Hat();
+      zmult = ref.cross(vect3_orthog_toy(ref)).Hat();
     }
     
     ENUProjection ENUProjection::makeNew(const LatLonAlt& lla) const {
@@ -144,7 +147,7 @@ namespace larcfm {
 	}
 
     Vect2 ENUProjection::project2(const LatLonAlt& lla) const {
-      return sphere_to_plane(ref, spherical2xyz(lla.lat(),lla.lon()));
+      return sphere_to_plane(xmult, ymult, zmult, spherical2xyz(lla.lat(),lla.lon()));
     }
 
     Vect3 ENUProjection::project(const LatLonAlt& lla) const {
@@ -166,7 +169,7 @@ namespace larcfm {
     }
 
     LatLonAlt ENUProjection::inverse(const Vect2& xy, double alt) const {
-      return xyz2spherical(equator_map_inv(ref, plane_to_sphere(xy)), alt + projAlt);
+      return xyz2spherical(equator_map_inv(xmult, ymult, zmult, plane_to_sphere(xy)), alt + projAlt);
     }
 
     LatLonAlt ENUProjection::inverse(const Vect3& xyz) const {  
@@ -204,6 +207,50 @@ namespace larcfm {
     }
   }
 
+  // Points are processed in passes over flat arrays. The projection of lla[i] is shared by the
+  // position and the velocity of aircraft i, and the basis of the tangent plane is computed once
+  // per projection. Results are the same as those of project and projectVelocity.
+  void ENUProjection::projectList(const std::vector<LatLonAlt>& lla, const std::vector<Velocity>& vel,
+      std::vector<Vect3>& s, std::vector<Velocity>& v) const {
+    double timeStep = 10.0;
+    double r = GreatCircle::spherical_earth_radius;
+    int n = (int)lla.size();
+    // Points 0..n-1 are the given points, points n..2n-1 are the points reached after timeStep
+    std::vector<double> lat(2*n);
+    std::vector<double> lon(2*n);
+    std::vector<double> alt(2*n);
+    for (int i = 0; i < n; ++i) {
+      LatLonAlt ll2 = GreatCircle::linear_initial(lla[i],vel[i],timeStep);
+      lat[i] = lla[i].lat();
+      lon[i] = lla[i].lon();
+      alt[i] = lla[i].alt();
+      lat[n+i] = ll2.lat();
+      lon[n+i] = ll2.lon();
+      alt[n+i] = ll2.alt();
+    }
+    // Same operations as sphere_to_plane(xmult,ymult,zmult,spherical2xyz(lat,lon))
+    std::vector<double> px(2*n);
+    std::vector<double> py(2*n);
+    for (int j = 0; j < 2*n; ++j) {
+      double theta = Pi/2 - lat[j];
+      double phi = Pi - lon[j];
+      double rsintheta = r*std::sin(theta);
+      double x = rsintheta*std::cos(phi);
+      double y = rsintheta*std::sin(phi);
+      double z = r*std::cos(theta);
+      px[j] = ymult.x*x + ymult.y*y + ymult.z*z;
+      py[j] = -(zmult.x*x + zmult.y*y + zmult.z*z);
+    }
+    s.resize(n);
+    v.resize(n);
+    for (int i = 0; i < n; ++i) {
+      Vect3 se = Vect3(px[i], py[i], alt[i] - projAlt);
+      Vect3 s2 = Vect3(px[n+i], py[n+i], alt[n+i] - projAlt);
+      s[i] = se;
+      v[i] = Velocity::make(s2.Sub(se).Scal(1/timeStep));
+    }
+  }
+
   std::pair<Vect3,Velocity> ENUProjection::project(const Position& p, const Velocity& v) const {
    	return std::pair<Vect3,Velocity>(project(p),projectVelocity(p,v));
    }
@@ -31,7 +31,7 @@ void FixedAircraftUrgencyStrategy::setFixedAircraftId(const std::string& id) {
   ac_ = id;
 }
 
-TrafficState FixedAircraftUrgencyStrategy::mostUrgentAircraft(Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T) {
+TrafficState FixedAircraftUrgencyStrategy::mostUrgentAircraft(const Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T) {
   return TrafficState::findAircraft(traffic,ac_);
 }
 
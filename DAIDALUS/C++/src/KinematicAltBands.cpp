@@ -70,8 +70,8 @@ double KinematicAltBands::time_step(const TrafficState& ownship) const {
   return 1;
 }
 
-std::pair<Vect3, Velocity> KinematicAltBands::trajectory(const TrafficState& ownship, double time, bool dir) const {
-  double target_alt = min_val(ownship)+j_step_*get_step();
+std::pair<Vect3, Velocity> KinematicAltBands::trajectory(const TrafficState& ownship, double time, bool dir, int j) const {
+  double target_alt = min_val(ownship)+j*get_step();
   std::pair<Position,Velocity> posvel;
   if (instantaneous_bands()) {
     posvel = std::pair<Position,Velocity>(ownship.getPositionXYZ().mkZ(target_alt),ownship.getVelocityXYZ().mkVs(0));
@@ -88,26 +88,27 @@ std::pair<Vect3, Velocity> KinematicAltBands::trajectory(const TrafficState& own
   return std::pair<Vect3,Velocity>(ownship.pos_to_s(posvel.first),ownship.vel_to_v(posvel.first,posvel.second));
 }
 
-bool KinematicAltBands::any_red(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+bool KinematicAltBands::any_red(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
     int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic) {
   return first_band_alt_generic(conflict_det,recovery_det,B,T,0,B,ownship,traffic,true,false) >= 0 ||
       first_band_alt_generic(conflict_det,recovery_det,B,T,0,B,ownship,traffic,false,false) >= 0;
 }
 
-bool KinematicAltBands::all_red(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+bool KinematicAltBands::all_red(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
     int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic) {
   return first_band_alt_generic(conflict_det,recovery_det,B,T,0,B,ownship,traffic,true,true) < 0 &&
       first_band_alt_generic(conflict_det,recovery_det,B,T,0,B,ownship,traffic,false,true) < 0;
 }
 
-void KinematicAltBands::none_bands(IntervalSet& noneset, Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+void KinematicAltBands::none_bands(IntervalSet& noneset, const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
     int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic) {
+  BANDS_STATS_COUNT(stats_,none_bands_calls,1);
   std::vector<Integerval> altint = std::vector<Integerval>();
   alt_bands_generic(altint,conflict_det,recovery_det,B,T,0,B,ownship,traffic);
   toIntervalSet(noneset,altint,get_step(),min_val(ownship),min_val(ownship),max_val(ownship));
 }
 
-bool KinematicAltBands::conflict_free_traj_step(Detection3D* conflict_det, Detection3D* recovery_det,
+bool KinematicAltBands::conflict_free_traj_step(const Detection3D* conflict_det, const Detection3D* recovery_det,
     double B, double T, double B2, double T2,
     const TrafficState& ownship, const std::vector<TrafficState>& traffic) const {
   bool trajdir = true;
@@ -148,7 +149,7 @@ bool KinematicAltBands::conflict_free_traj_step(Detection3D* conflict_det, Detec
 }
 
 void KinematicAltBands::alt_bands_generic(std::vector<Integerval>& l,
-    Detection3D* conflict_det, Detection3D* recovery_det,
+    const Detection3D* conflict_det, const Detection3D* recovery_det,
     double B, double T, double B2, double T2,
     const TrafficState& ownship, const std::vector<TrafficState>& traffic) {
   int max_step = (int)std::floor((max_val(ownship)-min_val(ownship))/get_step())+1;
@@ -169,7 +170,7 @@ void KinematicAltBands::alt_bands_generic(std::vector<Integerval>& l,
   }
 }
 
-int KinematicAltBands::first_nat(int mini, int maxi, bool dir, Detection3D* conflict_det, Detection3D* recovery_det,
+int KinematicAltBands::first_nat(int mini, int maxi, bool dir, const Detection3D* conflict_det, const Detection3D* recovery_det,
     double B, double T, double B2, double T2, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
     bool green) {
   while (mini <= maxi) {
@@ -192,7 +193,7 @@ int KinematicAltBands::first_nat(int mini, int maxi, bool dir, Detection3D* conf
   return -1;
 }
 
-int KinematicAltBands::first_band_alt_generic(Detection3D* conflict_det, Detection3D* recovery_det,
+int KinematicAltBands::first_band_alt_generic(const Detection3D* conflict_det, const Detection3D* recovery_det,
     double B, double T, double B2, double T2,
     const TrafficState& ownship, const std::vector<TrafficState>& traffic, bool dir, bool green) {
   int upper = (int)(dir ? std::floor((max_val(ownship)-min_val(ownship))/get_step())+1 :
@@ -206,7 +207,7 @@ int KinematicAltBands::first_band_alt_generic(Detection3D* conflict_det, Detecti
 }
 
 // dir=false is down, dir=true is up. Return NaN if there is not a resolution
-double KinematicAltBands::resolution(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+double KinematicAltBands::resolution(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
     int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
     bool dir) {
   int ires = first_band_alt_generic(conflict_det,recovery_det,B,T,0,B,ownship,traffic,dir,true);
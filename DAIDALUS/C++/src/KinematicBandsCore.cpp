@@ -12,6 +12,7 @@
 #include "string_util.h"
 #include "format.h"
 #include "CriteriaCore.h"
+#include "DetectionKernel.h"
 #include <string>
 #include <vector>
 
@@ -22,7 +23,7 @@ TCASTable KinematicBandsCore::RA = TCASTable();
 KinematicBandsCore::KinematicBandsCore(const KinematicBandsParameters& params) {
   ownship = TrafficState::INVALID;
   traffic = std::vector<TrafficState>();
-  parameters = KinematicBandsParameters(params);
+  parameters = params;
   most_urgent_ac = TrafficState::INVALID;
   conflict_acs_ = std::vector< std::vector<TrafficState> >();
   tiov_ = std::vector<Interval>();
@@ -50,7 +51,7 @@ void KinematicBandsCore::setKinematicBandsCore(const KinematicBandsCore& core) {
   ownship = core.ownship;
   traffic = std::vector<TrafficState>();
   traffic.insert(traffic.end(),core.traffic.begin(),core.traffic.end());
-  parameters = KinematicBandsParameters(core.parameters);
+  parameters = core.parameters;
   most_urgent_ac = core.most_urgent_ac;
   conflict_acs_ = std::vector< std::vector<TrafficState> >();
   tiov_ = std::vector<Interval>();
@@ -83,6 +84,7 @@ void KinematicBandsCore::reset() {
  */
 void KinematicBandsCore::update() {
   if (outdated_) {
+    BANDS_STATS_TIMER(&stats,core_update_time);
     current_alert_ = 0;
     for (int alert_level=1; alert_level <= parameters.alertor.mostSevereAlertLevel(); ++alert_level) {
       if (alert_level-1 >= (int) conflict_acs_.size()) {
@@ -90,7 +92,16 @@ void KinematicBandsCore::update() {
       } else {
         conflict_acs_[alert_level-1].clear();
       }
-      conflict_aircraft(alert_level);
+    }
+    std::vector<const WCV_TAUMOD*> dets;
+    if (fusedLevelDetectors(dets)) {
+      conflict_aircraft_fused(dets);
+    } else {
+      for (int alert_level=1; alert_level <= parameters.alertor.mostSevereAlertLevel(); ++alert_level) {
+        conflict_aircraft(alert_level);
+      }
+    }
+    for (int alert_level=1; alert_level <= parameters.alertor.mostSevereAlertLevel(); ++alert_level) {
       if (!conflict_acs_[alert_level-1].empty()) {
         current_alert_ = alert_level;
       }
@@ -167,11 +178,12 @@ void KinematicBandsCore::conflict_aircraft(int alert_level) {
   double tin  = PINFINITY;
   double tout = NINFINITY;
   bool conflict_band = BandsRegion::isConflictBand(parameters.alertor.getLevel(alert_level).getRegion());
-  Detection3D* detector = parameters.alertor.getLevel(alert_level).getDetectorRef();
+  const Detection3D* detector = parameters.alertor.getLevel(alert_level).getDetectorRef();
   double alerting_time = Util::min(parameters.getLookaheadTime(),
       parameters.alertor.getLevel(alert_level).getAlertingTime());
   for (TrafficState::nat i = 0; i < traffic.size(); ++i) {
     TrafficState ac = traffic[i];
+    BANDS_STATS_COUNT(&stats,detector_calls,2);
     ConflictData det = detector->conflictDetection(ownship.get_s(),ownship.get_v(),ac.get_s(),ac.get_v(),
         0,parameters.getLookaheadTime());
     bool lowc = detector->violation(ownship.get_s(),ownship.get_v(),ac.get_s(),ac.get_v());
@@ -186,6 +198,63 @@ void KinematicBandsCore::conflict_aircraft(int alert_level) {
   tiov_.push_back(Interval(tin,tout));
 }
 
+void KinematicBandsCore::conflict_aircraft_fused(const std::vector<const WCV_TAUMOD*>& dets) {
+  int levels = (int) dets.size();
+  std::vector<double> tin(levels,PINFINITY);
+  std::vector<double> tout(levels,NINFINITY);
+  std::vector<bool> conflict_band(levels);
+  std::vector<double> alerting_time(levels);
+  std::vector<double> T(levels,parameters.getLookaheadTime());
+  for (int k = 0; k < levels; ++k) {
+    const AlertThresholds& athr = parameters.alertor.getLevel(k+1);
+    conflict_band[k] = BandsRegion::isConflictBand(athr.getRegion());
+    alerting_time[k] = Util::min(parameters.getLookaheadTime(),athr.getAlertingTime());
+  }
+  std::vector<ConflictData> dets_cd;
+  std::vector<bool> dets_lowc;
+  for (TrafficState::nat i = 0; i < traffic.size(); ++i) {
+    const TrafficState& ac = traffic[i];
+    BANDS_STATS_COUNT(&stats,detector_calls,1);
+    WCV_TAUMOD::conflictDetectionLevels(dets,ownship.get_s(),ownship.get_v(),ac.get_s(),ac.get_v(),
+        0,T,dets_cd,dets_lowc);
+    for (int k = 0; k < levels; ++k) {
+      const ConflictData& det = dets_cd[k];
+      bool lowc = dets_lowc[k];
+      if (lowc || det.conflict()) {
+        if (conflict_band[k] && (lowc || det.getTimeIn() < alerting_time[k])) {
+          conflict_acs_[k].push_back(ac);
+        }
+        tin[k] = Util::min(tin[k],det.getTimeIn());
+        tout[k] = Util::max(tout[k],det.getTimeOut());
+      }
+    }
+  }
+  for (int k = 0; k < levels; ++k) {
+    tiov_.push_back(Interval(tin[k],tout[k]));
+  }
+}
+
+bool KinematicBandsCore::fusedLevelDetectors(std::vector<const WCV_TAUMOD*>& dets) const {
+  dets.clear();
+  int levels = parameters.alertor.mostSevereAlertLevel();
+  // A single level doesn't have anything to share
+  if (levels < 2) {
+    return false;
+  }
+  for (int alert_level=1; alert_level <= levels; ++alert_level) {
+    const AlertThresholds& athr = parameters.alertor.getLevel(alert_level);
+    if (!athr.isValid()) {
+      return false;
+    }
+    const Detection3D* detector = athr.getDetectorRef();
+    if (DetectionKernel::kind(detector) != DetectionKernel::WCV_TAUMOD_KIND) {
+      return false;
+    }
+    dets.push_back(static_cast<const WCV_TAUMOD*>(detector));
+  }
+  return true;
+}
+
 /**
  * Return list of conflict aircraft for a given alert level.
  * Requires: 1 <= alert_level <= parameters.alertor.mostSevereAlertLevel()
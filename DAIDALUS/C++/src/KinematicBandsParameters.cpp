@@ -19,148 +19,128 @@ namespace larcfm {
  */
 const std::string KinematicBandsParameters::VERSION = "1.0.2";
 
+/**
+ * Schema of the parameters, indexed by KinematicBandsParameters::Key: name in configuration files,
+ * default units, kind of value, and comment of the section that starts at the key, if any.
+ */
+struct ParameterSchema {
+  const char* name;
+  const char* units;   // Default units, "unspecified" for keys without units
+  bool boolean;
+  const char* section; // Empty if the key doesn't start a section
+};
+
+static const ParameterSchema parameter_schema[KinematicBandsParameters::KEYS] = {
+    {"lookahead_time","s",false,"Bands Parameters"},
+    {"left_trk","deg",false,""},
+    {"right_trk","deg",false,""},
+    {"min_gs","knot",false,""},
+    {"max_gs","knot",false,""},
+    {"min_vs","fpm",false,""},
+    {"max_vs","fpm",false,""},
+    {"min_alt","ft",false,""},
+    {"max_alt","ft",false,""},
+    {"trk_step","deg",false,"Kinematic Parameters"},
+    {"gs_step","knot",false,""},
+    {"vs_step","fpm",false,""},
+    {"alt_step","ft",false,""},
+    {"horizontal_accel","m/s^2",false,""},
+    {"vertical_accel","G",false,""},
+    {"turn_rate","deg/s",false,""},
+    {"bank_angle","deg",false,""},
+    {"vertical_rate","fpm",false,""},
+    {"recovery_stability_time","s",false,"Recovery Bands Parameters"},
+    {"min_horizontal_recovery","nmi",false,""},
+    {"min_vertical_recovery","ft",false,""},
+    {"recovery_trk","unspecified",true,""},
+    {"recovery_gs","unspecified",true,""},
+    {"recovery_vs","unspecified",true,""},
+    {"recovery_alt","unspecified",true,""},
+    {"ca_bands","unspecified",true,"Collision Avoidance Bands Parameters"},
+    {"ca_factor","unspecified",false,""},
+    {"horizontal_nmac","ft",false,""},
+    {"vertical_nmac","ft",false,""},
+    {"conflict_crit","unspecified",true,"Implicit Coordination Parameters"},
+    {"recovery_crit","unspecified",true,""},
+    {"contour_thr","deg",false,"Horizontal Contour Threshold"}
+};
+
+static std::vector<std::string> make_key_names() {
+  std::vector<std::string> names;
+  for (int key = 0; key < KinematicBandsParameters::KEYS; ++key) {
+    names.push_back(parameter_schema[key].name);
+  }
+  return names;
+}
+
+// Names of the keys, in the order of KinematicBandsParameters::Key
+static const std::vector<std::string>& key_names() {
+  static const std::vector<std::string> names = make_key_names();
+  return names;
+}
+
 /* NOTE: By default, no alert levels are configured */
 KinematicBandsParameters::KinematicBandsParameters() : error("DaidalusParameters") {
 
+  for (int key = 0; key < KEYS; ++key) {
+    units_[key] = parameter_schema[key].units;
+  }
+
   // Bands Parameters
   lookahead_time_ = 180.0; // [s]
-  keys_.push_back("lookahead_time");
-  units_["lookahead_time"] = "s";
-
   left_trk_  = Units::from("deg",180.0);
-  keys_.push_back("left_trk");
-  units_["left_trk"] = "deg";
-
   right_trk_ = Units::from("deg",180.0);
-  keys_.push_back("right_trk");
-  units_["right_trk"] = "deg";
-
   min_gs_  = Units::from("knot",10.0);
-  keys_.push_back("min_gs");
-  units_["min_gs"] = "knot";
-
   max_gs_  = Units::from("knot",700.0);
-  keys_.push_back("max_gs");
-  units_["max_gs"] = "knot";
-
   min_vs_  = Units::from("fpm",-6000.0);
-  keys_.push_back("min_vs");
-  units_["min_vs"] = "fpm";
-
   max_vs_  = Units::from("fpm",6000.0);
-  keys_.push_back("max_vs");
-  units_["max_vs"] = "fpm";
-
   min_alt_ = Units::from("ft",100.0);
-  keys_.push_back("min_alt");
-  units_["min_alt"] = "ft";
-
   max_alt_ = Units::from("ft",50000.0);
-  keys_.push_back("max_alt");
-  units_["max_alt"] = "ft";
 
   // Kinematic Parameters
   trk_step_ = Units::from("deg",1.0);
-  keys_.push_back("trk_step");
-  units_["trk_step"] = "deg";
-
   gs_step_ = Units::from("knot",5.0);
-  keys_.push_back("gs_step");
-  units_["gs_step"] = "knot";
-
   vs_step_ = Units::from("fpm",100.0);
-  keys_.push_back("vs_step");
-  units_["vs_step"] = "fpm";
-
   alt_step_ = Units::from("ft", 100.0);
-  keys_.push_back("alt_step");
-  units_["alt_step"] = "ft";
-
   horizontal_accel_ = Units::from("m/s^2",2.0);
-  keys_.push_back("horizontal_accel");
-  units_["horizontal_accel"] = "m/s^2";
-
   vertical_accel_ = Units::from("G",0.25);    // Section 1.2.3, DAA MOPS V3.6
-  keys_.push_back("vertical_accel");
-  units_["vertical_accel"] = "G";
-
   turn_rate_ = Units::from("deg/s",3.0); // Section 1.2.3, DAA MOPS V3.6
-  keys_.push_back("turn_rate");
-  units_["turn_rate"] = "deg/s";
-
   bank_angle_ = 0.0;
-  keys_.push_back("bank_angle");
-  units_["bank_angle"] = "deg";
-
   vertical_rate_ = Units::from("fpm",500.0);   // Section 1.2.3, DAA MOPS V3.6
-  keys_.push_back("vertical_rate");
-  units_["vertical_rate"] = "fpm";
 
   // Recovery Bands Parameters
   recovery_stability_time_ = 2.0; // [s]
-  keys_.push_back("recovery_stability_time");
-  units_["recovery_stability_time"] = "s";
-
   min_horizontal_recovery_ = 0.0;
-  keys_.push_back("min_horizontal_recovery");
-  units_["min_horizontal_recovery"] = "nmi";
-
   min_vertical_recovery_ = 0.0;
-  keys_.push_back("min_vertical_recovery");
-  units_["min_vertical_recovery"] = "ft";
-
   recovery_trk_ = true;
-  keys_.push_back("recovery_trk");
-
   recovery_gs_ = true;
-  keys_.push_back("recovery_gs");
-
   recovery_vs_ = true;
-  keys_.push_back("recovery_vs");
-
   recovery_alt_ = true;
-  keys_.push_back("recovery_alt");
 
   // Collision Avoidance Bands Parameters
   ca_bands_ = false;
-  keys_.push_back("ca_bands");
-
   ca_factor_ = 0.2;
-  keys_.push_back("ca_factor");
-
   horizontal_nmac_ = ACCoRDConfig::NMAC_D;      // Defined in RTCA SC-147
-  keys_.push_back("horizontal_nmac");
-  units_["horizontal_nmac"] = "ft";
-
   vertical_nmac_ = ACCoRDConfig::NMAC_H;        // Defined in RTCA SC-147
-  keys_.push_back("vertical_nmac");
-  units_["vertical_nmac"] = "ft";
 
   // Implicit Coordination Parameters
   conflict_crit_ = false;
-  keys_.push_back("conflict_crit");
-
   recovery_crit_ = false;
-  keys_.push_back("recovery_crit");
 
   // Horizontal Contour Threshold
   contour_thr_ = Units::from("deg",180.0);
-  keys_.push_back("contour_thr");
-  units_["contour_thr"] = "deg";
 
   // Alert Levels
   alertor = AlertLevels();
 }
 
 KinematicBandsParameters::KinematicBandsParameters(const KinematicBandsParameters& parameters) : error("DaidalusParameters") {
-  keys_ = parameters.keys_;
   setKinematicBandsParameters(parameters);
 }
 
 KinematicBandsParameters::~KinematicBandsParameters() {}
 
 KinematicBandsParameters& KinematicBandsParameters::operator=(const KinematicBandsParameters& parameters) {
-  keys_ = parameters.keys_;
   setKinematicBandsParameters(parameters);
   return *this;
 }
@@ -169,7 +149,9 @@ KinematicBandsParameters& KinematicBandsParameters::operator=(const KinematicBan
  * Set kinematic bands parameters
  */
 void KinematicBandsParameters::setKinematicBandsParameters(const KinematicBandsParameters& parameters) {
-  units_ = parameters.units_;
+  for (int key = 0; key < KEYS; ++key) {
+    units_[key] = parameters.units_[key];
+  }
 
   // Bands
   lookahead_time_ = parameters.lookahead_time_;
@@ -212,7 +194,7 @@ void KinematicBandsParameters::setKinematicBandsParameters(const KinematicBandsP
   contour_thr_ = parameters.contour_thr_;
 
   // Alert levels
-  alertor = AlertLevels(parameters.alertor);
+  alertor.copy(parameters.alertor);
 }
 
 /**
@@ -549,7 +531,7 @@ bool KinematicBandsParameters::setLookaheadTime(double val)  {
  * Set lookahead time to value in specified units [u]
  */
 bool KinematicBandsParameters::setLookaheadTime(double val, const std::string& u)  {
-  units_["lookahead_time"] = u;
+  units_[LOOKAHEAD_TIME] = u;
   return setLookaheadTime(Units::from(u,val));
 }
 
@@ -565,7 +547,7 @@ bool KinematicBandsParameters::setLeftTrack(double val) {
  * Set left track to value in specified units [u]. Value is expected to be in [0 - pi]
  */
 bool KinematicBandsParameters::setLeftTrack(double val, const std::string& u) {
-  units_["left_trk"] = u;
+  units_[LEFT_TRK] = u;
   return setLeftTrack(Units::from(u,val));
 }
 
@@ -581,7 +563,7 @@ bool KinematicBandsParameters::setRightTrack(double val) {
  * Set right track to value in specified units [u]. Value is expected to be in [0 - pi]
  */
 bool KinematicBandsParameters::setRightTrack(double val, const std::string& u) {
-  units_["right_trk"] = u;
+  units_[RIGHT_TRK] = u;
   return setRightTrack(Units::from(u,val));
 }
 
@@ -599,7 +581,7 @@ bool KinematicBandsParameters::setMinGroundSpeed(double val)  {
  * Minimum ground speed must be greater than ground speed step.
  */
 bool KinematicBandsParameters::setMinGroundSpeed(double val, const std::string& u)  {
-  units_["min_gs"] = u;
+  units_[MIN_GS] = u;
   return setMinGroundSpeed(Units::from(u,val));
 }
 
@@ -615,7 +597,7 @@ bool KinematicBandsParameters::setMaxGroundSpeed(double val)  {
  * Set maximum ground speed to value in specified units [u]
  */
 bool KinematicBandsParameters::setMaxGroundSpeed(double val, const std::string& u)  {
-  units_["max_gs"] = u;
+  units_[MAX_GS] = u;
   return setMaxGroundSpeed(Units::from(u,val));
 }
 
@@ -631,7 +613,7 @@ bool KinematicBandsParameters::setMinVerticalSpeed(double val)  {
  * Set minimum vertical speed to value in specified units [u]
  */
 bool KinematicBandsParameters::setMinVerticalSpeed(double val, const std::string& u)  {
-  units_["min_vs"] = u;
+  units_[MIN_VS] = u;
   return setMinVerticalSpeed(Units::from(u,val));
 }
 
@@ -647,7 +629,7 @@ bool KinematicBandsParameters::setMaxVerticalSpeed(double val)  {
  * Set maximum vertical speed to value in specified units [u]
  */
 bool KinematicBandsParameters::setMaxVerticalSpeed(double val, const std::string& u)  {
-  units_["max_vs"] = u;
+  units_[MAX_VS] = u;
   return setMaxVerticalSpeed(Units::from(u,val));
 }
 
@@ -663,7 +645,7 @@ bool KinematicBandsParameters::setMinAltitude(double val)  {
  * Set minimum altitude to value in specified units [u]
  */
 bool KinematicBandsParameters::setMinAltitude(double val, const std::string& u)  {
-  units_["min_alt"] = u;
+  units_[MIN_ALT] = u;
   return setMinAltitude(Units::from(u,val));
 }
 
@@ -679,7 +661,7 @@ bool KinematicBandsParameters::setMaxAltitude(double val)  {
  * Set maximum altitude to value in specified units [u]
  */
 bool KinematicBandsParameters::setMaxAltitude(double val, const std::string& u)  {
-  units_["max_alt"] = u;
+  units_[MAX_ALT] = u;
   return setMaxAltitude(Units::from(u,val));
 }
 
@@ -696,7 +678,7 @@ bool KinematicBandsParameters::setTrackStep(double val)  {
  * Set track step to value in specified units [u]
  */
 bool KinematicBandsParameters::setTrackStep(double val, const std::string& u)  {
-  units_["trk_step"] = u;
+  units_[TRK_STEP] = u;
   return setTrackStep(Units::from(u,val));
 }
 
@@ -712,7 +694,7 @@ bool KinematicBandsParameters::setGroundSpeedStep(double val)  {
  * Set ground speed step to value in specified units [u]
  */
 bool KinematicBandsParameters::setGroundSpeedStep(double val, const std::string& u)  {
-  units_["gs_step"] = u;
+  units_[GS_STEP] = u;
   return setGroundSpeedStep(Units::from(u,val));
 }
 
@@ -728,7 +710,7 @@ bool KinematicBandsParameters::setVerticalSpeedStep(double val)  {
  * Set vertical speed step to value in specified units [u]
  */
 bool KinematicBandsParameters::setVerticalSpeedStep(double val, const std::string& u)  {
-  units_["vs_step"] = u;
+  units_[VS_STEP] = u;
   return setVerticalSpeedStep(Units::from(u,val));
 }
 
@@ -744,7 +726,7 @@ bool KinematicBandsParameters::setAltitudeStep(double val)  {
  * Set altitude step to value in specified units [u]
  */
 bool KinematicBandsParameters::setAltitudeStep(double val, const std::string& u)  {
-  units_["alt_step"] = u;
+  units_[ALT_STEP] = u;
   return setAltitudeStep(Units::from(u,val));
 }
 
@@ -760,7 +742,7 @@ bool KinematicBandsParameters::setHorizontalAcceleration(double val)  {
  * Set horizontal acceleration to value in specified units [u]
  */
 bool KinematicBandsParameters::setHorizontalAcceleration(double val, const std::string& u)  {
-  units_["horizontal_accel"] = u;
+  units_[HORIZONTAL_ACCEL] = u;
   return setHorizontalAcceleration(Units::from(u,val));
 }
 
@@ -776,7 +758,7 @@ bool KinematicBandsParameters::setVerticalAcceleration(double val)  {
  * Set vertical acceleration to value in specified units [u]
  */
 bool KinematicBandsParameters::setVerticalAcceleration(double val, const std::string& u)  {
-  units_["vertical_accel"] = u;
+  units_[VERTICAL_ACCEL] = u;
   return setVerticalAcceleration(Units::from(u,val));
 }
 
@@ -804,7 +786,7 @@ bool KinematicBandsParameters::setTurnRate(double val)  {
  * resets the bank angle.
  */
 bool KinematicBandsParameters::setTurnRate(double val, const std::string& u)  {
-  units_["turn_rate"] = u;
+  units_[TURN_RATE] = u;
   return setTurnRate(Units::from(u,val));
 }
 
@@ -823,7 +805,7 @@ bool KinematicBandsParameters::setBankAngle(double val)  {
  * resets the turn rate.
  */
 bool KinematicBandsParameters::setBankAngle(double val, const std::string& u)  {
-  units_["bank_angle"] = u;
+  units_[BANK_ANGLE] = u;
   return setBankAngle(Units::from(u,val));
 }
 
@@ -839,7 +821,7 @@ bool KinematicBandsParameters::setVerticalRate(double val)  {
  * Set vertical rate to value in specified units [u]
  */
 bool KinematicBandsParameters::setVerticalRate(double val, const std::string& u)  {
-  units_["vertical_rate"] = u;
+  units_[VERTICAL_RATE] = u;
   return setVerticalRate(Units::from(u,val));
 }
 
@@ -855,7 +837,7 @@ bool KinematicBandsParameters::setHorizontalNMAC(double val) {
  * Set horizontal NMAC distance to value in specified units [u].
  */
 bool KinematicBandsParameters::setHorizontalNMAC(double val, const std::string& u){
-  units_["horizontal_nmac"] = u;
+  units_[HORIZONTAL_NMAC] = u;
   return setHorizontalNMAC(Units::from(u,val));
 }
 
@@ -871,7 +853,7 @@ bool KinematicBandsParameters::setVerticalNMAC(double val) {
  * Set vertical NMAC distance to value in specified units [u].
  */
 bool KinematicBandsParameters::setVerticalNMAC(double val, const std::string& u) {
-  units_["vertical_nmac"] = u;
+  units_[VERTICAL_NMAC] = u;
   return setVerticalNMAC(Units::from(u,val));
 }
 
@@ -887,7 +869,7 @@ bool KinematicBandsParameters::setRecoveryStabilityTime(double val)  {
  * Set recovery stability time to value in specified units [u]
  */
 bool KinematicBandsParameters::setRecoveryStabilityTime(double val, const std::string& u)  {
-  units_["recovery_stability_time"] = u;
+  units_[RECOVERY_STABILITY_TIME] = u;
   return setRecoveryStabilityTime(Units::from(u,val));
 }
 
@@ -903,7 +885,7 @@ bool KinematicBandsParameters::setMinHorizontalRecovery(double val)  {
  * Set minimum recovery horizontal distance to value in specified units [u]
  */
 bool KinematicBandsParameters::setMinHorizontalRecovery(double val, const std::string& u)  {
-  units_["min_horizontal_recovery"] = u;
+  units_[MIN_HORIZONTAL_RECOVERY] = u;
   return setMinHorizontalRecovery(Units::from(u,val));
 }
 
@@ -919,7 +901,7 @@ bool KinematicBandsParameters::setMinVerticalRecovery(double val)  {
  * Set minimum recovery vertical distance to value in specified units [u]
  */
 bool KinematicBandsParameters::setMinVerticalRecovery(double val, const std::string& u)  {
-  units_["min_vertical_recovery"] = u;
+  units_[MIN_VERTICAL_RECOVERY] = u;
   return setMinVerticalRecovery(Units::from(u,val));
 }
 
@@ -1159,7 +1141,7 @@ bool KinematicBandsParameters::setHorizontalContourThreshold(double val) {
  * A value of pi means all contours.
  */
 bool KinematicBandsParameters::setHorizontalContourThreshold(double val, const std::string& u) {
-  units_["contour_thr"] = u;
+  units_[CONTOUR_THR] = u;
   return setHorizontalContourThreshold(Units::from(u,val));
 }
 
@@ -1220,7 +1202,7 @@ std::string KinematicBandsParameters::toString() const {
   std::string s = "# V-"+VERSION+"\n";
   ParameterData p;
   updateParameterData(p);
-  s+=p.listToString(keys_);
+  s+=p.listToString(key_names());
   s+="# Alert Levels\n";
   ParameterData q;
   alertor.updateParameterData(q);
@@ -1275,200 +1257,161 @@ ParameterData KinematicBandsParameters::getParameters() const {
 }
 
 void KinematicBandsParameters::updateParameterData(ParameterData& p) const {
-  // Bands Parameters
-  p.setInternal("lookahead_time", lookahead_time_, getUnits("lookahead_time"));
-  p.updateComment("lookahead_time","Bands Parameters");
-
-  p.setInternal("left_trk", left_trk_, getUnits("left_trk"));
-  p.setInternal("right_trk", right_trk_, getUnits("right_trk"));
-  p.setInternal("min_gs", min_gs_, getUnits("min_gs"));
-  p.setInternal("max_gs", max_gs_, getUnits("max_gs"));
-  p.setInternal("min_vs", min_vs_, getUnits("min_vs"));
-  p.setInternal("max_vs", max_vs_, getUnits("max_vs"));
-  p.setInternal("min_alt", min_alt_, getUnits("min_alt"));
-  p.setInternal("max_alt", max_alt_, getUnits("max_alt"));
-
-  // Kinematic Parameters
-  p.setInternal("trk_step", trk_step_, getUnits("trk_step"));
-  p.updateComment("trk_step","Kinematic Parameters");
-
-  p.setInternal("gs_step", gs_step_, getUnits("gs_step"));
-  p.setInternal("vs_step", vs_step_, getUnits("vs_step"));
-  p.setInternal("alt_step", alt_step_, getUnits("alt_step"));
-  p.setInternal("horizontal_accel", horizontal_accel_, getUnits("horizontal_accel"));
-  p.setInternal("vertical_accel", vertical_accel_, getUnits("vertical_accel"));
-  p.setInternal("turn_rate", turn_rate_, getUnits("turn_rate"));
-  p.setInternal("bank_angle", bank_angle_, getUnits("bank_angle"));
-  p.setInternal("vertical_rate", vertical_rate_, getUnits("vertical_rate"));
-
-  // Recovery Bands Parameters
-  p.setInternal("recovery_stability_time", recovery_stability_time_, getUnits("recovery_stability_time"));
-  p.updateComment("recovery_stability_time","Recovery Bands Parameters");
-
-  p.setInternal("min_horizontal_recovery", min_horizontal_recovery_, getUnits("min_horizontal_recovery"));
-  p.setInternal("min_vertical_recovery", min_vertical_recovery_, getUnits("min_vertical_recovery"));
-  p.setBool("recovery_trk", recovery_trk_);
-  p.setBool("recovery_gs", recovery_gs_);
-  p.setBool("recovery_vs", recovery_vs_);
-  p.setBool("recovery_alt", recovery_alt_);
-
-  // Collision Avoidance Bands Parameters
-  p.setBool("ca_bands", ca_bands_);
-  p.updateComment("ca_bands","Collision Avoidance Bands Parameters");
-
-  p.setInternal("ca_factor", ca_factor_, "unitless");
-  p.setInternal("horizontal_nmac",horizontal_nmac_, getUnits("horizontal_nmac"));
-  p.setInternal("vertical_nmac",vertical_nmac_, getUnits("vertical_nmac"));
-
-  // Implicit Coordination Parameters
-  p.setBool("conflict_crit", conflict_crit_);
-  p.updateComment("conflict_crit","Implicit Coordination Parameters");
-  p.setBool("recovery_crit", recovery_crit_);
-
-  // Horizontal Contour Threshold
-  p.setInternal("contour_thr", contour_thr_, getUnits("contour_thr"));
-  p.updateComment("contour_thr","Horizontal Contour Threshold");
-
+  for (int k = 0; k < KEYS; ++k) {
+    Key key = (Key)k;
+    const std::string& name = keyName(key);
+    if (parameter_schema[key].boolean) {
+      p.setBool(name, getValue(key) != 0.0);
+    } else if (key == CA_FACTOR) {
+      p.setInternal(name, ca_factor_, "unitless");
+    } else {
+      p.setInternal(name, getValue(key), getUnits(key));
+    }
+    if (parameter_schema[key].section[0] != '\0') {
+      p.updateComment(name, parameter_schema[key].section);
+    }
+  }
   // Alertor
   alertor.updateParameterData(p);
 }
 
-void KinematicBandsParameters::setParameters(const ParameterData& p) {
-  if (p.contains("lookahead_time")) {
-    setLookaheadTime(p.getValue("lookahead_time"));
-    units_["lookahead_time"] = p.getUnit("lookahead_time");
-  }
-  if (p.contains("left_trk")) {
-    setLeftTrack(p.getValue("left_trk"));
-    units_["left_trk"] = p.getUnit("left_trk");
-  }
-  if (p.contains("right_trk")) {
-    setRightTrack(p.getValue("right_trk"));
-    units_["right_trk"] = p.getUnit("right_trk");
-  }
-  if (p.contains("min_gs")) {
-    setMinGroundSpeed(p.getValue("min_gs"));
-    units_["min_gs"] = p.getUnit("min_gs");
-  }
-  if (p.contains("max_gs")) {
-    setMaxGroundSpeed(p.getValue("max_gs"));
-    units_["max_gs"] = p.getUnit("max_gs");
-  }
-  if (p.contains("min_vs")) {
-    setMinVerticalSpeed(p.getValue("min_vs"));
-    units_["min_vs"] = p.getUnit("min_vs");
-  }
-  if (p.contains("max_vs")) {
-    setMaxVerticalSpeed(p.getValue("max_vs"));
-    units_["max_vs"] = p.getUnit("max_vs");
-  }
-  if (p.contains("min_alt")) {
-    setMinAltitude(p.getValue("min_alt"));
-    units_["min_alt"] = p.getUnit("min_alt");
-  }
-  if (p.contains("max_alt")) {
-    setMaxAltitude(p.getValue("max_alt"));
-    units_["max_alt"] = p.getUnit("max_alt");
-  }
-  // Kinematic bands
-  if (p.contains("trk_step")) {
-    setTrackStep(p.getValue("trk_step"));
-    units_["trk_step"] = p.getUnit("trk_step");
-  }
-  if (p.contains("gs_step")) {
-    setGroundSpeedStep(p.getValue("gs_step"));
-    units_["gs_step"] = p.getUnit("gs_step");
-  }
-  if (p.contains("vs_step")) {
-    setVerticalSpeedStep(p.getValue("vs_step"));
-    units_["vs_step"] = p.getUnit("vs_step");
-  }
-  if (p.contains("alt_step")) {
-    setAltitudeStep(p.getValue("alt_step"));
-    units_["alt_step"] = p.getUnit("alt_step");
-  }
-  if (p.contains("horizontal_accel")) {
-    setHorizontalAcceleration(p.getValue("horizontal_accel"));
-    units_["horizontal_accel"] = p.getUnit("horizontal_accel");
-  }
-  if (p.contains("vertical_accel")) {
-    setVerticalAcceleration(p.getValue("vertical_accel"));
-    units_["vertical_accel"] = p.getUnit("vertical_accel");
-  }
-  if (p.contains("turn_rate")) {
-    set_turn_rate(p.getValue("turn_rate"));
-    units_["turn_rate"] = p.getUnit("turn_rate");
-  }
-  if (p.contains("bank_angle")) {
-    set_bank_angle(p.getValue("bank_angle"));
-    units_["bank_angle"] = p.getUnit("bank_angle");
-  }
-  if (p.contains("vertical_rate")) {
-    setVerticalRate(p.getValue("vertical_rate"));
-    units_["vertical_rate"] = p.getUnit("vertical_rate");
-  }
-  if (p.contains("horizontal_nmac")) {
-    setHorizontalNMAC(p.getValue("horizontal_nmac"));
-    units_["horizontal_nmac"] = p.getUnit("horizontal_nmac");
-  }
-  if (p.contains("vertical_nmac")) {
-    setVerticalNMAC(p.getValue("vertical_nmac"));
-    units_["vertical_nmac"] = p.getUnit("vertical_nmac");
-  }
-  // Recovery bands
-  if (p.contains("recovery_stability_time")) {
-    setRecoveryStabilityTime(p.getValue("recovery_stability_time"));
-    units_["recovery_stability_time"] = p.getUnit("recovery_stability_time");
-  }
-  if (p.contains("min_horizontal_recovery")) {
-    setMinHorizontalRecovery(p.getValue("min_horizontal_recovery"));
-    units_["min_horizontal_recovery"] = p.getUnit("min_horizontal_recovery");
-  }
-  if (p.contains("min_vertical_recovery")) {
-    setMinVerticalRecovery(p.getValue("min_vertical_recovery"));
-    units_["min_vertical_recovery"] = p.getUnit("min_vertical_recovery");
-  }
-  // Criteria parameters
-  if (p.contains("conflict_crit")) {
-    setConflictCriteria(p.getBool("conflict_crit"));
-  }
-  if (p.contains("recovery_crit")) {
-    setRecoveryCriteria(p.getBool("recovery_crit"));
-  }
-  // Recovery parameters
-  if (p.contains("recovery_trk")) {
-    setRecoveryTrackBands(p.getBool("recovery_trk"));
-  }
-  if (p.contains("recovery_gs")) {
-    setRecoveryGroundSpeedBands(p.getBool("recovery_gs"));
-  }
-  if (p.contains("recovery_vs")) {
-    setRecoveryVerticalSpeedBands(p.getBool("recovery_vs"));
-  }
-  if (p.contains("recovery_alt")) {
-    setRecoveryAltitudeBands(p.getBool("recovery_alt"));
-  }
-  if (p.contains("ca_bands")) {
-    setCollisionAvoidanceBands(p.getBool("ca_bands"));
-  }
-  if (p.contains("ca_factor")) {
-    setCollisionAvoidanceBandsFactor(p.getValue("ca_factor"));
+/*
+ * Only one of turn rate and bank angle is in effect, see setTurnRate and setBankAngle, but
+ * configuration files have both. Return true if key is one of them and its value in p is superseded
+ * by the other one: a zero value doesn't reset the other one, and turn rate takes precedence.
+ */
+static bool superseded_turn_key(const ParameterData& p, KinematicBandsParameters::Key key) {
+  if (key != KinematicBandsParameters::TURN_RATE && key != KinematicBandsParameters::BANK_ANGLE) {
+    return false;
   }
-  // Contours
-  if (p.contains("contour_thr")) {
-    setHorizontalContourThreshold(p.getValue("contour_thr"));
-    units_["contour_thr"] = p.getUnit("contour_thr");
+  const std::string& other = KinematicBandsParameters::keyName(key == KinematicBandsParameters::TURN_RATE ?
+      KinematicBandsParameters::BANK_ANGLE : KinematicBandsParameters::TURN_RATE);
+  return p.contains(other) && p.getValue(other) != 0 &&
+      (p.getValue(KinematicBandsParameters::keyName(key)) == 0 || key == KinematicBandsParameters::BANK_ANGLE);
+}
+
+void KinematicBandsParameters::setParameters(const ParameterData& p) {
+  for (int k = 0; k < KEYS; ++k) {
+    Key key = (Key)k;
+    const std::string& name = keyName(key);
+    if (!p.contains(name)) {
+      continue;
+    }
+    if (parameter_schema[key].boolean) {
+      setValue(key, p.getBool(name) ? 1.0 : 0.0);
+    } else {
+      if (!superseded_turn_key(p,key)) {
+        setValue(key, p.getValue(name));
+      }
+      if (std::string(parameter_schema[key].units) != "unspecified") {
+        units_[key] = p.getUnit(name);
+      }
+    }
   }
   // Alertor
   alertor.setParameters(p);
 }
 
-std::string KinematicBandsParameters::getUnits(const std::string& key) const {
-  std::map<std::string,std::string>::const_iterator got = units_.find(key);
-  if (got == units_.end()) {
+std::string KinematicBandsParameters::getUnits(const std::string& name) const {
+  Key k = key(name);
+  if (k == KEYS) {
     return "unspecified";
   }
-  return got->second;
+  return units_[k];
+}
+
+const std::string& KinematicBandsParameters::getUnits(Key key) const {
+  return units_[key];
+}
+
+const std::string& KinematicBandsParameters::keyName(Key key) {
+  return key_names()[key];
+}
+
+KinematicBandsParameters::Key KinematicBandsParameters::key(const std::string& name) {
+  const std::vector<std::string>& names = key_names();
+  for (int key = 0; key < KEYS; ++key) {
+    if (names[key] == name) {
+      return (Key)key;
+    }
+  }
+  return KEYS;
+}
+
+double KinematicBandsParameters::getValue(Key key) const {
+  switch (key) {
+  case LOOKAHEAD_TIME: return lookahead_time_;
+  case LEFT_TRK: return left_trk_;
+  case RIGHT_TRK: return right_trk_;
+  case MIN_GS: return min_gs_;
+  case MAX_GS: return max_gs_;
+  case MIN_VS: return min_vs_;
+  case MAX_VS: return max_vs_;
+  case MIN_ALT: return min_alt_;
+  case MAX_ALT: return max_alt_;
+  case TRK_STEP: return trk_step_;
+  case GS_STEP: return gs_step_;
+  case VS_STEP: return vs_step_;
+  case ALT_STEP: return alt_step_;
+  case HORIZONTAL_ACCEL: return horizontal_accel_;
+  case VERTICAL_ACCEL: return vertical_accel_;
+  case TURN_RATE: return turn_rate_;
+  case BANK_ANGLE: return bank_angle_;
+  case VERTICAL_RATE: return vertical_rate_;
+  case RECOVERY_STABILITY_TIME: return recovery_stability_time_;
+  case MIN_HORIZONTAL_RECOVERY: return min_horizontal_recovery_;
+  case MIN_VERTICAL_RECOVERY: return min_vertical_recovery_;
+  case RECOVERY_TRK: return recovery_trk_ ? 1.0 : 0.0;
+  case RECOVERY_GS: return recovery_gs_ ? 1.0 : 0.0;
+  case RECOVERY_VS: return recovery_vs_ ? 1.0 : 0.0;
+  case RECOVERY_ALT: return recovery_alt_ ? 1.0 : 0.0;
+  case CA_BANDS: return ca_bands_ ? 1.0 : 0.0;
+  case CA_FACTOR: return ca_factor_;
+  case HORIZONTAL_NMAC: return horizontal_nmac_;
+  case VERTICAL_NMAC: return vertical_nmac_;
+  case CONFLICT_CRIT: return conflict_crit_ ? 1.0 : 0.0;
+  case RECOVERY_CRIT: return recovery_crit_ ? 1.0 : 0.0;
+  case CONTOUR_THR: return contour_thr_;
+  default: return NaN;
+  }
+}
+
+bool KinematicBandsParameters::setValue(Key key, double val) {
+  switch (key) {
+  case LOOKAHEAD_TIME: return setLookaheadTime(val);
+  case LEFT_TRK: return setLeftTrack(val);
+  case RIGHT_TRK: return setRightTrack(val);
+  case MIN_GS: return setMinGroundSpeed(val);
+  case MAX_GS: return setMaxGroundSpeed(val);
+  case MIN_VS: return setMinVerticalSpeed(val);
+  case MAX_VS: return setMaxVerticalSpeed(val);
+  case MIN_ALT: return setMinAltitude(val);
+  case MAX_ALT: return setMaxAltitude(val);
+  case TRK_STEP: return setTrackStep(val);
+  case GS_STEP: return setGroundSpeedStep(val);
+  case VS_STEP: return setVerticalSpeedStep(val);
+  case ALT_STEP: return setAltitudeStep(val);
+  case HORIZONTAL_ACCEL: return setHorizontalAcceleration(val);
+  case VERTICAL_ACCEL: return setVerticalAcceleration(val);
+  case TURN_RATE: return setTurnRate(val);
+  case BANK_ANGLE: return setBankAngle(val);
+  case VERTICAL_RATE: return setVerticalRate(val);
+  case RECOVERY_STABILITY_TIME: return setRecoveryStabilityTime(val);
+  case MIN_HORIZONTAL_RECOVERY: return setMinHorizontalRecovery(val);
+  case MIN_VERTICAL_RECOVERY: return setMinVerticalRecovery(val);
+  case RECOVERY_TRK: setRecoveryTrackBands(val != 0.0); return true;
+  case RECOVERY_GS: setRecoveryGroundSpeedBands(val != 0.0); return true;
+  case RECOVERY_VS: setRecoveryVerticalSpeedBands(val != 0.0); return true;
+  case RECOVERY_ALT: setRecoveryAltitudeBands(val != 0.0); return true;
+  case CA_BANDS: setCollisionAvoidanceBands(val != 0.0); return true;
+  case CA_FACTOR: return setCollisionAvoidanceBandsFactor(val);
+  case HORIZONTAL_NMAC: return setHorizontalNMAC(val);
+  case VERTICAL_NMAC: return setVerticalNMAC(val);
+  case CONFLICT_CRIT: setConflictCriteria(val != 0.0); return true;
+  case RECOVERY_CRIT: setRecoveryCriteria(val != 0.0); return true;
+  case CONTOUR_THR: return setHorizontalContourThreshold(val);
+  default: return false;
+  }
 }
 
 bool KinematicBandsParameters::hasError() const {
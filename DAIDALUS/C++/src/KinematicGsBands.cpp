@@ -53,10 +53,10 @@ double KinematicGsBands::time_step(const TrafficState& ownship) const {
   return get_step()/horizontal_accel_;
 }
 
-std::pair<Vect3, Velocity> KinematicGsBands::trajectory(const TrafficState& ownship, double time, bool dir) const {
+std::pair<Vect3, Velocity> KinematicGsBands::trajectory(const TrafficState& ownship, double time, bool dir, int j) const {
   std::pair<Position,Velocity> posvel;
   if (instantaneous_bands()) {
-    double gs = ownship.getVelocityXYZ().gs()+(dir?1:-1)*j_step_*get_step();
+    double gs = ownship.getVelocityXYZ().gs()+(dir?1:-1)*j*get_step();
     posvel = std::pair<Position,Velocity>(ownship.getPositionXYZ(),ownship.getVelocityXYZ().mkGs(gs));
   } else {
     posvel = ProjectedKinematics::gsAccel(ownship.getPositionXYZ(),ownship.getVelocityXYZ(),time,
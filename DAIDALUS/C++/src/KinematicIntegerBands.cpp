@@ -6,15 +6,24 @@
  */
 
 #include "KinematicIntegerBands.h"
+#include "DetectionKernel.h"
+#include "DetectionPrefilter.h"
+#include "BandsStats.h"
+#include "WCV_TAUMOD.h"
+#include "WCV_TCPA.h"
+#include "WCV_TEP.h"
+#include "CDCylinder.h"
+#include "TCAS3D.h"
 #include "CriteriaCore.h"
 #include "TCASTable.h"
 #include "Util.h"
+#include "ParallelLoop.h"
 #include <vector>
 #include <string>
 
 namespace larcfm {
 
-int KinematicIntegerBands::first_los_step(Detection3D* det, double tstep,bool trajdir,
+int KinematicIntegerBands::first_los_step(const Detection3D* det, double tstep,bool trajdir,
     int min, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic) const {
   for (int k=min; k<=max; ++k) {
     if (any_los_aircraft(det,trajdir,k*tstep,ownship,traffic)) {
@@ -24,7 +33,7 @@ int KinematicIntegerBands::first_los_step(Detection3D* det, double tstep,bool tr
   return -1;
 }
 
-int KinematicIntegerBands::first_los_search_index(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+int KinematicIntegerBands::first_los_search_index(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
     double B, double T, double B2, double T2, bool trajdir, int max,
     const TrafficState& ownship, const std::vector<TrafficState>& traffic) const {
   int FirstLosK = (int)std::ceil(B/tstep); // first k such that k*ts>=B
@@ -38,7 +47,7 @@ int KinematicIntegerBands::first_los_search_index(Detection3D* conflict_det, Det
   return Util::min(LosInitIndex,LosIndex);
 }
 
-int KinematicIntegerBands::bands_search_index(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+int KinematicIntegerBands::bands_search_index(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
     double B, double T, double B2, double T2,
     bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
     int epsh, int epsv) const {
@@ -55,15 +64,21 @@ int KinematicIntegerBands::bands_search_index(Detection3D* conflict_det, Detecti
   return Util::min(FirstProbHL,FirstProbVcrit);
 }
 
-bool KinematicIntegerBands::no_conflict(Detection3D* conflict_det, Detection3D* recovery_det, double B, double T, double B2, double T2,
+bool KinematicIntegerBands::no_conflict(const Detection3D* conflict_det, const Detection3D* recovery_det, double B, double T, double B2, double T2,
     bool trajdir, double tsk, const TrafficState& ownship, const std::vector<TrafficState>& traffic) const {
+  return no_conflict(conflict_det,recovery_det,B,T,B2,T2,trajdir,tsk,ownship,traffic,j_step_,stats_);
+}
+
+bool KinematicIntegerBands::no_conflict(const Detection3D* conflict_det, const Detection3D* recovery_det, double B, double T, double B2, double T2,
+    bool trajdir, double tsk, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
+    int j, BandsStats* stats) const {
   return
-      !any_conflict_aircraft(conflict_det,B,T,trajdir,tsk,ownship,traffic) &&
-      !(recovery_det != NULL && any_conflict_aircraft(recovery_det,B2,T2,trajdir,tsk,ownship,traffic));
+      !any_conflict_aircraft(conflict_det,B,T,trajdir,tsk,ownship,traffic,j,stats) &&
+      !(recovery_det != NULL && any_conflict_aircraft(recovery_det,B2,T2,trajdir,tsk,ownship,traffic,j,stats));
 }
 
 void KinematicIntegerBands::traj_conflict_only_bands(std::vector<Integerval>& l,
-    Detection3D* conflict_det, Detection3D* recovery_det, double tstep, double B, double T, double B2, double T2,
+    const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep, double B, double T, double B2, double T2,
     bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic) const {
   int d = -1; // Set to the first index with no conflict
   for (int k = 0; k <= max; ++k) {
@@ -82,7 +97,7 @@ void KinematicIntegerBands::traj_conflict_only_bands(std::vector<Integerval>& l,
   }
 }
 
-void KinematicIntegerBands::kinematic_bands(std::vector<Integerval>& l, Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+void KinematicIntegerBands::kinematic_bands(std::vector<Integerval>& l, const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
     double B, double T, double B2, double T2,
     bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
     int epsh, int epsv) const {
@@ -127,7 +142,7 @@ void KinematicIntegerBands::neg(std::vector<Integerval>& l) {
 
 // INTERFACE FUNCTION
 void KinematicIntegerBands::kinematic_bands_combine(std::vector<Integerval>& l,
-    Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+    const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
     double B, double T, double B2, double T2,
     int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
     int epsh, int epsv) const {
@@ -138,26 +153,50 @@ void KinematicIntegerBands::kinematic_bands_combine(std::vector<Integerval>& l,
   append_intband(l,r);
 }
 
-bool KinematicIntegerBands::any_los_aircraft(Detection3D* det, bool trajdir, double tsk,
-    const TrafficState& ownship, const std::vector<TrafficState>& traffic) const {
+template <class D>
+bool KinematicIntegerBands::any_los_kernel(const Detection3D* det, const Vect3& sot, const Velocity& vot, double tsk,
+    const std::vector<TrafficState>& traffic, BandsStats* stats) {
   for (TrafficState::nat i=0; i < traffic.size(); ++i) {
-    TrafficState ac = traffic[i];
-    std::pair<Vect3,Velocity> sovot = trajectory(ownship,tsk,trajdir);
-    Vect3 sot = sovot.first;
-    Velocity vot = sovot.second;
+    const TrafficState& ac = traffic[i];
     Vect3 si = ac.get_s();
     Velocity vi = ac.get_v();
     Vect3 sit = vi.ScalAdd(tsk,si);
-    if (det->violation(sot, vot, sit, vi))
+    BANDS_STATS_COUNT(stats,detector_calls,1);
+    if (DetectorCall<D>::violation(det, sot, vot, sit, vi))
       return true;
   }
   return false;
 }
 
+bool KinematicIntegerBands::any_los_aircraft(const Detection3D* det, bool trajdir, double tsk,
+    const TrafficState& ownship, const std::vector<TrafficState>& traffic) const {
+  if (traffic.empty()) {
+    return false;
+  }
+  // Ownship trajectory doesn't depend on the traffic aircraft
+  std::pair<Vect3,Velocity> sovot = sample_trajectory(ownship,tsk,trajdir);
+  Vect3 sot = sovot.first;
+  Velocity vot = sovot.second;
+  switch (DetectionKernel::kind(det)) {
+  case DetectionKernel::WCV_TAUMOD_KIND:
+    return any_los_kernel<WCV_TAUMOD>(det,sot,vot,tsk,traffic,stats_);
+  case DetectionKernel::WCV_TCPA_KIND:
+    return any_los_kernel<WCV_TCPA>(det,sot,vot,tsk,traffic,stats_);
+  case DetectionKernel::WCV_TEP_KIND:
+    return any_los_kernel<WCV_TEP>(det,sot,vot,tsk,traffic,stats_);
+  case DetectionKernel::CDCYLINDER_KIND:
+    return any_los_kernel<CDCylinder>(det,sot,vot,tsk,traffic,stats_);
+  case DetectionKernel::TCAS3D_KIND:
+    return any_los_kernel<TCAS3D>(det,sot,vot,tsk,traffic,stats_);
+  default:
+    return any_los_kernel<Detection3D>(det,sot,vot,tsk,traffic,stats_);
+  }
+}
+
 // INTERFACE FUNCTION
 
 // trajdir: false is left
-int KinematicIntegerBands::first_green(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+int KinematicIntegerBands::first_green(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
     double B, double T, double B2, double T2,
     bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
     int epsh, int epsv) const {
@@ -179,7 +218,7 @@ int KinematicIntegerBands::first_green(Detection3D* conflict_det, Detection3D* r
   return -1;
 }
 
-bool KinematicIntegerBands::all_int_red(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+bool KinematicIntegerBands::all_int_red(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
     double B, double T, double B2, double T2,
     int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
     int epsh, int epsv, int dir) const {
@@ -188,21 +227,20 @@ bool KinematicIntegerBands::all_int_red(Detection3D* conflict_det, Detection3D*
   return leftans && rightans;
 }
 
-int KinematicIntegerBands::first_instantaneous_green(Detection3D* conflict_det, Detection3D* recovery_det,
+int KinematicIntegerBands::first_instantaneous_green(const Detection3D* conflict_det, const Detection3D* recovery_det,
     double B, double T, double B2, double T2,
     bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
     const TrafficState& repac,
     int epsh, int epsv) {
   for (int k = 0; k <= max; ++k) {
-    j_step_ = k;
-    if (no_instantaneous_conflict(conflict_det,recovery_det,B,T,B2,T2,trajdir,ownship,traffic,repac,epsh,epsv)) {
+    if (no_instantaneous_conflict(conflict_det,recovery_det,B,T,B2,T2,trajdir,ownship,traffic,repac,epsh,epsv,k,stats_)) {
       return k;
     }
   }
   return -1;
 }
 
-bool KinematicIntegerBands::all_instantaneous_red(Detection3D* conflict_det, Detection3D* recovery_det,
+bool KinematicIntegerBands::all_instantaneous_red(const Detection3D* conflict_det, const Detection3D* recovery_det,
     double B, double T, double B2, double T2,
     int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
     const TrafficState& repac,
@@ -212,9 +250,19 @@ bool KinematicIntegerBands::all_instantaneous_red(Detection3D* conflict_det, Det
   return leftans && rightans;
 }
 
+std::pair<Vect3,Velocity> KinematicIntegerBands::sample_trajectory(const TrafficState& ownship, double time, bool dir) const {
+  return sample_trajectory(ownship,time,dir,j_step_,stats_);
+}
+
+std::pair<Vect3,Velocity> KinematicIntegerBands::sample_trajectory(const TrafficState& ownship, double time, bool dir, int j,
+    BandsStats* stats) const {
+  BANDS_STATS_COUNT(stats,trajectory_samples,1);
+  return trajectory(ownship,time,dir,j);
+}
+
 Vect3 KinematicIntegerBands::linvel(const TrafficState& ownship, double tstep, bool trajdir, int k) const {
-  Vect3 s1 = trajectory(ownship,(k+1)*tstep,trajdir).first;
-  Vect3 s0 = trajectory(ownship,k*tstep,trajdir).first;
+  Vect3 s1 = sample_trajectory(ownship,(k+1)*tstep,trajdir).first;
+  Vect3 s0 = sample_trajectory(ownship,k*tstep,trajdir).first;
   return s1.Sub(s0).Scal(1/tstep);
 }
 
@@ -223,7 +271,7 @@ bool KinematicIntegerBands::repulsive_at(double tstep, bool trajdir, int k, cons
   if (k==0) {
     return true;
   }
-  std::pair<Vect3,Velocity> sovo = trajectory(ownship,0,trajdir);
+  std::pair<Vect3,Velocity> sovo = sample_trajectory(ownship,0,trajdir);
   Vect3 so = sovo.first;
   Vect3 vo = sovo.second;
   Vect3 si = repac.get_s();
@@ -233,7 +281,7 @@ bool KinematicIntegerBands::repulsive_at(double tstep, bool trajdir, int k, cons
     rep = CriteriaCore::horizontal_new_repulsive_criterion(so.Sub(si),vo,vi,linvel(ownship,tstep,trajdir,0),epsh);
   }
   if (rep) {
-    std::pair<Vect3,Velocity> sovot = trajectory(ownship,k*tstep,trajdir);
+    std::pair<Vect3,Velocity> sovot = sample_trajectory(ownship,k*tstep,trajdir);
     Vect3 sot = sovot.first;
     Vect3 vot = sovot.second;
     Vect3 sit = vi.ScalAdd(k*tstep,si);
@@ -249,12 +297,7 @@ bool KinematicIntegerBands::repulsive_at(double tstep, bool trajdir, int k, cons
 
 int KinematicIntegerBands::first_nonrepulsive_step(double tstep, bool trajdir, int max,
     const TrafficState& ownship, const TrafficState& repac, int epsh) const {
-  for (int k=0; k <= max; ++k) {
-    if (!repulsive_at(tstep,trajdir,k,ownship,repac,epsh)) {
-      return k;
-    }
-  }
-  return -1;
+  return first_nonrepulsive_sweep(tstep,trajdir,max,ownship,repac,epsh,true);
 }
 
 bool KinematicIntegerBands::vert_repul_at(double tstep, bool trajdir, int k, const TrafficState& ownship,
@@ -263,7 +306,7 @@ bool KinematicIntegerBands::vert_repul_at(double tstep, bool trajdir, int k, con
   if (k==0) {
     return true;
   }
-  std::pair<Vect3,Velocity> sovo = trajectory(ownship,0,trajdir);
+  std::pair<Vect3,Velocity> sovo = sample_trajectory(ownship,0,trajdir);
   Vect3 so = sovo.first;
   Vect3 vo = sovo.second;
   Vect3 si = repac.get_s();
@@ -273,7 +316,7 @@ bool KinematicIntegerBands::vert_repul_at(double tstep, bool trajdir, int k, con
     rep = CriteriaCore::vertical_new_repulsive_criterion(so.Sub(si),vo,vi,linvel(ownship,tstep,trajdir,0),epsv);
   }
   if (rep) {
-    std::pair<Vect3,Velocity> sovot = trajectory(ownship,k*tstep,trajdir);
+    std::pair<Vect3,Velocity> sovot = sample_trajectory(ownship,k*tstep,trajdir);
     Vect3 sot = sovot.first;
     Vect3 vot = sovot.second;
     Vect3 sit = vi.ScalAdd(k*tstep,si);
@@ -289,50 +332,151 @@ bool KinematicIntegerBands::vert_repul_at(double tstep, bool trajdir, int k, con
 
 int KinematicIntegerBands::first_nonvert_repul_step(double tstep, bool trajdir, int max,
     const TrafficState& ownship, const TrafficState& repac, int epsv) const {
-  for (int k=0; k <= max; ++k) {
-    if (!vert_repul_at(tstep,trajdir,k,ownship,repac,epsv)) {
+  return first_nonrepulsive_sweep(tstep,trajdir,max,ownship,repac,epsv,false);
+}
+
+static bool new_repulsive_criterion(bool horizontal, const Vect3& s, const Vect3& vo, const Vect3& vi, const Vect3& nvo,
+    int eps) {
+  return horizontal ? CriteriaCore::horizontal_new_repulsive_criterion(s,vo,vi,nvo,eps) :
+      CriteriaCore::vertical_new_repulsive_criterion(s,vo,vi,nvo,eps);
+}
+
+int KinematicIntegerBands::first_nonrepulsive_sweep(double tstep, bool trajdir, int max,
+    const TrafficState& ownship, const TrafficState& repac, int eps, bool horizontal) const {
+  // Same as the first k <= max that isn't repulsive_at (horizontal) or vert_repul_at (vertical). The samples at
+  // steps k and k+1 and the linear velocity between k-1 and k are carried forward, so that each step samples the
+  // trajectory once.
+  if (max < 1) {
+    return -1;
+  }
+  Vect3 si = repac.get_s();
+  Vect3 vi = repac.get_v();
+  std::pair<Vect3,Velocity> sovot = sample_trajectory(ownship,0,trajdir);
+  std::pair<Vect3,Velocity> sovon = sample_trajectory(ownship,tstep,trajdir);
+  Vect3 vok = sovon.first.Sub(sovot.first).Scal(1/tstep);
+  if (!new_repulsive_criterion(horizontal,sovot.first.Sub(si),sovot.second,vi,vok,eps)) {
+    return 1;
+  }
+  for (int k=1; k <= max; ++k) {
+    Vect3 vop = vok;
+    sovot = sovon;
+    sovon = sample_trajectory(ownship,(k+1)*tstep,trajdir);
+    vok = sovon.first.Sub(sovot.first).Scal(1/tstep);
+    Vect3 sit = vi.ScalAdd(k*tstep,si);
+    Vect3 st = sovot.first.Sub(sit);
+    Vect3 vot = sovot.second;
+    if (!(new_repulsive_criterion(horizontal,st,vop,vi,vot,eps) &&
+        new_repulsive_criterion(horizontal,st,vot,vi,vok,eps) &&
+        new_repulsive_criterion(horizontal,st,vop,vi,vok,eps))) {
       return k;
     }
   }
   return -1;
 }
 
-bool KinematicIntegerBands::conflict(Detection3D* det, const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi,
+template <class D>
+bool KinematicIntegerBands::conflict(const Detection3D* det, const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi,
     double B, double T) {
   if (Util::almost_equals(B,T)) {
     Vect3 sot = vo.ScalAdd(B,so);
     Vect3 sit = vi.ScalAdd(B,si);
-    return det->violation(sot,vo,sit,vi);
+    return DetectorCall<D>::violation(det,sot,vo,sit,vi);
   }
-  return det->conflict(so,vo,si,vi,B,T);
+  return DetectorCall<D>::conflict(det,so,vo,si,vi,B,T);
 }
 
-bool KinematicIntegerBands::cd_future_traj(Detection3D* det, double B, double T, bool trajdir, double t,
-    const TrafficState& ownship, const TrafficState& ac) const {
-  if (t > T || B > T) return false;
-  std::pair<Vect3,Velocity> sovot = trajectory(ownship,t,trajdir);
-  Vect3 sot = sovot.first;
-  Velocity vot = sovot.second;
-  Vect3 si = ac.get_s();
-  Velocity vi = ac.get_v();
-  Vect3 sit = vi.ScalAdd(t,si);
-  if (B > t) {
-    return conflict(det, sot, vot, sit, vi, B-t, T-t);
+template <class D>
+bool KinematicIntegerBands::any_conflict_kernel(const Detection3D* det, double B, double T, const Vect3& sot, const Velocity& vot,
+    double t, const std::vector<TrafficState>& traffic, BandsStats* stats) {
+  DetectionPrefilter prefilter(det);
+  if (!prefilter.isActive()) {
+    for (TrafficState::nat i=0; i < traffic.size(); ++i) {
+      const TrafficState& ac = traffic[i];
+      Vect3 si = ac.get_s();
+      Velocity vi = ac.get_v();
+      Vect3 sit = vi.ScalAdd(t,si);
+      BANDS_STATS_COUNT(stats,detector_calls,1);
+      if (B > t ? conflict<D>(det, sot, vot, sit, vi, B-t, T-t) :
+          conflict<D>(det, sot, vot, sit, vi, 0, T-t)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  // Traffic aircraft are screened in blocks. Aircraft that are not screened out are checked
+  // with the exact detector in the original order.
+  const int L = DetectionPrefilter::LANES;
+  float sx[L], sy[L], sz[L], vx[L], vy[L], vz[L];
+  unsigned char clear[L];
+  float b = (float)(B > t ? B-t : 0);
+  float e = (float)(T-t);
+  if (e < b) {
+    e = b;
   }
-  return conflict(det, sot, vot, sit, vi, 0, T-t);
+  TrafficState::nat n = traffic.size();
+  for (TrafficState::nat i0=0; i0 < n; i0 += L) {
+    int m = n-i0 < (TrafficState::nat)L ? (int)(n-i0) : L;
+    for (int j=0; j < m; ++j) {
+      const TrafficState& ac = traffic[i0+j];
+      const Vect3& si = ac.get_s();
+      const Velocity& vi = ac.get_v();
+      sx[j] = (float)(sot.x-(si.x+t*vi.x));
+      sy[j] = (float)(sot.y-(si.y+t*vi.y));
+      sz[j] = (float)(sot.z-(si.z+t*vi.z));
+      vx[j] = (float)(vot.x-vi.x);
+      vy[j] = (float)(vot.y-vi.y);
+      vz[j] = (float)(vot.z-vi.z);
+    }
+    prefilter.screen(m,sx,sy,sz,vx,vy,vz,b,e,clear);
+    for (int j=0; j < m; ++j) {
+      if (clear[j]) {
+        continue;
+      }
+      const TrafficState& ac = traffic[i0+j];
+      Vect3 si = ac.get_s();
+      Velocity vi = ac.get_v();
+      Vect3 sit = vi.ScalAdd(t,si);
+      BANDS_STATS_COUNT(stats,detector_calls,1);
+      if (B > t ? conflict<D>(det, sot, vot, sit, vi, B-t, T-t) :
+          conflict<D>(det, sot, vot, sit, vi, 0, T-t)) {
+        return true;
+      }
+    }
+  }
+  return false;
 }
 
-bool KinematicIntegerBands::any_conflict_aircraft(Detection3D* det, double B, double T, bool trajdir, double tsk,
+bool KinematicIntegerBands::any_conflict_aircraft(const Detection3D* det, double B, double T, bool trajdir, double tsk,
     const TrafficState& ownship, const std::vector<TrafficState>& traffic) const {
-  for (TrafficState::nat i=0; i < traffic.size(); ++i) {
-    TrafficState ac = traffic[i];
-    if (cd_future_traj(det, B, T, trajdir, tsk, ownship, ac))
-      return true;
+  return any_conflict_aircraft(det,B,T,trajdir,tsk,ownship,traffic,j_step_,stats_);
+}
+
+bool KinematicIntegerBands::any_conflict_aircraft(const Detection3D* det, double B, double T, bool trajdir, double tsk,
+    const TrafficState& ownship, const std::vector<TrafficState>& traffic, int j, BandsStats* stats) const {
+  if (traffic.empty() || tsk > T || B > T) {
+    return false;
+  }
+  // Ownship trajectory doesn't depend on the traffic aircraft
+  std::pair<Vect3,Velocity> sovot = sample_trajectory(ownship,tsk,trajdir,j,stats);
+  Vect3 sot = sovot.first;
+  Velocity vot = sovot.second;
+  switch (DetectionKernel::kind(det)) {
+  case DetectionKernel::WCV_TAUMOD_KIND:
+    return any_conflict_kernel<WCV_TAUMOD>(det,B,T,sot,vot,tsk,traffic,stats);
+  case DetectionKernel::WCV_TCPA_KIND:
+    return any_conflict_kernel<WCV_TCPA>(det,B,T,sot,vot,tsk,traffic,stats);
+  case DetectionKernel::WCV_TEP_KIND:
+    return any_conflict_kernel<WCV_TEP>(det,B,T,sot,vot,tsk,traffic,stats);
+  case DetectionKernel::CDCYLINDER_KIND:
+    return any_conflict_kernel<CDCylinder>(det,B,T,sot,vot,tsk,traffic,stats);
+  case DetectionKernel::TCAS3D_KIND:
+    return any_conflict_kernel<TCAS3D>(det,B,T,sot,vot,tsk,traffic,stats);
+  default:
+    return any_conflict_kernel<Detection3D>(det,B,T,sot,vot,tsk,traffic,stats);
   }
-  return false;
 }
 
-bool KinematicIntegerBands::any_conflict_step(Detection3D* det, double tstep, double B, double T, bool trajdir, int max,
+bool KinematicIntegerBands::any_conflict_step(const Detection3D* det, double tstep, double B, double T, bool trajdir, int max,
     const TrafficState& ownship, const std::vector<TrafficState>& traffic) const {
   for (int k=0; k <= max; ++k) {
     if (any_conflict_aircraft(det,B,T,trajdir,tstep*k,ownship,traffic)) {
@@ -343,7 +487,7 @@ bool KinematicIntegerBands::any_conflict_step(Detection3D* det, double tstep, do
 }
 
 // trajdir: false is left
-bool KinematicIntegerBands::red_band_exist(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+bool KinematicIntegerBands::red_band_exist(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
     double B, double T, double B2, double T2,
     bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
     int epsh, int epsv) const {
@@ -355,14 +499,13 @@ bool KinematicIntegerBands::red_band_exist(Detection3D* conflict_det, Detection3
       (recovery_det != NULL && any_conflict_step(recovery_det,tstep,B2,T2,trajdir,max,ownship,traffic));
 }
 
-bool KinematicIntegerBands::instantaneous_red_band_exist(Detection3D* conflict_det, Detection3D* recovery_det,
+bool KinematicIntegerBands::instantaneous_red_band_exist(const Detection3D* conflict_det, const Detection3D* recovery_det,
     double B, double T, double B2, double T2,
     bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
     const TrafficState& repac,
     int epsh, int epsv) {
   for (int k = 0; k <= max; ++k) {
-    j_step_ = k;
-    if (!no_instantaneous_conflict(conflict_det,recovery_det,B,T,B2,T2,trajdir,ownship,traffic,repac,epsh,epsv)) {
+    if (!no_instantaneous_conflict(conflict_det,recovery_det,B,T,B2,T2,trajdir,ownship,traffic,repac,epsh,epsv,k,stats_)) {
       return true;
     }
   }
@@ -370,7 +513,7 @@ bool KinematicIntegerBands::instantaneous_red_band_exist(Detection3D* conflict_d
 }
 
 // INTERFACE FUNCTION
-bool KinematicIntegerBands::any_int_red(Detection3D* conflict_det, Detection3D* recovery_det, double tstep,
+bool KinematicIntegerBands::any_int_red(const Detection3D* conflict_det, const Detection3D* recovery_det, double tstep,
     double B, double T, double B2, double T2,
     int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic, const TrafficState& repac,
     int epsh, int epsv, int dir) const {
@@ -379,7 +522,7 @@ bool KinematicIntegerBands::any_int_red(Detection3D* conflict_det, Detection3D*
   return leftred || rightred;
 }
 
-bool KinematicIntegerBands::any_instantaneous_red(Detection3D* conflict_det, Detection3D* recovery_det,
+bool KinematicIntegerBands::any_instantaneous_red(const Detection3D* conflict_det, const Detection3D* recovery_det,
     double B, double T, double B2, double T2,
     int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
     const TrafficState& repac,
@@ -389,26 +532,79 @@ bool KinematicIntegerBands::any_instantaneous_red(Detection3D* conflict_det, Det
   return leftred || rightred;
 }
 
-void KinematicIntegerBands::instantaneous_bands_combine(std::vector<Integerval>& l, Detection3D* conflict_det, Detection3D* recovery_det,
+/*
+ * Evaluates instantaneous candidates. Index i < nl is candidate i to the left, otherwise candidate
+ * i-nl to the right. Each chunk counts in its own statistics.
+ */
+class InstantaneousBandsBody : public ParallelLoop::Body {
+public:
+  const KinematicIntegerBands& bands;
+  const Detection3D* conflict_det;
+  const Detection3D* recovery_det;
+  double B, T, B2, T2;
+  int nl;
+  int n;
+  const TrafficState& ownship;
+  const std::vector<TrafficState>& traffic;
+  const TrafficState& repac;
+  int epsh, epsv;
+  int chunks;
+  std::vector<char>& green;
+  std::vector<BandsStats>& stats;
+
+  InstantaneousBandsBody(const KinematicIntegerBands& b, const Detection3D* cd, const Detection3D* rd,
+      double B_, double T_, double B2_, double T2_, int nl_, int n_,
+      const TrafficState& own, const std::vector<TrafficState>& ac, const TrafficState& rep,
+      int eh, int ev, int c, std::vector<char>& g, std::vector<BandsStats>& st) :
+        bands(b), conflict_det(cd), recovery_det(rd), B(B_), T(T_), B2(B2_), T2(T2_), nl(nl_), n(n_),
+        ownship(own), traffic(ac), repac(rep), epsh(eh), epsv(ev), chunks(c), green(g), stats(st) {}
+
+  void run(int begin, int end) {
+    for (int c = begin; c < end; ++c) {
+      BandsStats* chunk_stats = stats.empty() ? NULL : &stats[c];
+      int last = (int)((long long)n*(c+1)/chunks);
+      for (int i = (int)((long long)n*c/chunks); i < last; ++i) {
+        bool trajdir = i >= nl;
+        green[i] = bands.no_instantaneous_conflict(conflict_det,recovery_det,B,T,B2,T2,trajdir,ownship,traffic,
+            repac,epsh,epsv,trajdir ? i-nl : i,chunk_stats);
+      }
+    }
+  }
+};
+
+void KinematicIntegerBands::instantaneous_bands_combine(std::vector<Integerval>& l, const Detection3D* conflict_det, const Detection3D* recovery_det,
     double B, double T, double B2, double T2,
     int maxl, int maxr, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
     const TrafficState& repac,
     int epsh, int epsv) {
-  instantaneous_bands(l,conflict_det,recovery_det,B,T,B2,T2,false,maxl,ownship,traffic,repac,epsh,epsv);
+  // Candidates are independent of each other: evaluate left and right candidates concurrently
+  // and then collect the conflict free ones into intervals
+  int nl = Util::max(maxl+1,0);
+  int n = nl+Util::max(maxr+1,0);
+  std::vector<char> green(n,0);
+  int chunks = Util::max(1,Util::min(ParallelLoop::concurrency(),n/16));
+  std::vector<BandsStats> stats(stats_ != NULL ? chunks : 0);
+  InstantaneousBandsBody body(*this,conflict_det,recovery_det,B,T,B2,T2,nl,n,ownship,traffic,repac,epsh,epsv,
+      chunks,green,stats);
+  ParallelLoop::run(chunks,body);
+  for (TrafficState::nat c = 0; c < stats.size(); ++c) {
+    stats_->add(stats[c]);
+  }
+  instantaneous_bands(l,green,0,maxl);
   std::vector<Integerval> r = std::vector<Integerval>();
-  instantaneous_bands(r,conflict_det,recovery_det,B,T,B2,T2,true,maxr,ownship,traffic,repac,epsh,epsv);
+  instantaneous_bands(r,green,nl,maxr);
   neg(l);
   append_intband(l,r);
 }
 
-bool KinematicIntegerBands::no_instantaneous_conflict(Detection3D* conflict_det, Detection3D* recovery_det,
+bool KinematicIntegerBands::no_instantaneous_conflict(const Detection3D* conflict_det, const Detection3D* recovery_det,
     double B, double T, double B2, double T2,
     bool trajdir, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
     const TrafficState& repac,
-    int epsh, int epsv) {
+    int epsh, int epsv, int j, BandsStats* stats) const {
   bool usehcrit = repac.isValid() && epsh != 0;
   bool usevcrit = repac.isValid() && epsv != 0;
-  std::pair<Vect3,Velocity> nsovo = trajectory(ownship,0,trajdir);
+  std::pair<Vect3,Velocity> nsovo = sample_trajectory(ownship,0,trajdir,j,stats);
   Vect3 so = ownship.get_s();
   Vect3 vo = ownship.get_v();
   Vect3 si = repac.get_s();
@@ -418,23 +614,18 @@ bool KinematicIntegerBands::no_instantaneous_conflict(Detection3D* conflict_det,
   return
       (!usehcrit || CriteriaCore::horizontal_new_repulsive_criterion(s,vo,vi,nvo,epsh)) &&
       (!usevcrit || CriteriaCore::vertical_new_repulsive_criterion(s,vo,vi,nvo,epsv)) &&
-      no_conflict(conflict_det,recovery_det,B,T,B2,T2,trajdir,0,ownship,traffic);
+      no_conflict(conflict_det,recovery_det,B,T,B2,T2,trajdir,0,ownship,traffic,j,stats);
 }
 
-void KinematicIntegerBands::instantaneous_bands(std::vector<Integerval>& l, Detection3D* conflict_det, Detection3D* recovery_det,
-    double B, double T, double B2, double T2,
-    bool trajdir, int max, const TrafficState& ownship, const std::vector<TrafficState>& traffic,
-    const TrafficState& repac,
-    int epsh, int epsv) {
+void KinematicIntegerBands::instantaneous_bands(std::vector<Integerval>& l, const std::vector<char>& green, int first, int max) {
   int d = -1; // Set to the first index with no conflict
   for (int k = 0; k <= max; ++k) {
-    j_step_ = k;
-    if (d >=0 && no_instantaneous_conflict(conflict_det,recovery_det,B,T,B2,T2,trajdir,ownship,traffic,repac,epsh,epsv)) {
+    if (d >=0 && green[first+k]) {
       continue;
     } else if (d >=0) {
       l.push_back(Integerval(d,k-1));
       d = -1;
-    } else if (no_instantaneous_conflict(conflict_det,recovery_det,B,T,B2,T2,trajdir,ownship,traffic,repac,epsh,epsv)) {
+    } else if (green[first+k]) {
       d = k;
     }
   }
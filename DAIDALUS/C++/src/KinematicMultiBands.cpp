@@ -16,6 +16,7 @@
 #include "format.h"
 #include "CriteriaCore.h"
 #include "Constants.h"
+#include "ParallelLoop.h"
 
 namespace larcfm {
 
@@ -27,7 +28,11 @@ KinematicMultiBands::KinematicMultiBands(const KinematicBandsParameters& paramet
     trk_band_(KinematicTrkBands(parameters)),
     gs_band_(KinematicGsBands(parameters)),
     vs_band_(KinematicVsBands(parameters)),
-    alt_band_(KinematicAltBands(parameters)) {}
+    alt_band_(KinematicAltBands(parameters)),
+    spread_trk_band_(KinematicTrkBands(parameters)),
+    spread_gs_band_(KinematicGsBands(parameters)),
+    spread_vs_band_(KinematicVsBands(parameters)),
+    spread_alt_band_(KinematicAltBands(parameters)) {}
 
 /**
  * Construct a KinematicMultiBands object with the default parameters and an empty list of detectors.
@@ -37,7 +42,11 @@ KinematicMultiBands::KinematicMultiBands() : error("KinematicMultiBands"),
     trk_band_(KinematicTrkBands(core_.parameters)),
     gs_band_(KinematicGsBands(core_.parameters)),
     vs_band_(KinematicVsBands(core_.parameters)),
-    alt_band_(KinematicAltBands(core_.parameters)) {}
+    alt_band_(KinematicAltBands(core_.parameters)),
+    spread_trk_band_(KinematicTrkBands(core_.parameters)),
+    spread_gs_band_(KinematicGsBands(core_.parameters)),
+    spread_vs_band_(KinematicVsBands(core_.parameters)),
+    spread_alt_band_(KinematicAltBands(core_.parameters)) {}
 
 /**
  * Construct a KinematicMultiBands object from an existing KinematicMultiBands object.
@@ -48,7 +57,11 @@ KinematicMultiBands::KinematicMultiBands(const KinematicMultiBands& b) : error("
     trk_band_(KinematicTrkBands(b.core_.parameters)),
     gs_band_(KinematicGsBands(b.core_.parameters)),
     vs_band_(KinematicVsBands(b.core_.parameters)),
-    alt_band_(KinematicAltBands(b.core_.parameters)) {}
+    alt_band_(KinematicAltBands(b.core_.parameters)),
+    spread_trk_band_(KinematicTrkBands(b.core_.parameters)),
+    spread_gs_band_(KinematicGsBands(b.core_.parameters)),
+    spread_vs_band_(KinematicVsBands(b.core_.parameters)),
+    spread_alt_band_(KinematicAltBands(b.core_.parameters)) {}
 
 KinematicMultiBands::~KinematicMultiBands() {}
 
@@ -58,6 +71,10 @@ KinematicMultiBands& KinematicMultiBands::operator=(const KinematicMultiBands& b
   gs_band_ = KinematicGsBands(b.core_.parameters);
   vs_band_ = KinematicVsBands(b.core_.parameters);
   alt_band_ = KinematicAltBands(b.core_.parameters);
+  spread_trk_band_ = KinematicTrkBands(b.core_.parameters);
+  spread_gs_band_ = KinematicGsBands(b.core_.parameters);
+  spread_vs_band_ = KinematicVsBands(b.core_.parameters);
+  spread_alt_band_ = KinematicAltBands(b.core_.parameters);
   reset();
   return *this;
 }
@@ -1316,12 +1333,24 @@ void KinematicMultiBands::clear() {
   reset();
 }
 
+BandsStats const & KinematicMultiBands::getStats() const {
+  return core_.stats;
+}
+
+void KinematicMultiBands::clearStats() {
+  core_.stats.clear();
+}
+
 void KinematicMultiBands::reset() {
   core_.reset();
   trk_band_.reset();
   gs_band_.reset();
   vs_band_.reset();
   alt_band_.reset();
+  spread_trk_band_.reset();
+  spread_gs_band_.reset();
+  spread_vs_band_.reset();
+  spread_alt_band_.reset();
 }
 
 /** Main interface methods **/
@@ -1342,6 +1371,168 @@ Interval const & KinematicMultiBands::timeIntervalOfViolation(int alert_level) {
   return core_.timeIntervalOfViolation(alert_level);
 }
 
+bool KinematicMultiBands::recovery_may_apply(bool recovery) {
+  // Recovery bands are only computed when there are conflict aircraft at the conflict level.
+  int conflict_level = core_.parameters.alertor.conflictAlertLevel();
+  return recovery && conflict_level >= 1 && !core_.conflictAircraft(conflict_level).empty();
+}
+
+BandsRegion::Region KinematicMultiBands::region_of_conflict_aircraft() {
+  // Stop at the first level, from most severe, with conflict aircraft
+  for (int alert_level = core_.parameters.alertor.mostSevereAlertLevel(); alert_level >= 1; --alert_level) {
+    BandsRegion::Region region = core_.parameters.alertor.getLevel(alert_level).getRegion();
+    if (BandsRegion::isConflictBand(region) && !core_.conflictAircraft(alert_level).empty()) {
+      return region;
+    }
+  }
+  return BandsRegion::NONE;
+}
+
+/**
+ * Return region of the current track of the ownship. This region is computed without computing bands,
+ * except when track recovery bands may change the regions, in which case track bands are computed.
+ */
+BandsRegion::Region KinematicMultiBands::regionOfCurrentTrajectory() {
+  if (!hasOwnship()) {
+    return BandsRegion::UNKNOWN;
+  }
+  if (recovery_may_apply(trk_band_.get_recovery())) {
+    return regionOfTrack(core_.ownship.track());
+  }
+  return region_of_conflict_aircraft();
+}
+
+/**
+ * Return region of the current ground speed of the ownship, see regionOfCurrentTrajectory
+ */
+BandsRegion::Region KinematicMultiBands::regionOfCurrentGroundSpeed() {
+  if (!hasOwnship()) {
+    return BandsRegion::UNKNOWN;
+  }
+  if (recovery_may_apply(gs_band_.get_recovery())) {
+    return regionOfGroundSpeed(core_.ownship.groundSpeed());
+  }
+  return region_of_conflict_aircraft();
+}
+
+/**
+ * Return region of the current vertical speed of the ownship, see regionOfCurrentTrajectory
+ */
+BandsRegion::Region KinematicMultiBands::regionOfCurrentVerticalSpeed() {
+  if (!hasOwnship()) {
+    return BandsRegion::UNKNOWN;
+  }
+  if (recovery_may_apply(vs_band_.get_recovery())) {
+    return regionOfVerticalSpeed(core_.ownship.verticalSpeed());
+  }
+  return region_of_conflict_aircraft();
+}
+
+/**
+ * Return region of the current altitude of the ownship, see regionOfCurrentTrajectory
+ */
+BandsRegion::Region KinematicMultiBands::regionOfCurrentAltitude() {
+  if (!hasOwnship()) {
+    return BandsRegion::UNKNOWN;
+  }
+  if (recovery_may_apply(alt_band_.get_recovery())) {
+    return regionOfAltitude(core_.ownship.altitude());
+  }
+  return region_of_conflict_aircraft();
+}
+
+/*
+ * Regions of ownship velocity candidates, see regionsOfVelocity
+ */
+class VelocityRegionsBody : public ParallelLoop::Body {
+public:
+  KinematicBandsCore& core;
+  const std::vector<Velocity>& vels;
+  std::vector<BandsRegion::Region>& regions;
+
+  VelocityRegionsBody(KinematicBandsCore& c, const std::vector<Velocity>& vs, std::vector<BandsRegion::Region>& rs) :
+    core(c), vels(vs), regions(rs) {}
+
+  void run(int begin, int end) {
+    const TrafficState& own = core.ownship;
+    double T = core.parameters.getLookaheadTime();
+    for (int i = begin; i < end; ++i) {
+      Velocity vo = own.vel_to_v(own.getPosition(),vels[i]);
+      regions[i] = BandsRegion::NONE;
+      for (int alert_level = core.parameters.alertor.mostSevereAlertLevel(); alert_level >= 1; --alert_level) {
+        const AlertThresholds& athr = core.parameters.alertor.getLevel(alert_level);
+        if (!BandsRegion::isConflictBand(athr.getRegion())) {
+          continue;
+        }
+        const Detection3D* detector = athr.getDetectorRef();
+        double alerting_time = Util::min(T,athr.getAlertingTime());
+        bool conflict = false;
+        // Same conflict condition as for conflict aircraft in KinematicBandsCore
+        for (TrafficState::nat ac = 0; ac < core.traffic.size() && !conflict; ++ac) {
+          const TrafficState& intruder = core.traffic[ac];
+          ConflictData det = detector->conflictDetection(own.get_s(),vo,intruder.get_s(),intruder.get_v(),0,T);
+          conflict = detector->violation(own.get_s(),vo,intruder.get_s(),intruder.get_v()) ||
+              (det.conflict() && det.getTimeIn() < alerting_time);
+        }
+        if (conflict) {
+          regions[i] = athr.getRegion();
+          break;
+        }
+      }
+    }
+  }
+};
+
+void KinematicMultiBands::regionsOfVelocity(const std::vector<Velocity>& vels, std::vector<BandsRegion::Region>& regions) {
+  regions.assign(vels.size(),BandsRegion::UNKNOWN);
+  if (!hasOwnship()) {
+    return;
+  }
+  VelocityRegionsBody body(core_,vels,regions);
+  ParallelLoop::run(vels.size(),body,16);
+}
+
+/**
+ * Compute track, ground speed, vertical speed, and altitude bands within a time budget, in seconds.
+ * Return true if the bands of all dimensions are final.
+ */
+bool KinematicMultiBands::computeBandsWithin(double budget) {
+  BandsDeadline deadline(budget);
+  KinematicRealBands* bands[4] = { &trk_band_, &gs_band_, &vs_band_, &alt_band_ };
+  for (int stage = KinematicRealBands::COARSE_STAGE; stage <= KinematicRealBands::FINAL_STAGE; ++stage) {
+    for (int i = 0; i < 4; ++i) {
+      if (stage > KinematicRealBands::COARSE_STAGE && deadline.expired()) {
+        return false;
+      }
+      bands[i]->compute_stage(core_,stage,deadline);
+    }
+  }
+  return isFinalTrackBands() && isFinalGroundSpeedBands() && isFinalVerticalSpeedBands() && isFinalAltitudeBands();
+}
+
+/**
+ * Compute bands within a time budget specified in given units. See computeBandsWithin(double).
+ */
+bool KinematicMultiBands::computeBandsWithin(double budget, const std::string& u) {
+  return computeBandsWithin(Units::from(u,budget));
+}
+
+bool KinematicMultiBands::isFinalTrackBands() const {
+  return trk_band_.is_final();
+}
+
+bool KinematicMultiBands::isFinalGroundSpeedBands() const {
+  return gs_band_.is_final();
+}
+
+bool KinematicMultiBands::isFinalVerticalSpeedBands() const {
+  return vs_band_.is_final();
+}
+
+bool KinematicMultiBands::isFinalAltitudeBands() const {
+  return alt_band_.is_final();
+}
+
 /**
  * @return the number of track band intervals, negative if the ownship has not been KinematicMultiBands::set
  */
@@ -1420,6 +1611,14 @@ BandsRegion::Region KinematicMultiBands::regionOfTrack(double trk, const std::st
   return trackRegion(trackRangeOf(trk,u));
 }
 
+/**
+ * Set regions[i] to the region of track trks[i], specified in internal units [rad], for every
+ * value in trks.
+ */
+void KinematicMultiBands::regionsOfTrack(const std::vector<double>& trks, std::vector<BandsRegion::Region>& regions) {
+  trk_band_.regionsOf(core_,trks,regions);
+}
+
 /**
  * Return last time to track maneuver, in seconds, for ownship with respect to traffic
  * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -1591,6 +1790,14 @@ BandsRegion::Region KinematicMultiBands::regionOfGroundSpeed(double gs, const st
   return groundSpeedRegion(groundSpeedRangeOf(gs,u));
 }
 
+/**
+ * Set regions[i] to the region of ground speed gss[i], specified in internal units [m/s], for every
+ * value in gss.
+ */
+void KinematicMultiBands::regionsOfGroundSpeed(const std::vector<double>& gss, std::vector<BandsRegion::Region>& regions) {
+  gs_band_.regionsOf(core_,gss,regions);
+}
+
 /**
  * Return last time to ground speed maneuver, in seconds, for ownship with respect to traffic
  * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -1762,6 +1969,14 @@ BandsRegion::Region KinematicMultiBands::regionOfVerticalSpeed(double vs, const
   return verticalSpeedRegion(verticalSpeedRangeOf(vs,u));
 }
 
+/**
+ * Set regions[i] to the region of vertical speed vss[i], specified in internal units [m/s], for every
+ * value in vss.
+ */
+void KinematicMultiBands::regionsOfVerticalSpeed(const std::vector<double>& vss, std::vector<BandsRegion::Region>& regions) {
+  vs_band_.regionsOf(core_,vss,regions);
+}
+
 /**
  * Return last time to vertical speed maneuver, in seconds, for ownship with respect to traffic
  * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -1933,6 +2148,14 @@ BandsRegion::Region KinematicMultiBands::regionOfAltitude(double alt, const std:
   return altitudeRegion(altitudeRangeOf(alt,u));
 }
 
+/**
+ * Set regions[i] to the region of altitude alts[i], specified in internal units [m], for every
+ * value in alts.
+ */
+void KinematicMultiBands::regionsOfAltitude(const std::vector<double>& alts, std::vector<BandsRegion::Region>& regions) {
+  alt_band_.regionsOf(core_,alts,regions);
+}
+
 /**
  * Return last time to altitude maneuver, in seconds, for ownship with respect to traffic
  * aircraft ac. Return NaN if the ownship is not in conflict with aircraft ac within
@@ -2036,9 +2259,10 @@ bool KinematicMultiBands::check_thresholds(const AlertThresholds& athr,
     Velocity vo = core_.ownship.get_v();
     Vect3 si = ac.get_s();
     Velocity vi = ac.get_v();
-    Detection3D* detector = athr.getDetectorRef();
+    const Detection3D* detector = athr.getDetectorRef();
     double alerting_time = Util::min(core_.parameters.getLookaheadTime(),athr.getAlertingTime());
 
+    BANDS_STATS_COUNT(&core_.stats,detector_calls,2);
     if (detector->violation(so,vo,si,vi)) {
       return true;
     }
@@ -2046,43 +2270,68 @@ bool KinematicMultiBands::check_thresholds(const AlertThresholds& athr,
     if (det.conflict()) {
       return true;
     }
-    if (athr.getTrackSpread() > 0 || athr.getGroundSpeedSpread() > 0 ||
-        athr.getVerticalSpeedSpread() > 0 || athr.getAltitudeSpread() > 0) {
-      if (athr.getTrackSpread() > 0) {
-        KinematicTrkBands trk_band = KinematicTrkBands(core_.parameters);
-        trk_band.set_rel(true);
-        trk_band.set_min(turning <= 0 ? -athr.getTrackSpread() : 0);
-        trk_band.set_max(turning >= 0 ? athr.getTrackSpread() : 0);
-        if (trk_band.kinematic_conflict(core_,ac,detector,alerting_time)) {
-          return true;
-        }
+    return check_spreads(athr,ac,alerting_time,turning,accelerating,climbing);
+  }
+  return false;
+}
+
+void KinematicMultiBands::update_spread_bands() {
+  spread_trk_band_.set_step(core_.parameters.getTrackStep());
+  spread_trk_band_.set_turn_rate(core_.parameters.getTurnRate());
+  spread_trk_band_.set_bank_angle(core_.parameters.getBankAngle());
+  spread_trk_band_.set_recovery(core_.parameters.isEnabledRecoveryTrackBands());
+  spread_trk_band_.set_rel(true);
+
+  spread_gs_band_.set_step(core_.parameters.getGroundSpeedStep());
+  spread_gs_band_.set_horizontal_accel(core_.parameters.getHorizontalAcceleration());
+  spread_gs_band_.set_recovery(core_.parameters.isEnabledRecoveryGroundSpeedBands());
+  spread_gs_band_.set_rel(true);
+
+  spread_vs_band_.set_step(core_.parameters.getVerticalSpeedStep());
+  spread_vs_band_.set_vertical_accel(core_.parameters.getVerticalAcceleration());
+  spread_vs_band_.set_recovery(core_.parameters.isEnabledRecoveryVerticalSpeedBands());
+  spread_vs_band_.set_rel(true);
+
+  spread_alt_band_.set_step(core_.parameters.getAltitudeStep());
+  spread_alt_band_.set_vertical_rate(core_.parameters.getVerticalRate());
+  spread_alt_band_.set_vertical_accel(core_.parameters.getVerticalAcceleration());
+  spread_alt_band_.set_recovery(core_.parameters.isEnabledRecoveryAltitudeBands());
+  spread_alt_band_.set_rel(true);
+}
+
+bool KinematicMultiBands::check_spreads(const AlertThresholds& athr, const TrafficState& ac, double alerting_time,
+    int turning, int accelerating, int climbing) {
+  const Detection3D* detector = athr.getDetectorRef();
+  if (athr.getTrackSpread() > 0 || athr.getGroundSpeedSpread() > 0 ||
+      athr.getVerticalSpeedSpread() > 0 || athr.getAltitudeSpread() > 0) {
+    // Spread bands are configured by update_spread_bands. Setting the spreads of this level only resets
+    // the bands whose spreads are different from the ones of the previous check.
+    if (athr.getTrackSpread() > 0) {
+      spread_trk_band_.set_min(turning <= 0 ? -athr.getTrackSpread() : 0);
+      spread_trk_band_.set_max(turning >= 0 ? athr.getTrackSpread() : 0);
+      if (spread_trk_band_.kinematic_conflict(core_,ac,detector,alerting_time)) {
+        return true;
       }
-      if (athr.getGroundSpeedSpread() > 0) {
-        KinematicGsBands gs_band = KinematicGsBands(core_.parameters);
-        gs_band.set_rel(true);
-        gs_band.set_min(accelerating <= 0 ? -athr.getGroundSpeedSpread() : 0);
-        gs_band.set_max(accelerating >= 0 ? athr.getGroundSpeedSpread() : 0);
-        if (gs_band.kinematic_conflict(core_,ac,detector,alerting_time)) {
-          return true;
-        }
+    }
+    if (athr.getGroundSpeedSpread() > 0) {
+      spread_gs_band_.set_min(accelerating <= 0 ? -athr.getGroundSpeedSpread() : 0);
+      spread_gs_band_.set_max(accelerating >= 0 ? athr.getGroundSpeedSpread() : 0);
+      if (spread_gs_band_.kinematic_conflict(core_,ac,detector,alerting_time)) {
+        return true;
       }
-      if (athr.getVerticalSpeedSpread() > 0) {
-        KinematicVsBands vs_band = KinematicVsBands(core_.parameters);
-        vs_band.set_rel(true);
-        vs_band.set_min(climbing <= 0 ? -athr.getVerticalSpeedSpread() : 0);
-        vs_band.set_max(climbing >= 0 ? athr.getVerticalSpeedSpread() : 0);
-        if (vs_band.kinematic_conflict(core_,ac,detector,alerting_time)) {
-          return true;
-        }
+    }
+    if (athr.getVerticalSpeedSpread() > 0) {
+      spread_vs_band_.set_min(climbing <= 0 ? -athr.getVerticalSpeedSpread() : 0);
+      spread_vs_band_.set_max(climbing >= 0 ? athr.getVerticalSpeedSpread() : 0);
+      if (spread_vs_band_.kinematic_conflict(core_,ac,detector,alerting_time)) {
+        return true;
       }
-      if (athr.getAltitudeSpread() > 0) {
-        KinematicAltBands alt_band = KinematicAltBands(core_.parameters);
-        alt_band.set_rel(true);
-        alt_band.set_min(climbing <= 0 ? -athr.getAltitudeSpread() : 0);
-        alt_band.set_max(climbing >= 0 ? athr.getAltitudeSpread() : 0);
-        if (alt_band.kinematic_conflict(core_,ac,detector,alerting_time)) {
-          return true;
-        }
+    }
+    if (athr.getAltitudeSpread() > 0) {
+      spread_alt_band_.set_min(climbing <= 0 ? -athr.getAltitudeSpread() : 0);
+      spread_alt_band_.set_max(climbing >= 0 ? athr.getAltitudeSpread() : 0);
+      if (spread_alt_band_.kinematic_conflict(core_,ac,detector,alerting_time)) {
+        return true;
       }
     }
   }
@@ -2103,8 +2352,30 @@ bool KinematicMultiBands::check_thresholds(const AlertThresholds& athr,
  * do not make any climbing assumption about the ownship.
  */
 int KinematicMultiBands::alerting(const TrafficState& ac, int turning, int accelerating, int climbing) {
+  update_spread_bands();
+  std::vector<const WCV_TAUMOD*> dets;
+  if (core_.fusedLevelDetectors(dets)) {
+    std::vector<double> alerting_time;
+    for (int alert_level=1; alert_level <= (int) dets.size(); ++alert_level) {
+      alerting_time.push_back(Util::min(core_.parameters.getLookaheadTime(),
+          core_.parameters.alertor.getLevel(alert_level).getAlertingTime()));
+    }
+    std::vector<ConflictData> conflicts;
+    std::vector<bool> violations;
+    BANDS_STATS_COUNT(&core_.stats,detector_calls,1);
+    WCV_TAUMOD::conflictDetectionLevels(dets,core_.ownship.get_s(),core_.ownship.get_v(),ac.get_s(),ac.get_v(),
+        0,alerting_time,conflicts,violations);
+    for (int alert_level=(int) dets.size(); alert_level > 0; --alert_level) {
+      if (violations[alert_level-1] || conflicts[alert_level-1].conflict() ||
+          check_spreads(core_.parameters.alertor.getLevel(alert_level),ac,alerting_time[alert_level-1],
+              turning,accelerating,climbing)) {
+        return alert_level;
+      }
+    }
+    return 0;
+  }
   for (int alert_level=core_.parameters.alertor.mostSevereAlertLevel(); alert_level > 0; --alert_level) {
-    AlertThresholds athr = core_.parameters.alertor.getLevel(alert_level);
+    const AlertThresholds& athr = core_.parameters.alertor.getLevel(alert_level);
     if (check_thresholds(athr,ac,turning,accelerating,climbing)) {
       return alert_level;
     }
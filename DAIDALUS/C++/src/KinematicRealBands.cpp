@@ -12,6 +12,7 @@
 #include "CDCylinder.h"
 #include "format.h"
 #include "ColoredValue.h"
+#include "TurnSampler.h"
 
 namespace larcfm {
 
@@ -21,9 +22,16 @@ KinematicRealBands::KinematicRealBands() {
   outdated_ = true;
   checked_ = -1;
   peripheral_acs_ = std::vector< std::vector<TrafficState> >();
+  peripheral_outdated_ = std::vector<bool>();
   ranges_ = std::vector<BandsRange>();
   recovery_time_ = NaN;
   resolutions_ = std::vector<Interval>();
+  none_sets_ = std::vector<IntervalSet>();
+  regions_ = std::vector<BandsRegion::Region>();
+  stage_ = 0;
+  conflict_none_set_ = IntervalSet();
+  deadline_ = NULL;
+  interrupted_ = false;
   min_ = 0;
   max_ = 0;
   rel_ = false;
@@ -37,9 +45,16 @@ KinematicRealBands::KinematicRealBands(double min, double max, bool rel, double
   outdated_ = true;
   checked_ = -1;
   peripheral_acs_ = std::vector< std::vector<TrafficState> >();
+  peripheral_outdated_ = std::vector<bool>();
   ranges_ = std::vector<BandsRange>();
   recovery_time_ = NaN;
   resolutions_ = std::vector<Interval>();
+  none_sets_ = std::vector<IntervalSet>();
+  regions_ = std::vector<BandsRegion::Region>();
+  stage_ = 0;
+  conflict_none_set_ = IntervalSet();
+  deadline_ = NULL;
+  interrupted_ = false;
   min_ = min;
   max_ = max;
   rel_ = rel;
@@ -53,9 +68,16 @@ KinematicRealBands::KinematicRealBands(double min, double max, double step, bool
   outdated_ = true;
   checked_ = -1;
   peripheral_acs_ = std::vector< std::vector<TrafficState> >();
+  peripheral_outdated_ = std::vector<bool>();
   ranges_ = std::vector<BandsRange>();
   recovery_time_ = NaN;
   resolutions_ = std::vector<Interval>();
+  none_sets_ = std::vector<IntervalSet>();
+  regions_ = std::vector<BandsRegion::Region>();
+  stage_ = 0;
+  conflict_none_set_ = IntervalSet();
+  deadline_ = NULL;
+  interrupted_ = false;
   min_ = min;
   max_ = max;
   rel_ = false;
@@ -69,9 +91,16 @@ KinematicRealBands::KinematicRealBands(const KinematicRealBands& b) {
   outdated_ = true;
   checked_ = -1;
   peripheral_acs_ = std::vector< std::vector<TrafficState> >();
+  peripheral_outdated_ = std::vector<bool>();
   ranges_ = std::vector<BandsRange>();
   recovery_time_ = NaN;
   resolutions_ = std::vector<Interval>();
+  none_sets_ = std::vector<IntervalSet>();
+  regions_ = std::vector<BandsRegion::Region>();
+  stage_ = 0;
+  conflict_none_set_ = IntervalSet();
+  deadline_ = NULL;
+  interrupted_ = false;
   min_ = b.min_;
   max_ = b.max_;
   rel_ = b.rel_;
@@ -221,7 +250,8 @@ bool KinematicRealBands::check_input(const KinematicBandsCore& core) {
 }
 
 bool KinematicRealBands::kinematic_conflict(KinematicBandsCore& core, const TrafficState& ac,
-    Detection3D* detector, double alerting_time) {
+    const Detection3D* detector, double alerting_time) {
+  stats_ = &core.stats;
   std::vector<TrafficState> alerting_set = std::vector<TrafficState>();
   alerting_set.push_back(ac);
   return check_input(core) &&
@@ -264,33 +294,89 @@ bool KinematicRealBands::rollover() {
  */
 int KinematicRealBands::rangeOf(KinematicBandsCore& core, double val) {
   if (check_input(core)) {
-    val = mod_val(val);
-    int last_index = length(core)-1;
+    update(core);
+    return range_index(core,mod_val(val),rollover());
+  }
+  return -1;
+}
+
+/**
+ * Set indices[i] to rangeOf(core,vals[i]) for every value in vals.
+ */
+void KinematicRealBands::rangesOf(KinematicBandsCore& core, const std::vector<double>& vals, std::vector<int>& indices) {
+  indices.assign(vals.size(),-1);
+  if (check_input(core)) {
+    update(core);
     bool rov = rollover();
-    for (int i=0; i <= last_index; ++i) {
-      bool none = BandsRegion::isResolutionBand(ranges_[i].region);
-      int order_i = BandsRegion::order(ranges_[i].region);
-      bool lb_close = none ||
-          (i > 0 && order_i <= BandsRegion::order(ranges_[i-1].region)) ||
-          (i == 0 && rov && order_i <= BandsRegion::order(ranges_[last_index].region));
-      bool ub_close = none ||
-          (i < last_index && order_i <= BandsRegion::order(ranges_[i+1].region)) ||
-          (i == last_index && rov && order_i <= BandsRegion::order(ranges_[0].region));
-      if (ranges_[i].interval.almost_in(val,lb_close,ub_close,ALMOST_)) {
-        return i;
-      }
+    for (std::vector<double>::size_type i=0; i < vals.size(); ++i) {
+      indices[i] = range_index(core,mod_val(vals[i]),rov);
     }
-    if (rov) {
-      if (Util::almost_equals(val,0,ALMOST_)) {
-        return 0;
-      }
+  }
+}
+
+/**
+ * Set regions[i] to region(core,rangeOf(core,vals[i])) for every value in vals.
+ */
+void KinematicRealBands::regionsOf(KinematicBandsCore& core, const std::vector<double>& vals,
+    std::vector<BandsRegion::Region>& regions) {
+  std::vector<int> indices;
+  rangesOf(core,vals,indices);
+  regions.resize(vals.size());
+  for (std::vector<double>::size_type i=0; i < vals.size(); ++i) {
+    regions[i] = indices[i] < 0 ? BandsRegion::UNKNOWN : ranges_[indices[i]].region;
+  }
+}
+
+/**
+ * Return index of the first range that contains val, or -1 if there is no such range.
+ * Ranges are sorted, so only the ranges whose bounds are almost equal to val, or
+ * contain val, are checked. They are found by binary search.
+ * Requires: check_input(core), ranges_ are up to date, val = mod_val(val), and rov = rollover()
+ */
+int KinematicRealBands::range_index(KinematicBandsCore& core, double val, bool rov) const {
+  int last_index = ranges_.size()-1;
+  // First range whose upper bound is not below val
+  int lo = 0;
+  int hi = last_index+1;
+  while (lo < hi) {
+    int mid = (lo+hi)/2;
+    if (ranges_[mid].interval.up < val) {
+      lo = mid+1;
     } else {
-      if (Util::almost_equals(val,min_val(core.ownship),ALMOST_)) {
-        return 0;
-      }
-      if (Util::almost_equals(val,max_val(core.ownship),ALMOST_)) {
-        return last_index;
-      }
+      hi = mid;
+    }
+  }
+  // Ranges that end just below val may also contain it
+  while (lo > 0 && Util::almost_equals(ranges_[lo-1].interval.up,val,ALMOST_)) {
+    --lo;
+  }
+  for (int i=lo; i <= last_index; ++i) {
+    if (val < ranges_[i].interval.low && !Util::almost_equals(ranges_[i].interval.low,val,ALMOST_)) {
+      // This range, and the ones after it, start above val
+      break;
+    }
+    bool none = BandsRegion::isResolutionBand(ranges_[i].region);
+    int order_i = BandsRegion::order(ranges_[i].region);
+    bool lb_close = none ||
+        (i > 0 && order_i <= BandsRegion::order(ranges_[i-1].region)) ||
+        (i == 0 && rov && order_i <= BandsRegion::order(ranges_[last_index].region));
+    bool ub_close = none ||
+        (i < last_index && order_i <= BandsRegion::order(ranges_[i+1].region)) ||
+        (i == last_index && rov && order_i <= BandsRegion::order(ranges_[0].region));
+    if (ranges_[i].interval.almost_in(val,lb_close,ub_close,ALMOST_)) {
+      return i;
+    }
+  }
+  if (rov) {
+    if (Util::almost_equals(val,0,ALMOST_)) {
+      return 0;
+    }
+  } else {
+    if (Util::almost_equals(val,min_val(core.ownship),ALMOST_)) {
+      return 0;
+    }
+    if (Util::almost_equals(val,max_val(core.ownship),ALMOST_)) {
+      return last_index;
     }
   }
   return -1;
@@ -302,9 +388,14 @@ int KinematicRealBands::rangeOf(KinematicBandsCore& core, double val) {
 void KinematicRealBands::reset() {
   outdated_ = true;
   checked_ = -1;
+  peripheral_outdated_.assign(peripheral_outdated_.size(),true);
   ranges_.clear();
   recovery_time_ = NaN;
   resolutions_.clear();
+  none_sets_.clear();
+  regions_.clear();
+  stage_ = 0;
+  conflict_none_set_.clear();
 }
 
 /**
@@ -312,23 +403,94 @@ void KinematicRealBands::reset() {
  */
 void KinematicRealBands::update(KinematicBandsCore& core) {
   if (outdated_) {
-    for (int alert_level=1; alert_level <= core.parameters.alertor.mostSevereAlertLevel(); ++alert_level) {
-      if (alert_level-1 >= (int) peripheral_acs_.size()) {
-        peripheral_acs_.push_back(std::vector<TrafficState>());
-      } else {
-        peripheral_acs_[alert_level-1].clear();
-      }
-      if (BandsRegion::isConflictBand(core.parameters.alertor.getLevel(alert_level).getRegion())) {
-        peripheral_aircraft(core,alert_level);
-      }
-    }
+    stats_ = &core.stats;
     if (check_input(core)) {
-      compute(core);
+      compute_levels(core,core.parameters.alertor.mostSevereAlertLevel());
+      color_bands(none_sets_,regions_,core,!ISNAN(recovery_time_));
     }
+    stage_ = FINAL_STAGE;
     outdated_ = false;
   }
 }
 
+/**
+ * Compute bands up to the given stage of the anytime computation, unless that stage is already completed.
+ * Return true if the stage is completed.
+ */
+bool KinematicRealBands::compute_stage(KinematicBandsCore& core, int stage, const BandsDeadline& deadline) {
+  if (stage_ >= stage) {
+    return true;
+  }
+  stats_ = &core.stats;
+  if (!check_input(core)) {
+    stage_ = FINAL_STAGE;
+    outdated_ = false;
+    return true;
+  }
+  int conflict_level = core.parameters.alertor.conflictAlertLevel();
+  bool conflict_band = 1 <= conflict_level && conflict_level <= core.parameters.alertor.mostSevereAlertLevel() &&
+      BandsRegion::isConflictBand(core.parameters.alertor.getLevel(conflict_level).getRegion());
+  if (stage_ < COARSE_STAGE && conflict_band) {
+    IntervalSet noneset = IntervalSet();
+    // Peripheral aircraft found at the coarse step aren't cached, since they may differ from the
+    // ones found at the step
+    bool peripheral_outdated = conflict_level > (int)peripheral_outdated_.size() ||
+        peripheral_outdated_[conflict_level-1];
+    double step = step_;
+    step_ = COARSE_FACTOR*step;
+    level_none_set(noneset,core,conflict_level);
+    step_ = step;
+    if (peripheral_outdated) {
+      peripheral_outdated_[conflict_level-1] = true;
+    }
+    color_conflict_level(noneset,core);
+    outdated_ = false;
+  }
+  stage_ = Util::max(stage_,(int)COARSE_STAGE);
+  if (stage == COARSE_STAGE) {
+    return true;
+  }
+  if (stage_ < CONFLICT_STAGE && conflict_band) {
+    level_none_set(conflict_none_set_,core,conflict_level);
+    color_conflict_level(conflict_none_set_,core);
+  }
+  stage_ = Util::max(stage_,(int)CONFLICT_STAGE);
+  if (stage == CONFLICT_STAGE) {
+    return true;
+  }
+  deadline_ = &deadline;
+  compute_levels(core,core.parameters.alertor.mostSevereAlertLevel());
+  deadline_ = NULL;
+  if (interrupted_) {
+    return false;
+  }
+  color_bands(none_sets_,regions_,core,!ISNAN(recovery_time_));
+  stage_ = FINAL_STAGE;
+  outdated_ = false;
+  return true;
+}
+
+bool KinematicRealBands::is_final() const {
+  return !outdated_ && stage_ == FINAL_STAGE;
+}
+
+bool KinematicRealBands::interrupt() {
+  if (deadline_ != NULL && !interrupted_ && deadline_->expired()) {
+    interrupted_ = true;
+  }
+  return interrupted_;
+}
+
+/**
+ * Put in ranges_ the bands of conflict alert level given by noneset. Other levels are ignored.
+ */
+void KinematicRealBands::color_conflict_level(const IntervalSet& noneset, KinematicBandsCore& core) {
+  std::vector<IntervalSet> none_sets = std::vector<IntervalSet>(1,noneset);
+  std::vector<BandsRegion::Region> regions = std::vector<BandsRegion::Region>(1,
+      core.parameters.alertor.getLevel(core.parameters.alertor.conflictAlertLevel()).getRegion());
+  color_bands(none_sets,regions,core,false);
+}
+
 /**
  *  Force computation of kinematic bands
  */
@@ -338,20 +500,37 @@ void KinematicRealBands::force_compute(KinematicBandsCore& core) {
 }
 
 /**
- * Put in peripheral_acs_ the list of aircraft predicted to be in conflict for the given alert level
+ * Put in peripheral_acs_ the list of aircraft predicted to be in conflict for the given alert level,
+ * unless it is already cached, and return that list.
  * Requires: 1 <= alert_level <= alertor.mostSevereAlertLevel()
  */
-void KinematicRealBands::peripheral_aircraft(KinematicBandsCore& core, int alert_level) {
-  Detection3D* detector = core.parameters.alertor.getLevel(alert_level).getDetectorRef();
+std::vector<TrafficState> const & KinematicRealBands::peripheral_aircraft(KinematicBandsCore& core, int alert_level) {
+  if (alert_level > (int) peripheral_acs_.size()) {
+    peripheral_acs_.resize(alert_level);
+    peripheral_outdated_.resize(alert_level,true);
+  }
+  if (!peripheral_outdated_[alert_level-1]) {
+    return peripheral_acs_[alert_level-1];
+  }
+  peripheral_outdated_[alert_level-1] = false;
+  peripheral_acs_[alert_level-1].clear();
+  if (!BandsRegion::isConflictBand(core.parameters.alertor.getLevel(alert_level).getRegion())) {
+    return peripheral_acs_[alert_level-1];
+  }
+  stats_ = &core.stats;
+  BANDS_STATS_TIMER(stats_,peripheral_time);
+  const Detection3D* detector = core.parameters.alertor.getLevel(alert_level).getDetectorRef();
   double alerting_time = Util::min(core.parameters.getLookaheadTime(),
           core.parameters.alertor.getLevel(alert_level).getAlertingTime());
   for (int i = 0; i < (int) core.traffic.size(); ++i) {
     TrafficState ac = core.traffic[i];
+    BANDS_STATS_COUNT(stats_,detector_calls,1);
     ConflictData det = detector->conflictDetection(core.ownship.get_s(),core.ownship.get_v(),ac.get_s(),ac.get_v(),0,alerting_time);
     if (!det.conflict() && kinematic_conflict(core,ac,detector,alerting_time)) {
       peripheral_acs_[alert_level-1].push_back(ac);
     }
   }
+  return peripheral_acs_[alert_level-1];
 }
 
 /**
@@ -360,12 +539,11 @@ void KinematicRealBands::peripheral_aircraft(KinematicBandsCore& core, int alert
  * conflict_level is used.
  */
 std::vector<TrafficState> const & KinematicRealBands::peripheralAircraft(KinematicBandsCore& core, int alert_level) {
-  update(core);
   if (alert_level == 0) {
     alert_level = core.parameters.alertor.conflictAlertLevel();
   }
   if (alert_level >= 1 && alert_level <= core.parameters.alertor.mostSevereAlertLevel()) {
-    return peripheral_acs_[alert_level-1];
+    return peripheral_aircraft(core,alert_level);
   }
   return TrafficState::INVALIDL;
 }
@@ -375,7 +553,10 @@ std::vector<TrafficState> const & KinematicRealBands::peripheralAircraft(Kinemat
  * when bands are saturated but no recovery within max_recovery_time.
  */
 double KinematicRealBands::timeToRecovery(KinematicBandsCore& core) {
-  update(core);
+  // Recovery bands are only computed for the conflict alert level
+  if (check_input(core)) {
+    compute_levels(core,core.parameters.alertor.conflictAlertLevel());
+  }
   return recovery_time_;
 }
 
@@ -443,9 +624,10 @@ void KinematicRealBands::color_bands(const std::vector<IntervalSet>& none_sets,
  */
 double KinematicRealBands::compute_recovery_bands(IntervalSet& noneset, KinematicBandsCore& core,
     const std::vector<TrafficState>& alerting_set) {
+  BANDS_STATS_TIMER(stats_,recovery_time);
   double recovery_time = NINFINITY;
   int recovery_level = core.parameters.alertor.conflictAlertLevel();
-  Detection3D* detector = core.parameters.alertor.getLevel(recovery_level).getDetectorRef();
+  const Detection3D* detector = core.parameters.alertor.getLevel(recovery_level).getDetectorRef();
   double T = Util::min(core.parameters.getLookaheadTime(),
       core.parameters.alertor.getLevel(recovery_level).getEarlyAlertingTime());
   TrafficState repac = core.recovery_ac();
@@ -457,6 +639,9 @@ double KinematicRealBands::compute_recovery_bands(IntervalSet& noneset, Kinemati
     cd3d = CDCylinder::mk(core.minHorizontalRecovery(),core.minVerticalRecovery());
     double factor = 1-core.parameters.getCollisionAvoidanceBandsFactor();
     while (cd3d.getHorizontalSeparation() > core.parameters.getHorizontalNMAC() || cd3d.getVerticalSeparation() > core.parameters.getVerticalNMAC()) {
+      if (interrupt()) {
+        return NaN;
+      }
       none_bands(noneset,&cd3d,NULL,repac,core.epsilonH(),core.epsilonV(),0,T,core.ownship,alerting_set);
       bool solidred = noneset.isEmpty();
       if (solidred && !core.parameters.isEnabledCollisionAvoidanceBands()) {
@@ -467,6 +652,9 @@ double KinematicRealBands::compute_recovery_bands(IntervalSet& noneset, Kinemati
         double pivot_green = T+1;
         double pivot = pivot_green-1;
         while ((pivot_green-pivot_red) > 0.5) {
+          if (interrupt()) {
+            return NaN;
+          }
           none_bands(noneset,detector,&cd3d,repac,core.epsilonH(),core.epsilonV(),pivot,T,core.ownship,alerting_set);
           solidred = noneset.isEmpty();
           if (solidred) {
@@ -501,72 +689,94 @@ double KinematicRealBands::compute_recovery_bands(IntervalSet& noneset, Kinemati
  * Compute bands for one level. Return recovery time (NaN if recover bands are not computed)
  */
 double KinematicRealBands::compute_level(IntervalSet& noneset, KinematicBandsCore& core, int alert_level) {
-  double min = min_val(core.ownship);
-  double max = max_val(core.ownship);
-  std::vector<TrafficState> alerting_set = std::vector<TrafficState>();
-  alerting_set.insert(alerting_set.end(),
-      peripheral_acs_[alert_level-1].begin(),peripheral_acs_[alert_level-1].end());
-  alerting_set.insert(alerting_set.end(),
-      core.conflictAircraft(alert_level).begin(),core.conflictAircraft(alert_level).end());
-  if (alerting_set.empty()) {
+  BANDS_STATS_TIMER(stats_,compute_level_time);
+  if (level_none_set(noneset,core,alert_level) &&
+      recovery_ && alert_level == core.parameters.alertor.conflictAlertLevel()) {
+    // Compute recovery bands
+    if (noneset.isEmpty()) {
+      std::vector<TrafficState> alerting_set = std::vector<TrafficState>();
+      const std::vector<TrafficState>& peripheral_acs = peripheral_aircraft(core,alert_level);
+      alerting_set.insert(alerting_set.end(),peripheral_acs.begin(),peripheral_acs.end());
+      alerting_set.insert(alerting_set.end(),
+          core.conflictAircraft(alert_level).begin(),core.conflictAircraft(alert_level).end());
+      return compute_recovery_bands(noneset,core,alerting_set);
+    } else if (instantaneous_bands() && core.timeIntervalOfViolation(alert_level).low == 0) {
+      return 0;
+    }
+  }
+  return NaN;
+}
+
+/**
+ * Put in noneset the none bands of given level, without recovery bands. Return false if no
+ * aircraft is considered for that level, i.e., noneset is the whole range.
+ */
+bool KinematicRealBands::level_none_set(IntervalSet& noneset, KinematicBandsCore& core, int alert_level) {
+  noneset.clear();
+  if (peripheral_aircraft(core,alert_level).empty() && core.conflictAircraft(alert_level).empty()) {
+    double min = min_val(core.ownship);
+    double max = max_val(core.ownship);
     if (mod_ == 0 || min <= max) {
       noneset.almost_add(min,max,ALMOST_);
     } else {
       noneset.almost_add(min, mod_,ALMOST_);
       noneset.almost_add(0,max,ALMOST_);
     }
+    return false;
+  }
+  if (stage_ >= CONFLICT_STAGE && alert_level == core.parameters.alertor.conflictAlertLevel()) {
+    // Already computed by the anytime computation
+    noneset = conflict_none_set_;
   } else {
     compute_none_bands(noneset,core,alert_level,core.criteria_ac());
-    if (recovery_ && alert_level == core.parameters.alertor.conflictAlertLevel()) {
-      // Compute recovery bands
-      if (noneset.isEmpty()) {
-        return compute_recovery_bands(noneset,core,alerting_set);
-      } else if (instantaneous_bands() && core.timeIntervalOfViolation(alert_level).low == 0) {
-        return 0;
-      }
-    }
   }
-  return NaN;
+  return true;
 }
 
 /**
- * Compute all bands.
+ * Compute none sets and resolutions of alert levels up to max_level that haven't been computed yet.
+ * No level is computed after recovery bands are found, resolutions of those levels are [-oo,+oo].
+ * Requires: check_input(core)
  */
-void KinematicRealBands::compute(KinematicBandsCore& core) {
-  recovery_time_ = NaN;
-  resolutions_.clear();
-  std::vector<IntervalSet> none_sets = std::vector<IntervalSet>();
-  std::vector<BandsRegion::Region> regions = std::vector<BandsRegion::Region>();
-  bool recovery = false;
-  int alert_level;
-  for (alert_level=1; alert_level <= core.parameters.alertor.mostSevereAlertLevel() && !recovery; ++alert_level) {
+void KinematicRealBands::compute_levels(KinematicBandsCore& core, int max_level) {
+  stats_ = &core.stats;
+  max_level = Util::min(max_level,core.parameters.alertor.mostSevereAlertLevel());
+  interrupted_ = false;
+  for (int alert_level = resolutions_.size()+1; alert_level <= max_level; ++alert_level) {
+    if (!ISNAN(recovery_time_)) {
+      // Add [-oo,+oo] resolutions for level > conflict_level in case of recovery bands
+      resolutions_.push_back(Interval(NINFINITY,PINFINITY));
+      continue;
+    }
     BandsRegion::Region region = core.parameters.alertor.getLevel(alert_level).getRegion();
     if (BandsRegion::isConflictBand(region)) {
+      if (interrupt()) {
+        return;
+      }
       IntervalSet noneset = IntervalSet();
       double recovery_time = compute_level(noneset,core,alert_level);
+      if (interrupted_) {
+        // Discard partial computation of this level
+        return;
+      }
       if (!ISNAN(recovery_time)) {
-        recovery = true;
         recovery_time_ = recovery_time;
         int cal = core.currentAlertLevel();
         if (cal > alert_level) {
             region = core.parameters.alertor.getLevel(cal).getRegion();
         }
       }
-      none_sets.push_back(noneset);
-      regions.push_back(region);
+      none_sets_.push_back(noneset);
+      regions_.push_back(region);
       resolutions_.push_back(find_resolution(core,noneset));
     } else {
       resolutions_.push_back(Interval(NaN,NaN));
     }
   }
-  for (;alert_level <= core.parameters.alertor.mostSevereAlertLevel();++alert_level) {
-    // Add [-oo,+oo] resolutions for level > conflict_level in case of recovery bands
-    resolutions_.push_back(Interval(NINFINITY,PINFINITY));
-  }
-  color_bands(none_sets,regions,core,recovery);
 }
 
 Interval KinematicRealBands::find_resolution(KinematicBandsCore& core, const IntervalSet& noneset) {
+  BANDS_STATS_TIMER(stats_,resolution_time);
   double l = NINFINITY;
   double u = PINFINITY;
   double val = own_val(core.ownship);
@@ -627,9 +837,11 @@ double KinematicRealBands::compute_resolution(KinematicBandsCore& core, int aler
   if (alert_level == 0) {
     alert_level = core.parameters.alertor.conflictAlertLevel();
   }
-  if (length(core) > 0 && 1 <= alert_level &&
-      alert_level <= core.parameters.alertor.mostSevereAlertLevel() &&
-      BandsRegion::isConflictBand(core.parameters.alertor.getLevel(alert_level).getRegion())) {
+  if (1 <= alert_level && alert_level <= core.parameters.alertor.mostSevereAlertLevel() &&
+      BandsRegion::isConflictBand(core.parameters.alertor.getLevel(alert_level).getRegion()) &&
+      check_input(core)) {
+    // Only levels up to alert_level are needed
+    compute_levels(core,alert_level);
     Interval resolution = resolutions_[alert_level-1];
     if (dir) {
       return resolution.up;
@@ -666,7 +878,7 @@ bool KinematicRealBands::preferred_direction(KinematicBandsCore& core, int alert
 double KinematicRealBands::last_time_to_maneuver(KinematicBandsCore& core, const TrafficState& ac) {
   if (check_input(core)) {
     int conflict_level = core.parameters.alertor.conflictAlertLevel();
-    Detection3D* detector = core.parameters.alertor.getLevel(conflict_level).getDetectorRef();
+    const Detection3D* detector = core.parameters.alertor.getLevel(conflict_level).getDetectorRef();
     double T = Util::min(core.parameters.getLookaheadTime(),
         core.parameters.alertor.getLevel(conflict_level).getEarlyAlertingTime());
     ConflictData det = detector->conflictDetection(core.ownship.get_s(),core.ownship.get_v(),ac.get_s(),ac.get_v(),0,T);
@@ -769,43 +981,58 @@ void KinematicRealBands::toIntervalSet(IntervalSet& noneset, const std::vector<I
   }
 }
 
-void KinematicRealBands::none_bands(IntervalSet& noneset, Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+void KinematicRealBands::none_bands(IntervalSet& noneset, const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
     int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic) {
+  BANDS_STATS_COUNT(stats_,none_bands_calls,1);
   std::vector<Integerval> bands_int = std::vector<Integerval>();
   if (instantaneous_bands()) {
     instantaneous_bands_combine(bands_int,conflict_det,recovery_det,B,T,0,B,
         maxdown(ownship),maxup(ownship),ownship,traffic,repac,epsh,epsv);
   } else {
+    // Turn samplers are local to this sweep
+    TurnSampler turns[2];
+    turns_ = turns;
     kinematic_bands_combine(bands_int,conflict_det,recovery_det,time_step(ownship),B,T,0,B,
         maxdown(ownship),maxup(ownship),ownship,traffic,repac,epsh,epsv);
+    turns_ = NULL;
   }
   toIntervalSet(noneset,bands_int,get_step(),own_val(ownship),min_val(ownship),max_val(ownship));
 }
 
-bool KinematicRealBands::any_red(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+bool KinematicRealBands::any_red(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
     int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic) {
-  return instantaneous_bands() ?
-      any_instantaneous_red(conflict_det,recovery_det,B,T,0,B,
-          maxdown(ownship),maxup(ownship),ownship,traffic,repac,epsh,epsv,0):
-          any_int_red(conflict_det,recovery_det,time_step(ownship),B,T,0,B,
-              maxdown(ownship),maxup(ownship),ownship,traffic,repac,epsh,epsv,0);
+  if (instantaneous_bands()) {
+    return any_instantaneous_red(conflict_det,recovery_det,B,T,0,B,
+        maxdown(ownship),maxup(ownship),ownship,traffic,repac,epsh,epsv,0);
+  }
+  TurnSampler turns[2];
+  turns_ = turns;
+  bool red = any_int_red(conflict_det,recovery_det,time_step(ownship),B,T,0,B,
+      maxdown(ownship),maxup(ownship),ownship,traffic,repac,epsh,epsv,0);
+  turns_ = NULL;
+  return red;
 }
 
-bool KinematicRealBands::all_red(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+bool KinematicRealBands::all_red(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
     int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic) {
-  return instantaneous_bands() ?
-      all_instantaneous_red(conflict_det,recovery_det,B,T,0,B,
-          maxdown(ownship),maxup(ownship),ownship,traffic,repac,epsh,epsv,0):
-          all_int_red(conflict_det,recovery_det,time_step(ownship),B,T,0,B,
-              maxdown(ownship),maxup(ownship),ownship,traffic,repac,epsh,epsv,0);
+  if (instantaneous_bands()) {
+    return all_instantaneous_red(conflict_det,recovery_det,B,T,0,B,
+        maxdown(ownship),maxup(ownship),ownship,traffic,repac,epsh,epsv,0);
+  }
+  TurnSampler turns[2];
+  turns_ = turns;
+  bool red = all_int_red(conflict_det,recovery_det,time_step(ownship),B,T,0,B,
+      maxdown(ownship),maxup(ownship),ownship,traffic,repac,epsh,epsv,0);
+  turns_ = NULL;
+  return red;
 }
 
-bool KinematicRealBands::all_green(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+bool KinematicRealBands::all_green(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
     int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic) {
   return !any_red(conflict_det,recovery_det,repac,epsh,epsv,B,T,ownship,traffic);
 }
 
-bool KinematicRealBands::any_green(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+bool KinematicRealBands::any_green(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
     int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic) {
   return !all_red(conflict_det,recovery_det,repac,epsh,epsv,B,T,ownship,traffic);
 }
@@ -816,7 +1043,7 @@ bool KinematicRealBands::any_green(Detection3D* conflict_det, Detection3D* recov
  * are no resolutions.
  * The value dir=false is down and dir=true is up.
  */
-double KinematicRealBands::resolution(Detection3D* conflict_det, Detection3D* recovery_det, const TrafficState& repac,
+double KinematicRealBands::resolution(const Detection3D* conflict_det, const Detection3D* recovery_det, const TrafficState& repac,
     int epsh, int epsv, double B, double T, const TrafficState& ownship, const std::vector<TrafficState>& traffic, bool dir) {
   int maxn;
   int sign;
@@ -827,8 +1054,11 @@ double KinematicRealBands::resolution(Detection3D* conflict_det, Detection3D* re
     maxn = maxdown(ownship);
     sign = -1;
   }
+  TurnSampler turns[2];
+  turns_ = turns;
   int ires = first_green(conflict_det,recovery_det,time_step(ownship),B,T,0,B,
       dir,maxn,ownship,traffic,repac,epsh,epsv);
+  turns_ = NULL;
   if (ires == 0) {
     return NaN;
   } else if (ires < 0) {
@@ -839,13 +1069,13 @@ double KinematicRealBands::resolution(Detection3D* conflict_det, Detection3D* re
 }
 
 void KinematicRealBands::compute_none_bands(IntervalSet& noneset, KinematicBandsCore& core, int alert_level, const TrafficState& repac) {
-  Detection3D* detector = core.parameters.alertor.getLevel(alert_level).getDetectorRef();
+  const Detection3D* detector = core.parameters.alertor.getLevel(alert_level).getDetectorRef();
   double alerting_time = Util::min(core.parameters.getLookaheadTime(),
           core.parameters.alertor.getLevel(alert_level).getAlertingTime());
   double early_time = Util::min(core.parameters.getLookaheadTime(),
           core.parameters.alertor.getLevel(alert_level).getEarlyAlertingTime());
   none_bands(noneset,detector,NULL,repac,core.epsilonH(),core.epsilonV(),0,alerting_time,
-      core.ownship,peripheral_acs_[alert_level-1]);
+      core.ownship,peripheral_aircraft(core,alert_level));
   IntervalSet noneset2 = IntervalSet();
   none_bands(noneset2,detector,NULL,repac,core.epsilonH(),core.epsilonV(),0,early_time,
       core.ownship,core.conflictAircraft(alert_level));
@@ -13,8 +13,10 @@
 #include "BandsRegion.h"
 #include "Integerval.h"
 #include "ProjectedKinematics.h"
+#include "Util.h"
 #include <cmath>
 #include "KinematicBandsParameters.h"
+#include "TurnSampler.h"
 
 namespace larcfm {
 
@@ -70,12 +72,35 @@ double KinematicTrkBands::time_step(const TrafficState& ownship) const {
   return get_step()/omega;
 }
 
-std::pair<Vect3, Velocity> KinematicTrkBands::trajectory(const TrafficState& ownship, double time, bool dir) const {
+std::pair<Vect3, Velocity> KinematicTrkBands::trajectory(const TrafficState& ownship, double time, bool dir, int j) const {
   std::pair<Position,Velocity> posvel;
   if (instantaneous_bands()) {
-    double trk = ownship.getVelocityXYZ().compassAngle()+(dir?1:-1)*j_step_*get_step();
+    double trk = ownship.getVelocityXYZ().compassAngle()+(dir?1:-1)*j*get_step();
     posvel = std::pair<Position,Velocity>(ownship.getPositionXYZ(),ownship.getVelocityXYZ().mkTrk(trk));
   } else {
+    if (turns_ != NULL && !ownship.getPositionXYZ().isLatLon()) {
+      // Sample times are multiples of time_step(ownship): use the samples of the sweep in progress
+      TurnSampler& sampler = turns_[dir ? 1 : 0];
+      Vect3 s0 = ownship.getPositionXYZ().point();
+      Velocity v0 = ownship.getVelocityXYZ();
+      double tstep = time_step(ownship);
+      if (!sampler.startsAt(s0,v0,tstep)) {
+        sampler.clear();
+        double gso = v0.gs();
+        double bank = turn_rate_ == 0 ? bank_angle_ : std::abs(Kinematics::bankAngle(gso,turn_rate_));
+        double R = Kinematics::turnRadius(ownship.get_v().gs(), bank);
+        if (!Util::almost_equals(R,0) && tstep > 0 && tstep < PINFINITY) {
+          double omega = (dir?1:-1)*v0.gs()/R;
+          if (!Util::almost_equals(omega,0)) {
+            sampler.start(s0,v0,omega,tstep);
+          }
+        }
+      }
+      std::pair<Vect3,Velocity> sv;
+      if (sampler.sample(time,sv)) {
+        return sv;
+      }
+    }
     double gso = ownship.getVelocityXYZ().gs();
     double bank = turn_rate_ == 0 ? bank_angle_ : std::abs(Kinematics::bankAngle(gso,turn_rate_));
     double R = Kinematics::turnRadius(ownship.get_v().gs(), bank);
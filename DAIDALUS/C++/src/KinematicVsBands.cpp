@@ -55,10 +55,10 @@ double KinematicVsBands::time_step(const TrafficState& ownship) const {
   return get_step()/vertical_accel_;
 }
 
-std::pair<Vect3, Velocity> KinematicVsBands::trajectory(const TrafficState& ownship, double time, bool dir) const {
+std::pair<Vect3, Velocity> KinematicVsBands::trajectory(const TrafficState& ownship, double time, bool dir, int j) const {
   std::pair<Position,Velocity> posvel;
   if (instantaneous_bands()) {
-    double vs = ownship.getVelocityXYZ().vs()+(dir?1:-1)*j_step_*get_step();
+    double vs = ownship.getVelocityXYZ().vs()+(dir?1:-1)*j*get_step();
     posvel = std::pair<Position,Velocity>(ownship.getPositionXYZ(),ownship.getVelocityXYZ().mkVs(vs));
   } else {
     posvel = ProjectedKinematics::vsAccel(ownship.getPositionXYZ(),ownship.getVelocityXYZ(),time,
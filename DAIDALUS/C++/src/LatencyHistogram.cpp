@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "LatencyHistogram.h"
+#include "format.h"
+#include "Util.h"
+#include <cmath>
+
+namespace larcfm {
+
+LatencyHistogram::LatencyHistogram() {
+  clear();
+}
+
+void LatencyHistogram::clear() {
+  for (int i = 0; i < BUCKETS; ++i) {
+    counts_[i] = 0;
+  }
+  count_ = 0;
+  sum_ = 0;
+  max_ = 0;
+}
+
+void LatencyHistogram::add(double latency) {
+  if (!(latency >= 0)) {
+    latency = 0;
+  }
+  ++counts_[bucketIndex(latency)];
+  ++count_;
+  sum_ += latency;
+  if (latency > max_) {
+    max_ = latency;
+  }
+}
+
+void LatencyHistogram::add(const LatencyHistogram& h) {
+  for (int i = 0; i < BUCKETS; ++i) {
+    counts_[i] += h.counts_[i];
+  }
+  count_ += h.count_;
+  sum_ += h.sum_;
+  if (h.max_ > max_) {
+    max_ = h.max_;
+  }
+}
+
+unsigned long LatencyHistogram::count() const {
+  return count_;
+}
+
+double LatencyHistogram::mean() const {
+  return count_ == 0 ? 0 : sum_/count_;
+}
+
+double LatencyHistogram::max() const {
+  return max_;
+}
+
+double LatencyHistogram::percentile(double p) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  double rank = std::ceil(p*count_);
+  unsigned long acc = 0;
+  for (int i = 0; i < BUCKETS-1; ++i) {
+    acc += counts_[i];
+    if (acc >= rank) {
+      return bucketBound(i) < max_ ? bucketBound(i) : max_;
+    }
+  }
+  return max_;
+}
+
+unsigned long LatencyHistogram::bucketCount(int i) const {
+  return 0 <= i && i < BUCKETS ? counts_[i] : 0;
+}
+
+double LatencyHistogram::bucketBound(int i) {
+  int k = i/SUB_BUCKETS;
+  double sub = (i%SUB_BUCKETS+1)/(double)SUB_BUCKETS;
+  return (k == 0 ? sub : std::ldexp(1.0+sub,k-1))*1e-6;
+}
+
+int LatencyHistogram::bucketIndex(double latency) {
+  double us = latency*1e6;
+  if (!(us >= 0)) {
+    return 0;
+  }
+  if (us < 1) {
+    return (int)(us*SUB_BUCKETS);
+  }
+  int k;
+  double m = std::frexp(us,&k); // us = m*2^k, with 1/2 <= m < 1, so that us is in [2^(k-1),2^k)
+  if (k >= OCTAVES) {
+    return BUCKETS-1;
+  }
+  return k*SUB_BUCKETS+Util::min((int)((2*m-1)*SUB_BUCKETS),SUB_BUCKETS-1);
+}
+
+std::string LatencyHistogram::toString() const {
+  return "count = "+Fmul(count_)+", mean = "+Fm3(mean()*1e3)+
+      " [ms], p50 <= "+Fm3(percentile(0.5)*1e3)+
+      " [ms], p90 <= "+Fm3(percentile(0.9)*1e3)+
+      " [ms], p99 <= "+Fm3(percentile(0.99)*1e3)+
+      " [ms], max = "+Fm3(max()*1e3)+" [ms]";
+}
+
+}
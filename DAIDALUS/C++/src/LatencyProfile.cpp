@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "LatencyProfile.h"
+#include "format.h"
+#include <cstdio>
+
+namespace larcfm {
+
+LatencyProfile::LatencyProfile() {}
+
+int LatencyProfile::addPhase(const std::string& name) {
+  names_.push_back(name);
+  histograms_.push_back(LatencyHistogram());
+  worst_.push_back(std::vector<Sample>());
+  return names_.size()-1;
+}
+
+int LatencyProfile::numberOfPhases() const {
+  return names_.size();
+}
+
+const std::string& LatencyProfile::getName(int i) const {
+  return names_[i];
+}
+
+void LatencyProfile::add(int i, double latency, const std::string& file, double time) {
+  histograms_[i].add(latency);
+  std::vector<Sample>& worst = worst_[i];
+  if ((int)worst.size() == WORST && latency <= worst.back().latency) {
+    return;
+  }
+  // Insert the sample in decreasing order of latency
+  int k = worst.size();
+  if (k < WORST) {
+    worst.push_back(Sample());
+  } else {
+    --k;
+  }
+  for (; k > 0 && worst[k-1].latency < latency; --k) {
+    worst[k] = worst[k-1];
+  }
+  worst[k].latency = latency;
+  worst[k].file = file;
+  worst[k].time = time;
+}
+
+const LatencyHistogram& LatencyProfile::getHistogram(int i) const {
+  return histograms_[i];
+}
+
+const std::vector<LatencyProfile::Sample>& LatencyProfile::getWorst(int i) const {
+  return worst_[i];
+}
+
+void LatencyProfile::clear() {
+  for (int i = 0; i < numberOfPhases(); ++i) {
+    histograms_[i].clear();
+    worst_[i].clear();
+  }
+}
+
+static std::string sampleString(const LatencyProfile::Sample& sample) {
+  return sample.file+" at "+Fm3(sample.time)+" [s]";
+}
+
+std::string LatencyProfile::toString() const {
+  char line[256];
+  snprintf(line,sizeof(line),"%-10s %8s %10s %10s %10s %10s %10s  %s\n","Phase","Count","Mean","p50","p99",
+      "p99.9","Max","Slowest time step (latencies in [ms])");
+  std::string s = line;
+  for (int i = 0; i < numberOfPhases(); ++i) {
+    const LatencyHistogram& h = histograms_[i];
+    snprintf(line,sizeof(line),"%-10s %8lu %10.3f %10.3f %10.3f %10.3f %10.3f",names_[i].c_str(),h.count(),
+        h.mean()*1e3,h.percentile(0.5)*1e3,h.percentile(0.99)*1e3,h.percentile(0.999)*1e3,h.max()*1e3);
+    s += line;
+    if (!worst_[i].empty()) {
+      s += "  "+sampleString(worst_[i][0]);
+    }
+    s += "\n";
+  }
+  if (numberOfPhases() > 0 && !worst_.back().empty()) {
+    s += "Slowest time steps ("+names_.back()+"):\n";
+    for (unsigned int k = 0; k < worst_.back().size(); ++k) {
+      s += "  "+Fm3(worst_.back()[k].latency*1e3)+" [ms] "+sampleString(worst_.back()[k])+"\n";
+    }
+  }
+  return s;
+}
+
+}
@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "MonteCarloBands.h"
+#include "ParallelLoop.h"
+#include "Units.h"
+#include "Util.h"
+#include "format.h"
+#include <cmath>
+#include <random>
+#include <stdint.h>
+
+namespace larcfm {
+
+StateUncertainty::StateUncertainty() :
+    s_EW_std(0), s_NS_std(0), s_EN_rho(0), sz_std(0), v_EW_std(0), v_NS_std(0), v_EN_rho(0), vz_std(0) {}
+
+StateUncertainty::StateUncertainty(double s_h_std, double sz, double v_h_std, double vz) :
+    s_EW_std(s_h_std), s_NS_std(s_h_std), s_EN_rho(0), sz_std(sz), v_EW_std(v_h_std), v_NS_std(v_h_std),
+    v_EN_rho(0), vz_std(vz) {}
+
+/* Objects and partial results of the samples evaluated by one chunk of a parallel loop */
+class MonteCarloBands::Scratch {
+public:
+  Daidalus daa;
+  KinematicMultiBands kb;
+  std::vector<int> alerts;
+  std::vector<BandsRegion::Region> regions;
+  std::vector<long> region_counts[DIMENSIONS];
+  std::vector<long> alert_counts;
+};
+
+const int MonteCarloBands::TRK;
+const int MonteCarloBands::GS;
+const int MonteCarloBands::VS;
+const int MonteCarloBands::ALT;
+const int MonteCarloBands::DIMENSIONS;
+const int MonteCarloBands::REGIONS;
+
+MonteCarloBands::MonteCarloBands() : levels_(0), samples_(0) {}
+
+MonteCarloBands::~MonteCarloBands() {
+  for (int c = 0; c < (int)scratch_.size(); ++c) {
+    delete scratch_[c];
+  }
+}
+
+void MonteCarloBands::clear() {
+  nominal_.clear();
+  uncertainty_.clear();
+}
+
+void MonteCarloBands::setOwnship(const TrafficState& ownship, const StateUncertainty& u) {
+  clear();
+  nominal_.push_back(ownship);
+  uncertainty_.push_back(u);
+}
+
+int MonteCarloBands::addTraffic(const TrafficState& ac, const StateUncertainty& u) {
+  if (nominal_.empty()) {
+    return -1;
+  }
+  nominal_.push_back(ac);
+  uncertainty_.push_back(u);
+  return nominal_.size()-1;
+}
+
+void MonteCarloBands::setNominal(const Daidalus& daa, const StateUncertainty& u) {
+  clear();
+  if (daa.lastTrafficIndex() < 0) {
+    return;
+  }
+  // Daidalus holds air velocities, while samples are given to Daidalus as ground velocities
+  const Velocity& wind = daa.getWindField();
+  const TrafficState& own = daa.getOwnshipState();
+  TrafficState ownship = TrafficState::makeOwnship(own.getId(),own.getPosition(),
+      own.getVelocity().Add(wind),daa.getCurrentTime());
+  setOwnship(ownship,u);
+  for (int ac = 1; ac <= daa.lastTrafficIndex(); ++ac) {
+    const TrafficState& intruder = daa.getAircraftState(ac);
+    addTraffic(ownship.makeIntruder(intruder.getId(),intruder.getPosition(),intruder.getVelocity().Add(wind)),u);
+  }
+}
+
+void MonteCarloBands::setUncertainty(int ac, const StateUncertainty& u) {
+  if (0 <= ac && ac < (int)uncertainty_.size()) {
+    uncertainty_[ac] = u;
+  }
+}
+
+int MonteCarloBands::lastTrafficIndex() const {
+  return nominal_.size()-1;
+}
+
+/* Set grids of values of each dimension from the configuration of prototype */
+void MonteCarloBands::grid() {
+  const KinematicBandsParameters& p = prototype.parameters;
+  double min[DIMENSIONS] = { 0, p.getMinGroundSpeed(), p.getMinVerticalSpeed(), p.getMinAltitude() };
+  double max[DIMENSIONS] = { 2*Pi, p.getMaxGroundSpeed(), p.getMaxVerticalSpeed(), p.getMaxAltitude() };
+  double step[DIMENSIONS] = { p.getTrackStep(), p.getGroundSpeedStep(), p.getVerticalSpeedStep(), p.getAltitudeStep() };
+  for (int d = 0; d < DIMENSIONS; ++d) {
+    values_[d].clear();
+    if (!(step[d] > 0) || !(max[d] >= min[d])) {
+      continue;
+    }
+    int n = (int)std::floor((max[d]-min[d])/step[d]+1e-9);
+    // Track is circular, so 2pi is the same value as 0
+    if (d != TRK) {
+      ++n;
+    }
+    for (int i = 0; i < n; ++i) {
+      values_[d].push_back(min[d]+i*step[d]);
+    }
+  }
+}
+
+/*
+ * Put in n1 and n2 two independent standard normal values drawn from gen with the Box-Muller transform.
+ * Only the raw output of gen is used, since std::normal_distribution differs between standard libraries.
+ */
+static void normal_pair(std::mt19937& gen, double& n1, double& n2) {
+  double u1 = (gen()+1.0)/4294967296.0; // (0,1]
+  double u2 = gen()/4294967296.0;       // [0,1)
+  double r = std::sqrt(-2*std::log(u1));
+  n1 = r*std::cos(2*Pi*u2);
+  n2 = r*std::sin(2*Pi*u2);
+}
+
+/*
+ * Evaluate sample k: perturb the nominal states, compute alerting and bands, and add the results to
+ * the counts of scratch.
+ */
+void MonteCarloBands::sample(Scratch& scratch, unsigned long seed, int k) const {
+  std::seed_seq seq = { (uint32_t)seed, (uint32_t)((uint64_t)seed >> 32), (uint32_t)k };
+  std::mt19937 gen(seq);
+  Daidalus& daa = scratch.daa;
+  double time = nominal_[0].getTime();
+  for (int ac = 0; ac < (int)nominal_.size(); ++ac) {
+    const StateUncertainty& u = uncertainty_[ac];
+    double e[6];
+    for (int j = 0; j < 6; j += 2) {
+      normal_pair(gen,e[j],e[j+1]);
+    }
+    double dx = u.s_EW_std*e[0];
+    double dy = u.s_NS_std*(u.s_EN_rho*e[0]+std::sqrt(Util::max(0.0,1-u.s_EN_rho*u.s_EN_rho))*e[1]);
+    double dz = u.sz_std*e[2];
+    double dvx = u.v_EW_std*e[3];
+    double dvy = u.v_NS_std*(u.v_EN_rho*e[3]+std::sqrt(Util::max(0.0,1-u.v_EN_rho*u.v_EN_rho))*e[4]);
+    double dvz = u.vz_std*e[5];
+    Position pos = nominal_[ac].getPosition();
+    if (dx != 0 || dy != 0) {
+      pos = pos.linearEst(dy,dx);
+    }
+    if (dz != 0) {
+      pos = pos.mkAlt(pos.alt()+dz);
+    }
+    const Velocity& v = nominal_[ac].getVelocity();
+    Velocity vel = Velocity::mkVxyz(v.x+dvx,v.y+dvy,v.z+dvz);
+    if (ac == 0) {
+      daa.setOwnshipState(nominal_[ac].getId(),pos,vel,time);
+    } else {
+      daa.addTrafficState(nominal_[ac].getId(),pos,vel);
+    }
+  }
+  daa.alertingAll(scratch.alerts);
+  for (int ac = 1; ac <= daa.lastTrafficIndex(); ++ac) {
+    int level = scratch.alerts[ac-1];
+    if (0 <= level && level <= levels_) {
+      ++scratch.alert_counts[(ac-1)*(levels_+1)+level];
+    }
+  }
+  KinematicMultiBands& kb = scratch.kb;
+  daa.kinematicMultiBands(kb);
+  for (int d = 0; d < DIMENSIONS; ++d) {
+    switch (d) {
+    case TRK:
+      kb.regionsOfTrack(values_[d],scratch.regions);
+      break;
+    case GS:
+      kb.regionsOfGroundSpeed(values_[d],scratch.regions);
+      break;
+    case VS:
+      kb.regionsOfVerticalSpeed(values_[d],scratch.regions);
+      break;
+    default:
+      kb.regionsOfAltitude(values_[d],scratch.regions);
+      break;
+    }
+    std::vector<long>& counts = scratch.region_counts[d];
+    for (int i = 0; i < (int)scratch.regions.size(); ++i) {
+      ++counts[i*REGIONS+(int)scratch.regions[i]];
+    }
+  }
+}
+
+/* Each iteration is a chunk of samples, evaluated with the scratch objects of the chunk */
+class MonteCarloBody : public ParallelLoop::Body {
+public:
+  const MonteCarloBands& mc;
+  unsigned long seed;
+  int samples;
+  int chunks;
+
+  MonteCarloBody(const MonteCarloBands& m, unsigned long s, int n, int c) : mc(m), seed(s), samples(n), chunks(c) {}
+
+  void run(int begin, int end) {
+    for (int c = begin; c < end; ++c) {
+      MonteCarloBands::Scratch& scratch = *mc.scratch_[c];
+      int first = (int)((long)c*samples/chunks);
+      int last = (int)((long)(c+1)*samples/chunks);
+      for (int k = first; k < last; ++k) {
+        mc.sample(scratch,seed,k);
+      }
+    }
+  }
+};
+
+void MonteCarloBands::evaluate(int samples, unsigned long seed) {
+  levels_ = prototype.parameters.alertor.mostSevereAlertLevel();
+  samples_ = Util::max(0,samples);
+  grid();
+  int traffic = Util::max(0,lastTrafficIndex());
+  alert_counts_.assign(traffic*(levels_+1),0);
+  for (int d = 0; d < DIMENSIONS; ++d) {
+    region_counts_[d].assign(values_[d].size()*REGIONS,0);
+  }
+  if (nominal_.empty() || samples_ == 0) {
+    return;
+  }
+  // A few chunks per thread balance the load, since samples take different times
+  int chunks = Util::min(samples_,ParallelLoop::concurrency() == 1 ? 1 : 4*ParallelLoop::concurrency());
+  while ((int)scratch_.size() < chunks) {
+    scratch_.push_back(new Scratch());
+  }
+  for (int c = 0; c < chunks; ++c) {
+    Scratch& scratch = *scratch_[c];
+    scratch.daa = prototype;
+    scratch.alert_counts.assign(alert_counts_.size(),0);
+    for (int d = 0; d < DIMENSIONS; ++d) {
+      scratch.region_counts[d].assign(region_counts_[d].size(),0);
+    }
+  }
+  MonteCarloBody body(*this,seed,samples_,chunks);
+  ParallelLoop::run(chunks,body);
+  for (int c = 0; c < chunks; ++c) {
+    const Scratch& scratch = *scratch_[c];
+    for (int i = 0; i < (int)alert_counts_.size(); ++i) {
+      alert_counts_[i] += scratch.alert_counts[i];
+    }
+    for (int d = 0; d < DIMENSIONS; ++d) {
+      for (int i = 0; i < (int)region_counts_[d].size(); ++i) {
+        region_counts_[d][i] += scratch.region_counts[d][i];
+      }
+    }
+  }
+}
+
+int MonteCarloBands::samples() const {
+  return samples_;
+}
+
+double MonteCarloBands::alertProbability(int ac, int alert_level) const {
+  if (samples_ == 0 || ac < 1 || ac > lastTrafficIndex() || alert_level < 0 || alert_level > levels_ ||
+      (int)alert_counts_.size() < ac*(levels_+1)) {
+    return 0;
+  }
+  return (double)alert_counts_[(ac-1)*(levels_+1)+alert_level]/samples_;
+}
+
+double MonteCarloBands::alertAtLeastProbability(int ac, int alert_level) const {
+  double p = 0;
+  for (int level = Util::max(0,alert_level); level <= levels_; ++level) {
+    p += alertProbability(ac,level);
+  }
+  return p;
+}
+
+double MonteCarloBands::probability(int dim, int i, BandsRegion::Region region) const {
+  if (samples_ == 0 || i < 0 || i >= (int)values_[dim].size() || (int)region < 0 || (int)region >= REGIONS ||
+      region_counts_[dim].size() != values_[dim].size()*REGIONS) {
+    return 0;
+  }
+  return (double)region_counts_[dim][i*REGIONS+(int)region]/samples_;
+}
+
+const std::vector<double>& MonteCarloBands::trackValues() const {
+  return values_[TRK];
+}
+
+double MonteCarloBands::trackProbability(int i, BandsRegion::Region region) const {
+  return probability(TRK,i,region);
+}
+
+const std::vector<double>& MonteCarloBands::groundSpeedValues() const {
+  return values_[GS];
+}
+
+double MonteCarloBands::groundSpeedProbability(int i, BandsRegion::Region region) const {
+  return probability(GS,i,region);
+}
+
+const std::vector<double>& MonteCarloBands::verticalSpeedValues() const {
+  return values_[VS];
+}
+
+double MonteCarloBands::verticalSpeedProbability(int i, BandsRegion::Region region) const {
+  return probability(VS,i,region);
+}
+
+const std::vector<double>& MonteCarloBands::altitudeValues() const {
+  return values_[ALT];
+}
+
+double MonteCarloBands::altitudeProbability(int i, BandsRegion::Region region) const {
+  return probability(ALT,i,region);
+}
+
+std::string MonteCarloBands::toString() const {
+  static const char* names[DIMENSIONS] = { "Track", "Ground Speed", "Vertical Speed", "Altitude" };
+  static const BandsRegion::Region regions[4] = { BandsRegion::NEAR, BandsRegion::MID, BandsRegion::FAR, BandsRegion::RECOVERY };
+  std::string units[DIMENSIONS] = { prototype.parameters.getUnits("trk_step"), prototype.parameters.getUnits("gs_step"),
+      prototype.parameters.getUnits("vs_step"), prototype.parameters.getUnits("alt_step") };
+  std::string s = "Samples: "+Fmi(samples_)+"\n";
+  for (int ac = 1; ac <= lastTrafficIndex(); ++ac) {
+    s += "Alert Levels of "+nominal_[ac].getId()+":";
+    for (int level = 0; level <= levels_; ++level) {
+      s += " "+Fmi(level)+" ("+Fm4(alertProbability(ac,level))+")";
+    }
+    s += "\n";
+  }
+  for (int d = 0; d < DIMENSIONS; ++d) {
+    s += names[d]+std::string(" Values with Conflict or Recovery Probability [")+units[d]+"]: NEAR MID FAR RECOVERY\n";
+    for (int i = 0; i < (int)values_[d].size(); ++i) {
+      double p = 0;
+      for (int r = 0; r < 4; ++r) {
+        p += probability(d,i,regions[r]);
+      }
+      if (p > 0) {
+        s += "  "+FmPrecision(Units::to(units[d],values_[d][i]));
+        for (int r = 0; r < 4; ++r) {
+          s += " "+Fm4(probability(d,i,regions[r]));
+        }
+        s += "\n";
+      }
+    }
+  }
+  return s;
+}
+
+}
@@ -15,7 +15,7 @@
 
 namespace larcfm {
 
-TrafficState NoneUrgencyStrategy::mostUrgentAircraft(Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T) {
+TrafficState NoneUrgencyStrategy::mostUrgentAircraft(const Detection3D* detector, const TrafficState& ownship, const std::vector<TrafficState>& traffic, double T) {
   return TrafficState::INVALID;
 }
 
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "ParallelLoop.h"
+#include "Util.h"
+
+#ifdef DAIDALUS_THREADS_
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace larcfm {
+
+const int ParallelLoop::MAX_THREADS;
+
+static int parallel_loop_threads = 0;
+
+#ifdef DAIDALUS_THREADS_
+// True in threads that are running a chunk of a loop
+static __thread bool parallel_loop_nested = false;
+
+/*
+ * Pool of worker threads. Workers are started when a loop needs them and are kept until the
+ * process ends. The pool runs one loop at a time: the thread that runs the loop posts it and
+ * takes chunks of it like the workers do, until all chunks are done.
+ */
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_work = PTHREAD_COND_INITIALIZER; // A loop has been posted
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER; // All chunks of the posted loop are done
+static int pool_workers = 0;
+static ParallelLoop::Body* pool_body = NULL; // Body of the posted loop, NULL if there is none
+static int pool_n = 0;
+static int pool_chunks = 0;
+static int pool_next = 0;    // Next chunk to run
+static int pool_pending = 0; // Chunks that haven't finished
+
+/* Run chunks of the posted loop until there are none left. Requires: pool_mutex is locked */
+static void pool_run_chunks() {
+  while (pool_body != NULL && pool_next < pool_chunks) {
+    ParallelLoop::Body* body = pool_body;
+    int c = pool_next++;
+    int begin = (int)((long long)pool_n*c/pool_chunks);
+    int end = (int)((long long)pool_n*(c+1)/pool_chunks);
+    pthread_mutex_unlock(&pool_mutex);
+    body->run(begin,end);
+    pthread_mutex_lock(&pool_mutex);
+    if (--pool_pending == 0) {
+      pthread_cond_broadcast(&pool_done);
+    }
+  }
+}
+
+static void* pool_worker(void* arg) {
+  (void)arg;
+  parallel_loop_nested = true;
+  pthread_mutex_lock(&pool_mutex);
+  for (;;) {
+    pool_run_chunks();
+    pthread_cond_wait(&pool_work,&pool_mutex);
+  }
+  return NULL;
+}
+#endif
+
+bool ParallelLoop::isEnabled() {
+#ifdef DAIDALUS_THREADS_
+  return true;
+#else
+  return false;
+#endif
+}
+
+int ParallelLoop::concurrency() {
+#ifdef DAIDALUS_THREADS_
+  int n = parallel_loop_threads;
+  if (n <= 0) {
+    n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  return Util::max(1,Util::min(n,MAX_THREADS));
+#else
+  return 1;
+#endif
+}
+
+void ParallelLoop::setConcurrency(int n) {
+  parallel_loop_threads = Util::max(0,Util::min(n,MAX_THREADS));
+}
+
+void ParallelLoop::run(int n, Body& body, int min_chunk) {
+  if (n <= 0) {
+    return;
+  }
+  min_chunk = Util::max(1,min_chunk);
+  int chunks = Util::min(concurrency(),(n+min_chunk-1)/min_chunk);
+  if (chunks <= 1) {
+    body.run(0,n);
+    return;
+  }
+#ifdef DAIDALUS_THREADS_
+  if (parallel_loop_nested) {
+    // Loops nested in a chunk run sequentially, the outer loop already uses the threads
+    body.run(0,n);
+    return;
+  }
+  pthread_mutex_lock(&pool_mutex);
+  if (pool_body != NULL) {
+    // The pool is running a loop of another thread
+    pthread_mutex_unlock(&pool_mutex);
+    body.run(0,n);
+    return;
+  }
+  while (pool_workers < chunks-1) {
+    pthread_t thread;
+    if (pthread_create(&thread,NULL,pool_worker,NULL) != 0) {
+      // Chunks without a worker are run by the other threads
+      break;
+    }
+    pthread_detach(thread);
+    ++pool_workers;
+  }
+  pool_body = &body;
+  pool_n = n;
+  pool_chunks = chunks;
+  pool_next = 0;
+  pool_pending = chunks;
+  pthread_cond_broadcast(&pool_work);
+  parallel_loop_nested = true;
+  pool_run_chunks();
+  while (pool_pending > 0) {
+    pthread_cond_wait(&pool_done,&pool_mutex);
+  }
+  pool_body = NULL;
+  pthread_mutex_unlock(&pool_mutex);
+  parallel_loop_nested = false;
+#endif
+}
+
+}
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "ScenarioGenerator.h"
+#include "SharedRecords.h"
+#include "Units.h"
+#include "Util.h"
+#include "format.h"
+#include "string_util.h"
+#include <cmath>
+#include <cstdio>
+
+namespace larcfm {
+
+ScenarioGenerator::ScenarioGenerator() {
+  aircraft = 100;
+  radius = Units::from("nmi",30);
+  density = 0;
+  min_alt = Units::from("ft",1000);
+  max_alt = Units::from("ft",10000);
+  layers = 0;
+  min_gs = Units::from("knot",100);
+  max_gs = Units::from("knot",250);
+  max_vs = Units::from("fpm",1000);
+  encounters = 0.1;
+  maneuvering = 0.2;
+  turn_rate = Units::from("deg/s",3);
+  duration = 60;
+  step = 1;
+  latlon = true;
+  center = LatLonAlt::make(28.5,-80.6,0);
+  seed = 0;
+}
+
+/* Uniform value in [0,1). Only the raw output of gen_ is used, so that values don't depend on the library. */
+double ScenarioGenerator::uniform() {
+  return gen_()/4294967296.0;
+}
+
+double ScenarioGenerator::uniform(double lo, double hi) {
+  return lo+(hi-lo)*uniform();
+}
+
+/* Altitude of layer k, with 0 <= k < layers */
+double ScenarioGenerator::layer(int k) const {
+  return layers > 1 ? min_alt+k*(max_alt-min_alt)/(layers-1) : min_alt;
+}
+
+/* Altitude of a traffic aircraft, on a layer if there are any */
+double ScenarioGenerator::altitude() {
+  if (layers == 0) {
+    return uniform(min_alt,max_alt);
+  }
+  return layer(Util::min((int)(uniform()*layers),layers-1));
+}
+
+void ScenarioGenerator::generate() {
+  gen_.seed((std::mt19937::result_type)seed);
+  if (density > 0) {
+    radius = std::sqrt(aircraft/(Pi*density));
+  }
+  prj_ = Projection::createProjection(center);
+  states_.clear();
+  states_.reserve(aircraft);
+  // Ownship, straight and level at the center, on the middle layer if there are any
+  InitialState own;
+  own.s = Vect3(0,0,layers > 0 ? layer((layers-1)/2) : (min_alt+max_alt)/2);
+  own.trk = uniform(0,2*Pi);
+  own.gs = uniform(min_gs,max_gs);
+  own.vs = 0;
+  own.omega = 0;
+  states_.push_back(own);
+  Vect3 own_v = Velocity::mkTrkGsVs(own.trk,own.gs,0);
+  for (int ac = 1; ac < aircraft; ++ac) {
+    InitialState st;
+    // All values are drawn for every aircraft, so that the other ones don't change with the fractions
+    bool encounter = uniform() < encounters;
+    bool turning = uniform() < maneuvering;
+    double r = radius*std::sqrt(uniform());
+    double theta = uniform(0,2*Pi);
+    st.trk = uniform(0,2*Pi);
+    st.gs = uniform(min_gs,max_gs);
+    double alt = altitude();
+    double vs = uniform(-max_vs,max_vs);
+    double tcpa = uniform(30,120);
+    double miss = uniform(0,Units::from("nmi",0.5));
+    double miss_dir = uniform(0,2*Pi);
+    double miss_alt = uniform(-Units::from("ft",300),Units::from("ft",300));
+    double dir = uniform() < 0.5 ? -1 : 1;
+    if (encounter) {
+      // Straight and level, with horizontal closest point of approach at tcpa, within miss of the
+      // ownship. It's on the layer of the ownship if there are any.
+      Vect3 v = Velocity::mkTrkGsVs(st.trk,st.gs,0);
+      Vect3 cpa = own.s.Add(own_v.Scal(tcpa)).Add(Vect3(miss*std::sin(miss_dir),miss*std::cos(miss_dir),0));
+      st.s = cpa.Sub(v.Scal(tcpa));
+      st.s.z = layers > 0 ? own.s.z : Util::max(min_alt,Util::min(own.s.z+miss_alt,max_alt));
+      st.vs = 0;
+      st.omega = 0;
+    } else {
+      st.omega = turning ? dir*turn_rate : 0;
+      st.s = Vect3(r*std::sin(theta),r*std::cos(theta),alt);
+      st.vs = layers > 0 ? 0 : vs;
+    }
+    states_.push_back(st);
+  }
+}
+
+int ScenarioGenerator::numberOfFrames() const {
+  return step > 0 ? (int)std::floor(duration/step+1e-9)+1 : 1;
+}
+
+double ScenarioGenerator::frameTime(int f) const {
+  return f*step;
+}
+
+std::string ScenarioGenerator::getId(int ac) const {
+  return "AC"+Fmi(ac);
+}
+
+void ScenarioGenerator::state(int ac, double t, Position& pos, Velocity& vel) const {
+  const InitialState& st = states_[ac];
+  double trk = st.trk+st.omega*t;
+  // Climbing and descending aircraft level off at the bounds of the altitude range
+  double z = st.s.z+st.vs*t;
+  double vs = st.vs;
+  if (z < min_alt || z > max_alt) {
+    z = Util::max(min_alt,Util::min(z,max_alt));
+    vs = 0;
+  }
+  Vect3 s;
+  if (st.omega == 0) {
+    s = Vect3(st.s.x+st.gs*std::sin(trk)*t,st.s.y+st.gs*std::cos(trk)*t,z);
+  } else {
+    double r = st.gs/st.omega;
+    s = Vect3(st.s.x+r*(std::cos(st.trk)-std::cos(trk)),st.s.y+r*(std::sin(trk)-std::sin(st.trk)),z);
+  }
+  vel = Velocity::mkTrkGsVs(trk,st.gs,vs);
+  if (latlon) {
+    pos = Position(prj_.inverse(s));
+    vel = prj_.inverseVelocity(s,vel,true);
+  } else {
+    pos = Position(s);
+  }
+}
+
+bool ScenarioGenerator::writeDaa(const std::string& filename) const {
+  FILE* file = filename == "-" ? stdout : fopen(filename.c_str(),"w");
+  if (file == NULL) {
+    return false;
+  }
+  if (latlon) {
+    fprintf(file,"NAME, lat, lon, alt, trk, gs, vs, time\n");
+    fprintf(file,"unitless, [deg], [deg], [ft], [deg], [kn], [fpm], [s]\n");
+  } else {
+    fprintf(file,"NAME, sx, sy, sz, trk, gs, vs, time\n");
+    fprintf(file,"unitless, [nmi], [nmi], [ft], [deg], [kn], [fpm], [s]\n");
+  }
+  Position pos;
+  Velocity vel;
+  for (int f = 0; f < numberOfFrames(); ++f) {
+    double t = frameTime(f);
+    for (int ac = 0; ac < (int)states_.size(); ++ac) {
+      state(ac,t,pos,vel);
+      if (latlon) {
+        fprintf(file,"%s, %.8f, %.8f, %.4f, ",getId(ac).c_str(),
+            Units::to("deg",pos.lat()),Units::to("deg",pos.lon()),Units::to("ft",pos.alt()));
+      } else {
+        fprintf(file,"%s, %.8f, %.8f, %.4f, ",getId(ac).c_str(),
+            Units::to("nmi",pos.x()),Units::to("nmi",pos.y()),Units::to("ft",pos.alt()));
+      }
+      fprintf(file,"%.6f, %.6f, %.6f, %.3f\n",Units::to("deg",vel.compassAngle()),
+          Units::to("knot",vel.gs()),Units::to("fpm",vel.vs()),t);
+    }
+  }
+  bool ok = !ferror(file);
+  if (file != stdout) {
+    ok = fclose(file) == 0 && ok;
+  }
+  return ok;
+}
+
+bool ScenarioGenerator::writeBinary(const std::string& filename) const {
+  FILE* file = filename == "-" ? stdout : fopen(filename.c_str(),"wb");
+  if (file == NULL) {
+    return false;
+  }
+  std::vector<TrafficRecord> frame(states_.size());
+  Position pos;
+  Velocity vel;
+  bool ok = true;
+  for (int f = 0; f < numberOfFrames() && ok; ++f) {
+    double t = frameTime(f);
+    for (int ac = 0; ac < (int)states_.size(); ++ac) {
+      state(ac,t,pos,vel);
+      uint32_t flags = ac == 0 ? TrafficRecord::OWNSHIP : 0;
+      if (ac+1 == (int)states_.size()) {
+        flags |= TrafficRecord::END_OF_FRAME;
+      }
+      frame[ac].set(getId(ac),pos,vel,t,flags);
+    }
+    ok = frame.empty() || fwrite(&frame[0],sizeof(TrafficRecord),frame.size(),file) == frame.size();
+  }
+  TrafficRecord end;
+  end.set("",Position::INVALID(),Velocity::INVALIDV(),0,TrafficRecord::END_OF_STREAM);
+  ok = ok && fwrite(&end,sizeof(TrafficRecord),1,file) == 1;
+  if (file != stdout) {
+    ok = fclose(file) == 0 && ok;
+  }
+  return ok;
+}
+
+int ScenarioGenerator::processOptions(const char* args[], int n, int i) {
+  std::string arg = args[i];
+  if (startsWith(arg,"--")) {
+    arg = arg.substr(1);
+  }
+  if (arg == "-latlon") {
+    latlon = true;
+    return 1;
+  }
+  if (arg == "-euclidean") {
+    latlon = false;
+    return 1;
+  }
+  if (i+1 >= n) {
+    return 0;
+  }
+  std::string val = args[i+1];
+  if (arg == "-aircraft") {
+    aircraft = Util::max(1,atoi(val.c_str()));
+  } else if (arg == "-radius") {
+    radius = Units::parse("nmi",val,radius);
+    density = 0;
+  } else if (arg == "-density") {
+    density = Util::parse_double(val)/(Units::from("nmi",1)*Units::from("nmi",1));
+  } else if (arg == "-min_alt") {
+    min_alt = Units::parse("ft",val,min_alt);
+  } else if (arg == "-max_alt") {
+    max_alt = Units::parse("ft",val,max_alt);
+  } else if (arg == "-layers") {
+    layers = Util::max(0,atoi(val.c_str()));
+  } else if (arg == "-min_gs") {
+    min_gs = Units::parse("knot",val,min_gs);
+  } else if (arg == "-max_gs") {
+    max_gs = Units::parse("knot",val,max_gs);
+  } else if (arg == "-max_vs") {
+    max_vs = Units::parse("fpm",val,max_vs);
+  } else if (arg == "-encounters") {
+    encounters = Util::parse_double(val);
+  } else if (arg == "-maneuvering") {
+    maneuvering = Util::parse_double(val);
+  } else if (arg == "-turn_rate") {
+    turn_rate = Units::parse("deg/s",val,turn_rate);
+  } else if (arg == "-duration") {
+    duration = Units::parse("s",val,duration);
+  } else if (arg == "-step") {
+    step = Units::parse("s",val,step);
+  } else if (arg == "-center") {
+    std::vector<std::string> latlonstr = split(val,",");
+    if (latlonstr.size() != 2) {
+      return 0;
+    }
+    center = LatLonAlt::make(Util::parse_double(latlonstr[0]),Util::parse_double(latlonstr[1]),0);
+  } else if (arg == "-seed") {
+    seed = strtoul(val.c_str(),NULL,10);
+  } else {
+    return 0;
+  }
+  return 2;
+}
+
+std::string ScenarioGenerator::getHelpString() {
+  std::string s = "";
+  s += "  --aircraft <n>\n\tNumber of aircraft, including the ownship (default 100)\n";
+  s += "  --radius <d>\n\tRadius of the airspace around the ownship (default 30[nmi])\n";
+  s += "  --density <d>\n\tAircraft per square nautical mile. It sets the radius from the number of aircraft\n";
+  s += "  --min_alt <alt>, --max_alt <alt>\n\tAltitude range (default 1000[ft] to 10000[ft])\n";
+  s += "  --layers <n>\n\tNumber of altitude layers, evenly spaced in the altitude range. Aircraft in layers don't\n\tclimb or descend. If 0, altitudes are random (default 0)\n";
+  s += "  --min_gs <gs>, --max_gs <gs>\n\tGround speed range (default 100[kn] to 250[kn])\n";
+  s += "  --max_vs <vs>\n\tMaximum vertical speed of aircraft that are not in layers (default 1000[fpm])\n";
+  s += "  --encounters <f>\n\tFraction of traffic aircraft on a collision course with the ownship (default 0.1)\n";
+  s += "  --maneuvering <f>\n\tFraction of traffic aircraft, not on a collision course, that turn (default 0.2)\n";
+  s += "  --turn_rate <omega>\n\tTurn rate of maneuvering aircraft (default 3[deg/s])\n";
+  s += "  --duration <t>\n\tDuration of the scenario (default 60[s])\n";
+  s += "  --step <t>\n\tTime between frames (default 1[s])\n";
+  s += "  --latlon, --euclidean\n\tGeodetic (default) or Euclidean coordinates\n";
+  s += "  --center <lat>,<lon>\n\tInitial position of the ownship in geodetic coordinates, in degrees (default 28.5,-80.6)\n";
+  s += "  --seed <n>\n\tSeed of the random generator (default 0)\n";
+  return s;
+}
+
+std::string ScenarioGenerator::toString() const {
+  return "aircraft="+Fmi(aircraft)+
+      " radius="+Fm2(Units::to("nmi",radius))+"[nmi]"+
+      " alt=["+Fm0(Units::to("ft",min_alt))+","+Fm0(Units::to("ft",max_alt))+"][ft]"+
+      " layers="+Fmi(layers)+
+      " gs=["+Fm0(Units::to("knot",min_gs))+","+Fm0(Units::to("knot",max_gs))+"][kn]"+
+      " max_vs="+Fm0(Units::to("fpm",max_vs))+"[fpm]"+
+      " encounters="+Fm2(encounters)+
+      " maneuvering="+Fm2(maneuvering)+
+      " turn_rate="+Fm1(Units::to("deg/s",turn_rate))+"[deg/s]"+
+      " duration="+Fm1(duration)+"[s]"+
+      " step="+Fm1(step)+"[s]"+
+      (latlon ? " latlon" : " euclidean")+
+      " seed="+Fmul(seed);
+}
+
+}
@@ -22,7 +22,6 @@
 #include "format.h"
 #include <string>
 #include <vector>
-#include <set>
 #include <map>
 #include <iostream>
 #include <algorithm>
@@ -31,7 +30,6 @@
 namespace larcfm {
 using std::string;
 using std::vector;
-using std::set;
 using std::map;
 using std::pair;
 using std::cout;
@@ -41,6 +39,7 @@ using std::endl;
 	SequenceReader::SequenceReader() {
 		error = ErrorLog("SequenceReader(no file)");
 		windowSize = AircraftState::DEFAULT_BUFFER_SIZE;
+		clearTable();
 		input.setCaseSensitive(false);            // headers & parameters are lower case
 	}
 
@@ -48,6 +47,7 @@ using std::endl;
 	SequenceReader::SequenceReader(const string& filename) {
 		error = ErrorLog("SequenceReader("+filename+")");
 		windowSize = AircraftState::DEFAULT_BUFFER_SIZE;
+		clearTable();
 	    std::ifstream in;
 
 	    in.open(filename.c_str());
@@ -65,7 +65,7 @@ using std::endl;
 	    in.open(filename.c_str());
 	    if ( in.fail() ) {
 	      error.addError("File "+filename+" read protected or not found");
-	      sequenceTable.clear();
+	      clearTable();
 	      return;
 	    }
 	    error = ErrorLog("SequenceReader("+filename+")");
@@ -85,10 +85,11 @@ using std::endl;
 		hasRead = false;
 		clock = true;
 		//interpretUnits = false;
-		sequenceTable.clear();
+		clearTable();
 		states.clear();
 		nameIndex.clear();
 		names.clear();
+		vector<LoadedRecord> loaded; // entries in the order of the file, sorted by buildTable
 		string lastName = ""; // the current aircraft name
 		//double lastTime = -1000000; // time must be increasing
 		int stateIndex = -1;
@@ -148,13 +149,13 @@ using std::endl;
 				thisName = lastName;
 			} else if ((equals(thisName,"\"") && equals(lastName,"")) || equals(thisName,"")) {
 				error.addError("Cannot find first aircraft");
-				sequenceTable.clear();
+				loaded.clear();
 				break;
 			} else {
 				if (names.find(thisName) == names.end()) {
 					lastName = thisName;
+					names[thisName] = nameIndex.size();
 					nameIndex.push_back(thisName);
-					names.insert(thisName);
 					stateIndex++;
 				}
 			}
@@ -167,15 +168,9 @@ using std::endl;
 	        tm = parseClockTime(input.getColumnString(head[TM_CLK]));
 	      }
 
-		  SequenceEntry sequenceEntry;
-
-		  if (sequenceTable.find(tm) != sequenceTable.end()) {
-			  sequenceEntry = sequenceTable[tm];
-		  }
-
 			if (input.hasError()) {
 				error.addError(input.getMessage());
-				sequenceTable.clear();
+				loaded.clear();
 				break;
 			}
 
@@ -204,10 +199,10 @@ using std::endl;
 
 //fpln("$#%%# "+thisName+"  "+ss.toString()+"  "+vv.toString()+"  "+Fm4(tm));
 
-	      sequenceEntry[thisName] = pair<Position,Velocity>(ss,vv);
-	      sequenceTable[tm] = sequenceEntry;
+	      loaded.push_back(LoadedRecord(tm,loaded.size(),SequenceRecord(names[thisName],ss,vv)));
 	      //lastTime = tm;
 	    }
+	    buildTable(loaded);
 	    // reset accuracy parameters to their previous values
 	    Constants::set_horizontal_accuracy(h);
 	    Constants::set_vertical_accuracy(v);
@@ -219,9 +214,73 @@ using std::endl;
 	}
 
 
+	bool SequenceReader::LoadedRecord::operator<(const LoadedRecord& r) const {
+		if (time != r.time) return time < r.time;
+		if (rec.id != r.rec.id) return rec.id < r.rec.id;
+		return order < r.order;
+	}
+
+	// Build the sequence table from the entries of a file. When an aircraft has several entries at
+	// the same time, the last one in the file is kept.
+	void SequenceReader::buildTable(vector<LoadedRecord>& loaded) {
+		clearTable();
+		sequenceStart.clear();
+		sort(loaded.begin(),loaded.end());
+		sequenceRecords.reserve(loaded.size());
+		for (unsigned int i = 0; i < loaded.size(); i++) {
+			if (i+1 < loaded.size() && loaded[i+1].time == loaded[i].time && loaded[i+1].rec.id == loaded[i].rec.id) {
+				continue; // overwritten by a later entry
+			}
+			if (sequenceTimes.empty() || sequenceTimes.back() != loaded[i].time) {
+				sequenceTimes.push_back(loaded[i].time);
+				sequenceStart.push_back(sequenceRecords.size());
+			}
+			sequenceRecords.push_back(loaded[i].rec);
+		}
+		sequenceStart.push_back(sequenceRecords.size());
+	}
+
+	void SequenceReader::clearTable() {
+		sequenceTimes.clear();
+		sequenceRecords.clear();
+		sequenceStart.assign(1,0);
+	}
+
+	// Index of time tm in sequenceTimes, or -1 if it isn't a sequence key
+	int SequenceReader::timeIndex(double tm) const {
+		vector<double>::const_iterator pos = std::lower_bound(sequenceTimes.begin(),sequenceTimes.end(),tm);
+		if (pos != sequenceTimes.end() && *pos == tm) {
+			return pos-sequenceTimes.begin();
+		}
+		return -1;
+	}
+
+	// Index in sequenceRecords of the entry for the given name and time, or -1 if there is no such entry
+	int SequenceReader::recordIndex(const string& name, double time) const {
+		int i = timeIndex(time);
+		map<string,int>::const_iterator id = names.find(name);
+		if (i < 0 || id == names.end()) {
+			return -1;
+		}
+		int lo = sequenceStart[i];
+		int hi = sequenceStart[i+1];
+		while (lo < hi) {
+			int mid = (lo+hi)/2;
+			if (sequenceRecords[mid].id < id->second) {
+				lo = mid+1;
+			} else {
+				hi = mid;
+			}
+		}
+		if (lo < sequenceStart[i+1] && sequenceRecords[lo].id == id->second) {
+			return lo;
+		}
+		return -1;
+	}
+
 	/** Return the number of sequence entries in the file */
 	int SequenceReader::sequenceSize() const {
-		return sequenceTable.size();
+		return sequenceTimes.size();
 	}
 	
 	/**
@@ -241,38 +300,59 @@ using std::endl;
 	
 	// remove any time entries with only one aircraft
 	void SequenceReader::clearSingletons() {
-		vector<double> keys = sequenceKeys();
-		for (int i = 0; i < (signed int)keys.size(); i++) {
-			if (sequenceTable[keys[i]].size() < 2) {
-//fpln("removing singleton at time "+Fm1(keys[i]));
-				sequenceTable.erase(keys[i]);
+		unsigned int k = 0; // kept times
+		int r = 0; // kept records
+		for (unsigned int i = 0; i < sequenceTimes.size(); i++) {
+			int lo = sequenceStart[i];
+			int hi = sequenceStart[i+1];
+			if (hi-lo < 2) {
+				continue;
+			}
+			sequenceTimes[k] = sequenceTimes[i];
+			sequenceStart[k] = r;
+			for (int j = lo; j < hi; j++) {
+				sequenceRecords[r++] = sequenceRecords[j];
 			}
+			k++;
 		}
+		sequenceTimes.resize(k);
+		sequenceStart.resize(k+1);
+		sequenceStart[k] = r;
+		sequenceRecords.erase(sequenceRecords.begin()+r,sequenceRecords.end());
 	}
 
 	// we need to preserve the order of the aircraft as in the input file (because the first might be the only way we know which is the ownship)
 	// so we build an vector states to us as the subset of all possible inputs
-	void SequenceReader::buildActive(double tm) {
-		vector<double> times = sequenceKeysUpTo(windowSize,tm); // Note: this includes the last entry
-		map<string, bool> included; // use to make sure there are no duplicates
+	void SequenceReader::buildActive(int i) {
+		int first = std::max(0,i+1-windowSize); // first time in the window
 		states.clear();
-		// build all AircraftStates that exist in these times
-		for (int i = 0; i < (signed int)nameIndex.size(); i++) { // work through the names in order
-			string name = nameIndex[i];
-			for (int j = 0; j < (signed int)times.size(); j++) { // for each name, work through the times in the window
-				double time = times[j];
-				SequenceEntry sequenceEntry = sequenceTable[time];
-				if (sequenceEntry.find(name) != sequenceEntry.end()) {	// name has an entry at this time
-					if (included.find(name) == included.end()) {  // name has not been added to the states list yet
-						// build a new AircraftState
-						included[name]=true;				// note name has been used
-						states.push_back(AircraftState(name)); 	// add new
-					}
-					pair<Position,Velocity> p = sequenceEntry[name];	// get entry info
-					states[states.size()-1].add(p.first, p.second, time); // we always work with the last added states entry, because they're ordered by name
-//fpln(p.first.toString()+" "+p.second.toString()+Fm4(time));
-				}
+		int lo = sequenceStart[first];
+		int hi = sequenceStart[i+1];
+		if (first == i) {
+			// entries of a single time are already in the order of the names
+			states.reserve(hi-lo);
+			for (int j = lo; j < hi; j++) {
+				states.push_back(AircraftState(nameIndex[sequenceRecords[j].id]));
+				states.back().add(sequenceRecords[j].p, sequenceRecords[j].v, sequenceTimes[i]);
 			}
+			return;
+		}
+		// entries of the window, by name and then by time
+		vector< pair<int,int> > window; // (aircraft index, record index)
+		window.reserve(hi-lo);
+		for (int j = lo; j < hi; j++) {
+			window.push_back(pair<int,int>(sequenceRecords[j].id,j));
+		}
+		sort(window.begin(),window.end());
+		int t = first;
+		for (unsigned int j = 0; j < window.size(); j++) {
+			int r = window[j].second;
+			if (j == 0 || window[j-1].first != window[j].first) {
+				states.push_back(AircraftState(nameIndex[window[j].first]));
+				t = first;
+			}
+			while (sequenceStart[t+1] <= r) t++; // records of an aircraft are visited in increasing time
+			states.back().add(sequenceRecords[r].p, sequenceRecords[r].v, sequenceTimes[t]);
 		}
 	}
 	
@@ -281,74 +361,66 @@ using std::endl;
 	 * @param tm Sequence key (time)
 	 */
 	void SequenceReader::setActive(double tm) {
-		states.clear();
-		if (sequenceTable.find(tm) != sequenceTable.end()) {
-			buildActive(tm);
+		setActiveIndex(timeIndex(tm));
+	}
+
+	void SequenceReader::setActiveIndex(int i) {
+		if (0 <= i && i < (signed int)sequenceTimes.size()) {
+			buildActive(i);
+		} else {
+			states.clear();
 		}
 	}
+
+	int SequenceReader::sequenceIndex(double tm) const {
+		return std::upper_bound(sequenceTimes.begin(),sequenceTimes.end(),tm)-sequenceTimes.begin()-1;
+	}
+
+	double SequenceReader::sequenceKey(int i) const {
+		if (0 <= i && i < (signed int)sequenceTimes.size()) {
+			return sequenceTimes[i];
+		}
+		return NaN;
+	}
 	
 	/**
 	 * Set the first entry to be the active one.
 	 */
 	void SequenceReader::setFirstActive() {
-		vector<double> keys = sequenceKeys();
-		if (keys.size() > 0)
-			buildActive(keys[0]);
-		else
-			states.clear();
+		setActiveIndex(0);
 	}
 
 	/**
 	 * Set the last entry to be the active one.
 	 */
 	void SequenceReader::setLastActive() {
-		vector<double> keys = sequenceKeys();
-		if (keys.size() > 0)
-			buildActive(keys[keys.size()-1]);
-		else
-			states.clear();
+		setActiveIndex(sequenceTimes.size()-1);
 	}
 
 	
 	/**
 	 *  Returns a sorted list of all sequence keys
 	 */
-	vector<double> SequenceReader::sequenceKeys() {
-		vector<double> arl;
-		SequenceEntryMap::iterator pos;
-		for (pos = sequenceTable.begin(); pos != sequenceTable.end(); ++pos) {
-			arl.push_back(pos->first);
-		}
-		sort(arl.begin(),arl.end());
-		return arl;
+	vector<double> SequenceReader::sequenceKeys() const {
+		return sequenceTimes;
 	}
 
 	/** a list of n > 0 sequence keys, stopping at the given time (inclusive) */ 
-	vector<double> SequenceReader::sequenceKeysUpTo(int n, double tm) {
-		vector<double> arl;
-		SequenceEntryMap::iterator pos;
-		for (pos = sequenceTable.begin(); pos != sequenceTable.end(); ++pos) {
-			if (pos->first <= tm) {
-				arl.push_back(pos->first);
-			}
-		}
-		sort(arl.begin(),arl.end());
-		// limit to window size
-		while ((signed int)arl.size() > n) {
-			arl.erase(arl.begin());
-		}
-		return arl;
+	vector<double> SequenceReader::sequenceKeysUpTo(int n, double tm) const {
+		int i = sequenceIndex(tm);
+		return vector<double>(sequenceTimes.begin()+std::max(0,i+1-n),sequenceTimes.begin()+(i+1));
 	}
 
 	/** Returns true if an entry exists for the given name and time */
-	bool SequenceReader::hasEntry(const string& name, double time) {
-		return sequenceTable.find(time) != sequenceTable.end() && sequenceTable[time].find(name) != sequenceTable[time].end();
+	bool SequenceReader::hasEntry(const string& name, double time) const {
+		return recordIndex(name,time) >= 0;
 	}
 
 	/** Returns the Position entry for a given name and time.  If no entry for this name and time, returns a zero position and sets a warning. */
 	Position SequenceReader::getSequencePosition(const string& name, double time) {
-		if (hasEntry(name,time)) {
-			return sequenceTable[time][name].first;
+		int r = recordIndex(name,time);
+		if (r >= 0) {
+			return sequenceRecords[r].p;
 		} else {
 			error.addWarning("getSequencePosition: invalid name/time combination");
 			return Position::ZERO_LL();
@@ -357,8 +429,9 @@ using std::endl;
 
 	/** Returns the Velocity entry for a given name and time.  If no entry for this name and time, returns a zero velocity and sets a warning. */
 	Velocity SequenceReader::getSequenceVelocity(const string& name, double time) {
-		if (hasEntry(name,time)) {
-			return sequenceTable[time][name].second;
+		int r = recordIndex(name,time);
+		if (r >= 0) {
+			return sequenceRecords[r].v;
 		} else {
 			error.addWarning("getSequenceVelocity: invalid name/time combination");
 			return Velocity::ZEROV();
@@ -366,32 +439,60 @@ using std::endl;
 	}
 
 	void SequenceReader::setEntry(double time, const std::string& name, const Position& p, const Velocity& v) {
-		if (sequenceTable.find(time) != sequenceTable.end()) {
-			sequenceTable[time] = SequenceEntry();
+		int r = recordIndex(name,time);
+		if (r >= 0) {
+			sequenceRecords[r].p = p;
+			sequenceRecords[r].v = v;
+			return;
+		}
+		if (names.find(name) == names.end()) {
+			names[name] = nameIndex.size();
+			nameIndex.push_back(name);
+		}
+		int id = names[name];
+		int i = std::lower_bound(sequenceTimes.begin(),sequenceTimes.end(),time)-sequenceTimes.begin();
+		if (i == (signed int)sequenceTimes.size() || sequenceTimes[i] != time) {
+			sequenceTimes.insert(sequenceTimes.begin()+i,time);
+			sequenceStart.insert(sequenceStart.begin()+i,sequenceStart[i]);
+		}
+		r = sequenceStart[i];
+		while (r < sequenceStart[i+1] && sequenceRecords[r].id < id) r++;
+		sequenceRecords.insert(sequenceRecords.begin()+r,SequenceRecord(id,p,v));
+		for (unsigned int j = i+1; j < sequenceStart.size(); j++) {
+			sequenceStart[j]++;
 		}
-		sequenceTable[time][name] = pair<Position,Velocity>(p,v);
 	}
 
 	void SequenceReader::removeAircraft(const vector<string>& alist) {
 		for (unsigned i = 0; i < alist.size(); i++) {
-			string a = alist[i];
-			vector<double> keys = sequenceKeys();
-			for (unsigned j = 0; j < keys.size(); i++) {
-				double key = keys[j];
-				if (sequenceTable[key].find(a) != sequenceTable[key].end()) {
-					sequenceTable[key].erase(a);
-				}
-			}
-			if (names.find(a) != names.end()) {
-				names.erase(a);
+			names.erase(alist[i]);
+		}
+		// renumber the remaining aircraft, keeping their order
+		vector<int> newId(nameIndex.size(),-1);
+		vector<string> newIndex;
+		for (unsigned i = 0; i < nameIndex.size(); i++) {
+			if (names.find(nameIndex[i]) != names.end()) {
+				newId[i] = newIndex.size();
+				names[nameIndex[i]] = newIndex.size();
+				newIndex.push_back(nameIndex[i]);
 			}
-			for (vector<string>::iterator pos = nameIndex.begin(); pos < nameIndex.end(); ++pos) {
-				if (equals(*pos,a)) {
-					nameIndex.erase(pos);
-					break;
+		}
+		nameIndex.swap(newIndex);
+		int r = 0; // kept records
+		for (unsigned int i = 0; i < sequenceTimes.size(); i++) {
+			int lo = sequenceStart[i];
+			int hi = sequenceStart[i+1];
+			sequenceStart[i] = r;
+			for (int j = lo; j < hi; j++) {
+				int id = newId[sequenceRecords[j].id];
+				if (id >= 0) {
+					sequenceRecords[r] = sequenceRecords[j];
+					sequenceRecords[r++].id = id;
 				}
 			}
 		}
+		sequenceStart.back() = r;
+		sequenceRecords.erase(sequenceRecords.begin()+r,sequenceRecords.end());
 		setLastActive();
 	}
 
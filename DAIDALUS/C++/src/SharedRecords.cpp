@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "SharedRecords.h"
+#include "BandsRegion.h"
+#include "Units.h"
+#include <cstring>
+#include <cstdio>
+
+namespace larcfm {
+
+const uint32_t TrafficRecord::OWNSHIP;
+const uint32_t TrafficRecord::END_OF_FRAME;
+const uint32_t TrafficRecord::END_OF_STREAM;
+const uint32_t TrafficRecord::LATLON;
+
+static void copy_id(char* dst, const std::string& src, int size) {
+  std::strncpy(dst,src.c_str(),size-1);
+  dst[size-1] = '\0';
+}
+
+bool TrafficRecord::validId(const std::string& id) {
+  return (int)id.size() < ID_SIZE;
+}
+
+bool TrafficRecord::set(const std::string& ida, const Position& pos, const Velocity& vel, double t, uint32_t f) {
+  std::memset(this,0,sizeof(TrafficRecord));
+  copy_id(id,ida,ID_SIZE);
+  flags = f;
+  time = t;
+  if (pos.isLatLon()) {
+    flags |= LATLON;
+    x = pos.lat();
+    y = pos.lon();
+  } else {
+    x = pos.x();
+    y = pos.y();
+  }
+  z = pos.alt();
+  vx = vel.x;
+  vy = vel.y;
+  vz = vel.z;
+  return validId(ida);
+}
+
+std::string TrafficRecord::getId() const {
+  return std::string(id,strnlen(id,ID_SIZE));
+}
+
+Position TrafficRecord::getPosition() const {
+  if (flags & LATLON) {
+    return Position::mkLatLonAlt(x,y,z);
+  }
+  return Position::mkXYZ(x,y,z);
+}
+
+Velocity TrafficRecord::getVelocity() const {
+  return Velocity::mkVxyz(vx,vy,vz);
+}
+
+void ResultRecord::set(Kind k, const std::string& own, const std::string& ac, int val, double t, double lo, double hi) {
+  std::memset(this,0,sizeof(ResultRecord));
+  copy_id(ownship,own,ID_SIZE);
+  copy_id(traffic,ac,ID_SIZE);
+  kind = k;
+  value = val;
+  time = t;
+  low = lo;
+  up = hi;
+}
+
+std::string ResultRecord::toString(const std::string& utrk, const std::string& ugs, const std::string& uvs, const std::string& ualt) const {
+  static const char* dims[4] = { "TRK", "GS", "VS", "ALT" };
+  const std::string* units[4] = { &utrk, &ugs, &uvs, &ualt };
+  std::string own(ownship,strnlen(ownship,ID_SIZE));
+  char buffer[256];
+  switch (kind) {
+  case ALERT:
+    snprintf(buffer,sizeof(buffer),"ALERT, %.6f, %s, %s, %d",time,own.c_str(),
+        std::string(traffic,strnlen(traffic,ID_SIZE)).c_str(),value);
+    break;
+  case TRK:
+  case GS:
+  case VS:
+  case ALT:
+    snprintf(buffer,sizeof(buffer),"%s, %.6f, %s, %.6f, %.6f, %s",dims[kind-TRK],time,own.c_str(),
+        Units::to(*units[kind-TRK],low),Units::to(*units[kind-TRK],up),
+        BandsRegion::to_string((BandsRegion::Region)value).c_str());
+    break;
+  case END:
+    snprintf(buffer,sizeof(buffer),"END, %.6f, %s, %d",time,own.c_str(),value);
+    break;
+  default:
+    snprintf(buffer,sizeof(buffer),"END_OF_STREAM");
+    break;
+  }
+  return buffer;
+}
+
+}
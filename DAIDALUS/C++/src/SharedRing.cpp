@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "SharedRing.h"
+#include "format.h"
+#include <atomic>
+#include <cerrno>
+#include <new>
+#include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace larcfm {
+
+static const uint32_t SHARED_RING_MAGIC = 0x44414152; // "DAAR"
+static const uint32_t SHARED_RING_VERSION = 1;
+
+/*
+ * Layout of the beginning of the shared memory object. Slots follow the header. The indices
+ * are in different cache lines, since each one is written by a different process.
+ */
+struct SharedRingHeader {
+  std::atomic<uint32_t> magic; // Written last by the creator
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t capacity; // Power of 2
+  char pad0[48];
+  std::atomic<uint64_t> head; // Index of next record to read. Only written by the consumer
+  char pad1[56];
+  std::atomic<uint64_t> tail; // Index of next record to write. Only written by the producer
+  char pad2[56];
+};
+
+SharedRing::SharedRing() : name_(""), owner_(false), base_(NULL), length_(0), header_(NULL), slots_(NULL),
+    error("SharedRing") {}
+
+SharedRing::~SharedRing() {
+  close();
+}
+
+bool SharedRing::map(int fd, size_t length) {
+  void* base = mmap(NULL,length,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    error.addError("Shared memory "+name_+" cannot be mapped");
+    return false;
+  }
+  base_ = base;
+  length_ = length;
+  header_ = (SharedRingHeader*)base;
+  slots_ = (char*)base+sizeof(SharedRingHeader);
+  return true;
+}
+
+bool SharedRing::create(const std::string& name, int record_size, int capacity) {
+  close();
+  if (record_size <= 0 || capacity <= 0) {
+    error.addError("Invalid record size or capacity of shared memory "+name);
+    return false;
+  }
+  uint32_t n = 1;
+  while (n < (uint32_t)capacity) {
+    n <<= 1;
+  }
+  // Records are 8-byte aligned
+  uint32_t size = (record_size+7) & ~7;
+  name_ = name;
+  int fd = shm_open(name.c_str(),O_CREAT|O_EXCL|O_RDWR,0600);
+  if (fd < 0 && errno == EEXIST) {
+    error.addError("Shared memory "+name+" already exists, it may be owned by another process");
+    return false;
+  }
+  size_t length = sizeof(SharedRingHeader)+(size_t)n*size;
+  if (fd < 0 || ftruncate(fd,length) < 0) {
+    if (fd >= 0) {
+      ::close(fd);
+      shm_unlink(name.c_str());
+    }
+    error.addError("Shared memory "+name+" cannot be created");
+    return false;
+  }
+  if (!map(fd,length)) {
+    shm_unlink(name.c_str());
+    return false;
+  }
+  owner_ = true;
+  new (&header_->magic) std::atomic<uint32_t>(0);
+  new (&header_->head) std::atomic<uint64_t>(0);
+  new (&header_->tail) std::atomic<uint64_t>(0);
+  header_->record_size = size;
+  header_->capacity = n;
+  header_->version = SHARED_RING_VERSION;
+  // Magic number is written last: the ring is ready
+  header_->magic.store(SHARED_RING_MAGIC,std::memory_order_release);
+  return true;
+}
+
+bool SharedRing::remove(const std::string& name) {
+  return shm_unlink(name.c_str()) == 0;
+}
+
+bool SharedRing::open(const std::string& name, int record_size) {
+  close();
+  name_ = name;
+  int fd = shm_open(name.c_str(),O_RDWR,0600);
+  struct stat st;
+  if (fd < 0 || fstat(fd,&st) < 0 || (size_t)st.st_size < sizeof(SharedRingHeader)) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    error.addError("Shared memory "+name+" cannot be opened");
+    return false;
+  }
+  if (!map(fd,st.st_size)) {
+    return false;
+  }
+  if (header_->magic.load(std::memory_order_acquire) != SHARED_RING_MAGIC || header_->version != SHARED_RING_VERSION ||
+      sizeof(SharedRingHeader)+(size_t)header_->capacity*header_->record_size > length_ ||
+      (record_size > 0 && (int)header_->record_size != ((record_size+7) & ~7))) {
+    error.addError("Shared memory "+name+" is not a ring of the expected records");
+    close();
+    return false;
+  }
+  return true;
+}
+
+void SharedRing::close() {
+  if (base_ != NULL) {
+    munmap(base_,length_);
+    if (owner_) {
+      shm_unlink(name_.c_str());
+    }
+  }
+  owner_ = false;
+  base_ = NULL;
+  length_ = 0;
+  header_ = NULL;
+  slots_ = NULL;
+}
+
+bool SharedRing::isOpen() const {
+  return base_ != NULL;
+}
+
+int SharedRing::recordSize() const {
+  return header_ != NULL ? (int)header_->record_size : 0;
+}
+
+int SharedRing::capacity() const {
+  return header_ != NULL ? (int)header_->capacity : 0;
+}
+
+int SharedRing::size() const {
+  if (header_ == NULL) {
+    return 0;
+  }
+  return (int)(header_->tail.load(std::memory_order_acquire)-header_->head.load(std::memory_order_acquire));
+}
+
+void* SharedRing::reserve() {
+  uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+  if (tail-header_->head.load(std::memory_order_acquire) == header_->capacity) {
+    return NULL;
+  }
+  return slots_+(size_t)(tail & (header_->capacity-1))*header_->record_size;
+}
+
+void SharedRing::commit() {
+  header_->tail.store(header_->tail.load(std::memory_order_relaxed)+1,std::memory_order_release);
+}
+
+const void* SharedRing::peek() const {
+  uint64_t head = header_->head.load(std::memory_order_relaxed);
+  if (head == header_->tail.load(std::memory_order_acquire)) {
+    return NULL;
+  }
+  return slots_+(size_t)(head & (header_->capacity-1))*header_->record_size;
+}
+
+void SharedRing::release() {
+  header_->head.store(header_->head.load(std::memory_order_relaxed)+1,std::memory_order_release);
+}
+
+}
@@ -169,6 +169,16 @@ namespace larcfm {
 	  return v;
   }
 
+  void SimpleNoPolarProjection::projectList(const std::vector<LatLonAlt>& lla, const std::vector<Velocity>& vel,
+      std::vector<Vect3>& s, std::vector<Velocity>& v) const {
+    s.resize(lla.size());
+    v.resize(lla.size());
+    for (std::vector<LatLonAlt>::size_type i = 0; i < lla.size(); ++i) {
+      s[i] = project(lla[i]);
+      v[i] = projectVelocity(lla[i],vel[i]);
+    }
+  }
+
   std::pair<Vect3,Velocity> SimpleNoPolarProjection::project(const Position& p, const Velocity& v) const {
    	return std::pair<Vect3,Velocity>(project(p),projectVelocity(p,v));
    }
@@ -87,6 +87,19 @@ namespace larcfm {
   }
 
   void StateReader::open(std::istream* in) {
+    setInput(in);
+    loadfile();
+  }  
+
+  void StateReader::openStream(std::istream* in) {
+    setInput(in);
+    hasRead = false;
+    clock = true;
+    interpretUnits = false;
+    states.clear();
+  }
+
+  void StateReader::setInput(std::istream* in) {
     SeparatedInput si(in);
     si.setCaseSensitive(false);            // headers & parameters are lower case
     vector<string> params = input.getParametersRef().getList();
@@ -94,8 +107,80 @@ namespace larcfm {
       si.getParametersRef().set(params[i], input.getParametersRef().getString(params[i]));
     }
     input = si;
-    loadfile();
-  }  
+  }
+
+  bool StateReader::readState(string& name, Position& pos, Velocity& vel, double& time) {
+    if (input.readLine()) {
+      return false;
+    }
+    if ( ! hasRead) {
+      findHeadings();
+      hasRead = true;
+    }
+    for (int i = 0; i <= VS_VZ; i++) {
+      if (head[i] < 0) {
+        error.addError("At least one required heading was missing (look for [sx|lat,sy|lon,sz|alt] [vx|trk,vy|gs,vz|vs])");
+        return false;
+      }
+    }
+    if (input.hasError()) {
+      error.addError(input.getMessage());
+      return false;
+    }
+    if (input.hasMessage()) {
+      // Warnings of the header and units lines
+      error.addWarning(input.getMessage());
+    }
+    name = input.getColumnString(head[NAME]);
+    time = head[TM_CLK] >= 0 ? parseClockTime(input.getColumnString(head[TM_CLK])) : 0.0;
+    readColumns(pos,vel);
+    if (input.hasMessage()) {
+      // Missing or malformed columns
+      error.addError(input.getMessage());
+      return false;
+    }
+    return true;
+  }
+
+  void StateReader::findHeadings() {
+    latlon = (altHeadings("lat", "lon", "long", "latitude") >= 0);
+    clock = (altHeadings("clock", "") >= 0);
+    trkgsvs = (altHeadings("trk","track") >= 0);
+
+    head[NAME] =   altHeadings("name", "aircraft", "id");
+    head[LAT_SX] = altHeadings("sx", "lat", "latitude");
+    head[LON_SY] = altHeadings("sy", "lon", "long", "longitude");
+    head[ALT_SZ] = altHeadings("sz", "alt", "altitude");
+    head[TRK_VX] = altHeadings("trk", "vx", "track");
+    head[GS_VY] = altHeadings("gs", "vy", "groundspeed", "groundspd");
+    head[VS_VZ] = altHeadings("vs", "vz", "verticalspeed", "hdot");
+    head[TM_CLK] = altHeadings("clock", "time", "tm", "st");
+  }
+
+  void StateReader::readColumns(Position& ss, Velocity& vv) const {
+    if (latlon) {
+      ss = Position(LatLonAlt::mk(input.getColumn(head[LAT_SX], "deg"),
+          input.getColumn(head[LON_SY], "deg"),
+          input.getColumn(head[ALT_SZ], "ft")));
+    } else {
+      ss = Position(Vect3(
+          input.getColumn(head[LAT_SX], "nmi"),
+          input.getColumn(head[LON_SY], "nmi"),
+          input.getColumn(head[ALT_SZ], "ft")));
+    }
+
+    if (trkgsvs) {
+      vv = Velocity::mkTrkGsVs(
+          input.getColumn(head[TRK_VX], "deg"),
+          input.getColumn(head[GS_VY], "knot"),
+          input.getColumn(head[VS_VZ], "fpm"));
+    } else {
+      vv = Velocity::mkVxyz(
+          input.getColumn(head[TRK_VX], "knot"),
+          input.getColumn(head[GS_VY], "knot"),
+          input.getColumn(head[VS_VZ], "fpm"));
+    }
+  }
   
   ParameterData& StateReader::getParametersRef() {
 	  return input.getParametersRef();
@@ -127,18 +212,7 @@ namespace larcfm {
       // look for each possible heading
       if ( ! hasRead) {
         // process heading
-        latlon = (altHeadings("lat", "lon", "long", "latitude") >= 0);
-        clock = (altHeadings("clock", "") >= 0);
-        trkgsvs = (altHeadings("trk","track") >= 0);
-        
-        head[NAME] =   altHeadings("name", "aircraft", "id");
-        head[LAT_SX] = altHeadings("sx", "lat", "latitude");
-        head[LON_SY] = altHeadings("sy", "lon", "long", "longitude");
-        head[ALT_SZ] = altHeadings("sz", "alt", "altitude");
-        head[TRK_VX] = altHeadings("trk", "vx", "track");
-        head[GS_VY] = altHeadings("gs", "vy", "groundspeed", "groundspd");
-        head[VS_VZ] = altHeadings("vs", "vz", "verticalspeed", "hdot");
-        head[TM_CLK] = altHeadings("clock", "time", "tm", "st");
+        findHeadings();
         
         // set accuracy parameters
         if (this->getParametersRef().contains("horizontalAccuracy")) {
@@ -217,28 +291,7 @@ namespace larcfm {
         break;
       }
       
-      if (latlon) {
-        ss = Position(LatLonAlt::mk(input.getColumn(head[LAT_SX], "deg"),
-        		input.getColumn(head[LON_SY], "deg"),
-        		input.getColumn(head[ALT_SZ], "ft")));
-      } else {
-        ss = Position(Vect3(
-        		input.getColumn(head[LAT_SX], "nmi"),
-        		input.getColumn(head[LON_SY], "nmi"),
-        		input.getColumn(head[ALT_SZ], "ft")));
-      }
-      
-      if (trkgsvs) {
-        vv = Velocity::mkTrkGsVs(
-        		input.getColumn(head[TRK_VX], "deg"),
-        		input.getColumn(head[GS_VY], "knot"),
-        		input.getColumn(head[VS_VZ], "fpm"));
-      } else {
-        vv = Velocity::mkVxyz(
-        		input.getColumn(head[TRK_VX], "knot"),
-        		input.getColumn(head[GS_VY], "knot"),
-        		input.getColumn(head[VS_VZ], "fpm"));
-      }
+      readColumns(ss,vv);
       states[stateIndex].add(ss, vv, tm);
       
       lastTime = tm;
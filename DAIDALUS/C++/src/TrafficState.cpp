@@ -45,6 +45,17 @@ TrafficState::TrafficState(const std::string& id, const Position& pos, const Vel
   eprj_ = eprj;
 }
 
+TrafficState::TrafficState(const std::string& id, const Position& pos, const Velocity& vel,
+    const Vect3& s, const Velocity& v, double time, const EuclideanProjection& eprj) {
+  id_ = id;
+  pos_ = pos;
+  vel_ = vel;
+  posxyz_ = Position(s);
+  velxyz_ = v;
+  time_ = time;
+  eprj_ = eprj;
+}
+
 TrafficState TrafficState::makeOwnship(const TrafficState& ac) {
   return makeOwnship(ac.id_,ac.pos_,ac.vel_,ac.time_);
 }
@@ -66,6 +77,39 @@ TrafficState TrafficState::makeIntruder(const std::string& id, const Position& p
   return TrafficState(id,pos,vel,time_,eprj_);
 }
 
+void TrafficState::makeIntruders(const std::vector<std::string>& ids, const std::vector<Position>& pos,
+    const std::vector<Velocity>& vel, std::vector<TrafficState>& traffic) const {
+  traffic.resize(ids.size());
+  if (!pos_.isLatLon()) {
+    for (nat i = 0; i < ids.size(); ++i) {
+      traffic[i] = makeIntruder(ids[i],pos[i],vel[i]);
+    }
+    return;
+  }
+  std::vector<LatLonAlt> lla;
+  std::vector<Velocity> llv;
+  lla.reserve(ids.size());
+  llv.reserve(ids.size());
+  for (nat i = 0; i < ids.size(); ++i) {
+    if (pos[i].isLatLon()) {
+      lla.push_back(pos[i].lla());
+      llv.push_back(vel[i]);
+    }
+  }
+  std::vector<Vect3> s;
+  std::vector<Velocity> v;
+  eprj_.projectList(lla,llv,s,v);
+  nat k = 0;
+  for (nat i = 0; i < ids.size(); ++i) {
+    if (pos[i].isLatLon()) {
+      traffic[i] = TrafficState(ids[i],pos[i],vel[i],s[k],v[k],time_,eprj_);
+      ++k;
+    } else {
+      traffic[i] = INVALID;
+    }
+  }
+}
+
 double TrafficState::getTime() const {
   return time_;
 }
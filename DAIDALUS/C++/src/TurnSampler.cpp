@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 United States Government as represented by
+ * the National Aeronautics and Space Administration.  No copyright
+ * is claimed in the United States under Title 17, U.S.Code. All Other
+ * Rights Reserved.
+ */
+
+#include "TurnSampler.h"
+#include <cmath>
+
+namespace larcfm {
+
+TurnSampler::TurnSampler() {
+  omega_ = 0;
+  tstep_ = 0;
+  cos_ = 1;
+  sin_ = 0;
+}
+
+void TurnSampler::start(const Vect3& s0, const Velocity& v0, double omega, double tstep) {
+  s0_ = s0;
+  v0_ = v0;
+  omega_ = omega;
+  tstep_ = tstep;
+  cos_ = std::cos(omega*tstep);
+  sin_ = std::sin(omega*tstep);
+  vxy_.clear();
+  vxy_.push_back(std::pair<double,double>(v0.x,v0.y));
+}
+
+void TurnSampler::clear() {
+  tstep_ = 0;
+  vxy_.clear();
+}
+
+bool TurnSampler::isValid() const {
+  return !vxy_.empty();
+}
+
+bool TurnSampler::startsAt(const Vect3& s0, const Velocity& v0, double tstep) const {
+  return isValid() && s0_.x == s0.x && s0_.y == s0.y && s0_.z == s0.z &&
+      v0_.x == v0.x && v0_.y == v0.y && v0_.z == v0.z && tstep_ == tstep;
+}
+
+void TurnSampler::extend(int k) {
+  for (int i = (int)vxy_.size(); i <= k; ++i) {
+    if (i % ANCHOR == 0) {
+      // Closed form, as in Velocity::mkAddTrk
+      double trk = omega_*(i*tstep_);
+      double s = std::sin(trk);
+      double c = std::cos(trk);
+      vxy_.push_back(std::pair<double,double>(v0_.x*c+v0_.y*s,-v0_.x*s+v0_.y*c));
+    } else {
+      const std::pair<double,double>& v = vxy_.back();
+      vxy_.push_back(std::pair<double,double>(v.first*cos_+v.second*sin_,-v.first*sin_+v.second*cos_));
+    }
+  }
+}
+
+bool TurnSampler::sample(double time, std::pair<Vect3,Velocity>& sv) {
+  if (!isValid() || !(time >= 0)) {
+    return false;
+  }
+  double kd = std::floor(time/tstep_+0.5);
+  if (kd >= MAX_SAMPLES) {
+    return false;
+  }
+  int k = (int)kd;
+  double t = k*tstep_;
+  if (t != time) {
+    return false;
+  }
+  extend(k);
+  const std::pair<double,double>& nv = vxy_[k];
+  // Same as Kinematics::turnOmega
+  sv.first = Vect3(s0_.x+(v0_.y-nv.second)/omega_,s0_.y+(-v0_.x+nv.first)/omega_,s0_.z+v0_.z*t);
+  sv.second = Velocity::mkVxyz(nv.first,nv.second,v0_.z);
+  return true;
+}
+
+}
@@ -71,6 +71,105 @@ LossData WCV_TAUMOD::horizontal_WCV_interval(double T, const Vect2& s, const Vec
   return LossData(time_in,time_out);
 }
 
+// Horizontal terms of a relative state (s,v) that don't depend on the thresholds
+struct TaumodTerms {
+  double sqs;
+  double sdotv;
+  double sqdet;
+  TaumodTerms(const Vect2& s, const Vect2& v) :
+    sqs(s.sqv()), sdotv(s.dot(v)), sqdet(Util::sq(s.det(v))) {}
+};
+
+// Same as horizontal_WCV_interval(T,s,v) for thresholds D and TTHR, where a = v.sqv()
+static LossData taumod_interval(double D, double TTHR, double T, double a, const TaumodTerms& st) {
+  double time_in = T;
+  double time_out = 0;
+  double sqD = Util::sq(D);
+  double b = 2*st.sdotv+TTHR*a;
+  double c = st.sqs+TTHR*st.sdotv-sqD;
+  if (Util::almost_equals(a,0) && st.sqs <= sqD) {
+    time_in = 0;
+    time_out = T;
+    return LossData(time_in,time_out);
+  }
+  if (st.sqs <= sqD) {
+    time_in = 0;
+    time_out = Util::min(T,Util::root2b(a,st.sdotv,st.sqs-sqD,1));
+    return LossData(time_in,time_out);
+  }
+  double discr = Util::sq(b)-4*a*c;
+  if (st.sdotv >= 0 || discr < 0)
+    return LossData(time_in,time_out);
+  double t = (-b - std::sqrt(discr))/(2*a);
+  if (sqD*a - st.sqdet >= 0 && t <= T) {
+    time_in = Util::max(0.0,t);
+    time_out = Util::min(T,Util::root2b(a,st.sdotv,st.sqs-sqD,1));
+  }
+  return LossData(time_in,time_out);
+}
+
+void WCV_TAUMOD::conflictDetectionLevels(const std::vector<const WCV_TAUMOD*>& dets,
+    const Vect3& so, const Velocity& vo, const Vect3& si, const Velocity& vi,
+    double B, const std::vector<double>& T,
+    std::vector<ConflictData>& conflicts, std::vector<bool>& violations) {
+  conflicts.clear();
+  violations.clear();
+  Vect2 s2 = so.vect2().Sub(si.vect2());
+  Vect2 v2 = vo.vect2().Sub(vi.vect2());
+  double sz = so.z-si.z;
+  double vz = vo.z-vi.z;
+  Vect3 s = so.Sub(si);
+  Velocity v = vo.Sub(vi);
+  double a = v2.sqv();
+  // Terms of the current relative state, used for violations
+  TaumodTerms st0(s2,v2);
+  double norm0 = s2.norm();
+  double dcpa0 = Horizontal::dcpa(s2,v2);
+  // Terms of the relative state at the beginning of the last vertical interval
+  double low = NaN;
+  Vect2 step;
+  TaumodTerms st = st0;
+  for (std::vector<const WCV_TAUMOD*>::size_type k = 0; k < dets.size(); ++k) {
+    const WCV_TAUMOD* det = dets[k];
+    double D = det->table.getDTHR();
+    double Z = det->table.getZTHR();
+    double TTHR = det->table.getTTHR();
+    double TCOA = det->table.getTCOA();
+    // Violation
+    bool hwcv = norm0 <= D;
+    if (!hwcv && dcpa0 <= D) {
+      double tvar = st0.sdotv < 0 ? (Util::sq(D)-st0.sqs)/st0.sdotv : -1;
+      hwcv = 0 <= tvar && tvar <= TTHR;
+    }
+    violations.push_back(hwcv && det->wcv_vertical->vertical_WCV(Z,TCOA,sz,vz));
+    // Conflict
+    double time_in = T[k];
+    double time_out = B;
+    Interval ii = det->wcv_vertical->vertical_WCV_interval(Z,TCOA,B,T[k],sz,vz);
+    if (ii.low <= ii.up) {
+      if (!(ii.low == low)) {
+        low = ii.low;
+        step = v2.ScalAdd(low,s2);
+        st = TaumodTerms(step,v2);
+      }
+      if (Util::almost_equals(ii.low,ii.up)) {
+        if (det->horizontal_WCV(step,v2)) {
+          time_in = ii.low;
+          time_out = ii.up;
+        }
+      } else {
+        LossData ld = taumod_interval(D,TTHR,ii.up-ii.low,a,st);
+        time_in = ld.getTimeIn() + ii.low;
+        time_out = ld.getTimeOut() + ii.low;
+      }
+    }
+    LossData ret(time_in,time_out);
+    double t_tca = (ret.getTimeIn() + ret.getTimeOut())/2;
+    double dist_tca = so.linear(vo, t_tca).Sub(si.linear(vi, t_tca)).cyl_norm(D,Z);
+    conflicts.push_back(ConflictData(ret,t_tca,dist_tca,s,v));
+  }
+}
+
 Detection3D* WCV_TAUMOD::make() const {
   return new WCV_TAUMOD();
 }